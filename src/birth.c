@@ -414,6 +414,9 @@ void player_init(struct player *p)
 	if (p->inventory)
 		mem_free(p->inventory);
 
+	/* Forget any equipment bonuses computed for the old inventory */
+	calc_bonuses_invalidate();
+
 	/* Wipe the player */
 	(void)WIPE(p, struct player);
 
@@ -442,6 +445,7 @@ void player_init(struct player *p)
 		k_ptr->tried = FALSE;
 		k_ptr->aware = FALSE;
 	}
+	object_knowledge_changed();
 
 	for (i = 1; z_info && i < z_info->r_max; i++)
 	{
@@ -33,6 +33,7 @@ int borg_delay_factor;
 /* dynamic borg stuff */
 bool borg_uses_swaps;
 bool borg_uses_calcs = TRUE;
+bool borg_uses_observe;
 bool borg_worships_damage;
 bool borg_worships_speed;
 bool borg_worships_hp;
@@ -816,6 +816,7 @@ extern bool borg_worships_gold;
 extern bool borg_plays_risky;
 extern bool borg_uses_swaps;
 extern bool borg_uses_calcs;
+extern bool borg_uses_observe;
 extern bool borg_slow_optimizehome;
 extern bool borg_scums_uniques;
 extern bool borg_kills_uniques;
@@ -8852,6 +8852,277 @@ int borg_danger_aux(int y, int x, int c, int i, bool average, bool full_damage)
 }
 
 
+/*
+ * The danger map.
+ *
+ * Most of the work in borg_danger() is summing borg_danger_aux() over all
+ * of the tracked kills, and the same grids get asked about over and over
+ * by the flow, escape, caution, defence and attack code.  So we remember
+ * the summed kill danger for each grid (for "c" of one, which is what
+ * nearly every caller uses), and only recompute the grids which may have
+ * been affected by something changing.
+ *
+ * A monster more than 20 grids away contributes no danger, and a change to
+ * a grid can only affect the line of fire between a monster and a grid which
+ * are both within 20 grids of it.  So when a kill moves, dies or changes,
+ * or a known grid changes, only the grids within 20 of it are forgotten.
+ *
+ * The borg's own position only matters to bolt spells, which can't reach
+ * the borg past other monsters, so we remember which kills have a clear
+ * bolt line to the borg and forget the grids near any kill for which that
+ * changes, whether because the borg moved or something got in the way.
+ *
+ * Everything else the danger depends on (the borg's skills and the various
+ * "pretend" flags used while simulating actions) is kept in a context; if
+ * it differs from the context the map was built in, the whole map is
+ * forgotten.
+ */
+#define DANGER_MAP_RADIUS	20
+
+typedef struct borg_danger_context borg_danger_context;
+
+struct borg_danger_context
+{
+    bool stressed;
+    bool attacking;
+    bool prot_from_evil;
+    bool speed;
+    bool shield;
+    bool on_glyph;
+    bool create_door;
+    bool sleep_spell;
+    bool sleep_spell_ii;
+    bool slow_spell;
+    bool confuse_spell;
+    bool fear_mon_spell;
+    bool morgoth_position;
+    bool as_position;
+    int fighting_unique;
+    int class;
+    s32b gold;
+    int stat[6];
+    int tp_other_n;
+    int tp_other_index[255];
+};
+
+/* The danger map itself, for non-average and average danger */
+static int danger_map[2][AUTO_MAX_Y][AUTO_MAX_X];
+static u32b danger_map_when[2][AUTO_MAX_Y][AUTO_MAX_X];
+
+/* Current generation; map entries from older generations are stale */
+static u32b danger_map_stamp = 1;
+
+/* Context the map was built in */
+static borg_danger_context danger_ctx;
+static int danger_ctx_skill[BI_MAX];
+
+/* What the map was built from, to spot changes in borg_danger_map_refresh() */
+static borg_kill danger_old_kills[256];
+static borg_item danger_old_items[QUIVER_END];
+static byte danger_old_feat[AUTO_MAX_Y][AUTO_MAX_X];
+static s16b danger_old_kill[AUTO_MAX_Y][AUTO_MAX_X];
+
+/* Where the borg was, and which kills had a clear bolt line to it */
+static int danger_bolt_x = -1, danger_bolt_y = -1;
+static bool danger_bolt[256];
+
+
+/*
+ * Forget the whole danger map
+ */
+void borg_danger_map_wipe(void)
+{
+    danger_map_stamp++;
+}
+
+/*
+ * Forget the danger map within DANGER_MAP_RADIUS of a grid
+ */
+static void borg_danger_forget(int y, int x)
+{
+    int y1 = MAX(0, y - DANGER_MAP_RADIUS);
+    int y2 = MIN(AUTO_MAX_Y - 1, y + DANGER_MAP_RADIUS);
+    int x1 = MAX(0, x - DANGER_MAP_RADIUS);
+    int x2 = MIN(AUTO_MAX_X - 1, x + DANGER_MAP_RADIUS);
+    int yy, xx;
+
+    for (yy = y1; yy <= y2; yy++)
+    {
+        for (xx = x1; xx <= x2; xx++)
+        {
+            danger_map_when[0][yy][xx] = 0;
+            danger_map_when[1][yy][xx] = 0;
+        }
+    }
+}
+
+/*
+ * Forget the danger map near any kill whose bolt spells have started or
+ * stopped being able to reach the borg.  Unless `force` is set, this is
+ * only checked when the borg has moved.
+ */
+static void borg_danger_bolt_check(bool force)
+{
+    int i;
+
+    if (!force && c_x == danger_bolt_x && c_y == danger_bolt_y) return;
+
+    danger_bolt_x = c_x;
+    danger_bolt_y = c_y;
+
+    for (i = 1; i < borg_kills_nxt; i++)
+    {
+        borg_kill *kill = &borg_kills[i];
+        bool bolt;
+
+        if (!kill->r_idx) continue;
+
+        bolt = borg_projectable_pure(kill->y, kill->x, c_y, c_x);
+        if (bolt == danger_bolt[i]) continue;
+
+        danger_bolt[i] = bolt;
+        borg_danger_forget(kill->y, kill->x);
+    }
+}
+
+/*
+ * Capture the current danger context
+ */
+static void borg_danger_context_get(borg_danger_context *ctx)
+{
+    int i;
+
+    WIPE_KEY(ctx);
+
+    ctx->stressed = (time_this_panel > 1200 || borg_t > 25000);
+    ctx->attacking = borg_attacking;
+    ctx->prot_from_evil = borg_prot_from_evil;
+    ctx->speed = borg_speed;
+    ctx->shield = borg_shield;
+    ctx->on_glyph = borg_on_glyph;
+    ctx->create_door = borg_create_door;
+    ctx->sleep_spell = borg_sleep_spell;
+    ctx->sleep_spell_ii = borg_sleep_spell_ii;
+    ctx->slow_spell = borg_slow_spell;
+    ctx->confuse_spell = borg_confuse_spell;
+    ctx->fear_mon_spell = borg_fear_mon_spell;
+    ctx->morgoth_position = borg_morgoth_position;
+    ctx->as_position = borg_as_position;
+    ctx->fighting_unique = borg_fighting_unique;
+    ctx->class = borg_class;
+    ctx->gold = borg_gold;
+
+    for (i = 0; i < 6; i++) ctx->stat[i] = borg_stat[i];
+
+    ctx->tp_other_n = borg_tp_other_n;
+    for (i = 1; i <= borg_tp_other_n && i < 255; i++)
+        ctx->tp_other_index[i] = borg_tp_other_index[i];
+}
+
+/*
+ * Make sure the danger map was built in the current context, forgetting
+ * it if not.
+ */
+static void borg_danger_context_check(void)
+{
+    borg_danger_context ctx;
+
+    borg_danger_context_get(&ctx);
+
+    if (!memcmp(&ctx, &danger_ctx, sizeof(ctx)) &&
+        !memcmp(borg_skill, danger_ctx_skill, sizeof(danger_ctx_skill)))
+        return;
+
+    danger_ctx = ctx;
+    memcpy(danger_ctx_skill, borg_skill, sizeof(danger_ctx_skill));
+    borg_danger_map_wipe();
+}
+
+/*
+ * Make sure the danger map is up to date for the borg's context and
+ * position.
+ */
+static void borg_danger_map_check(void)
+{
+    borg_danger_context_check();
+    borg_danger_bolt_check(FALSE);
+}
+
+/*
+ * Bring the danger map up to date with the borg's view of the world.
+ *
+ * This is called once per "think" cycle, and forgets the parts of the map
+ * near any kill or known grid which has changed since the last call.
+ */
+void borg_danger_map_refresh(void)
+{
+    int i, y, x;
+
+    /* Changes to the inventory can change which spells are legal */
+    if (memcmp(borg_items, danger_old_items, sizeof(danger_old_items)))
+    {
+        memcpy(danger_old_items, borg_items, sizeof(danger_old_items));
+        borg_danger_map_wipe();
+    }
+
+    /* Kills which moved, died, appeared or changed */
+    for (i = 1; i < 256; i++)
+    {
+        borg_kill *kill = &borg_kills[i];
+        borg_kill *old = &danger_old_kills[i];
+
+        if (!memcmp(kill, old, sizeof(borg_kill))) continue;
+
+        if (old->r_idx) borg_danger_forget(old->y, old->x);
+        if (kill->r_idx) borg_danger_forget(kill->y, kill->x);
+
+        memcpy(old, kill, sizeof(borg_kill));
+    }
+
+    /* Known grids which changed */
+    for (y = 0; y < AUTO_MAX_Y; y++)
+    {
+        for (x = 0; x < AUTO_MAX_X; x++)
+        {
+            borg_grid *ag = &borg_grids[y][x];
+
+            if (ag->feat == danger_old_feat[y][x] &&
+                ag->kill == danger_old_kill[y][x]) continue;
+
+            borg_danger_forget(y, x);
+
+            danger_old_feat[y][x] = ag->feat;
+            danger_old_kill[y][x] = ag->kill;
+        }
+    }
+
+    /* Lines of fire to the borg which were opened or blocked */
+    borg_danger_bolt_check(TRUE);
+}
+
+/*
+ * Sum the danger to a grid from all the kills
+ */
+static int borg_danger_kills(int y, int x, int c, bool average, bool full_damage)
+{
+    int i, p = 0;
+
+    /* Examine all the monsters */
+    for (i = 1; i < borg_kills_nxt; i++)
+    {
+        borg_kill *kill = &borg_kills[i];
+
+        /* Skip dead monsters */
+        if (!kill->r_idx) continue;
+
+        /* Collect danger from monster */
+        p += borg_danger_aux(y, x, c, i, average, full_damage);
+    }
+
+    return (p);
+}
+
+
 /*
  * Hack -- Calculate the "danger" of the given grid.
  *
@@ -8875,7 +9146,7 @@ int borg_danger_aux(int y, int x, int c, int i, bool average, bool full_damage)
  */
 int borg_danger(int y, int x, int c, bool average, bool full_damage)
 {
-    int i, p=0;
+    int p=0;
 
     /* Base danger (from regional fear) but not within a vault.  Cheating the floor grid */
 	if (!(cave->info[y][x] & (CAVE_ICKY)) && borg_skill[BI_CDEPTH] <= 80)
@@ -8896,16 +9167,25 @@ int borg_danger(int y, int x, int c, bool average, bool full_damage)
 
     full_damage = TRUE;
 
-    /* Examine all the monsters */
-    for (i = 1; i < borg_kills_nxt; i++)
+    /* Use the danger map where we can */
+    if (c == 1 && y >= 0 && y < AUTO_MAX_Y && x >= 0 && x < AUTO_MAX_X)
     {
-        borg_kill *kill = &borg_kills[i];
+        int a = average ? 1 : 0;
 
-        /* Skip dead monsters */
-        if (!kill->r_idx) continue;
+        borg_danger_map_check();
 
-        /* Collect danger from monster */
-        p += borg_danger_aux(y, x, c, i, average, full_damage);
+        if (danger_map_when[a][y][x] != danger_map_stamp)
+        {
+            danger_map[a][y][x] = borg_danger_kills(y, x, c, average,
+                                                    full_damage);
+            danger_map_when[a][y][x] = danger_map_stamp;
+        }
+
+        p += danger_map[a][y][x];
+    }
+    else
+    {
+        p += borg_danger_kills(y, x, c, average, full_damage);
     }
 
     /* Return the danger */
@@ -9609,7 +9889,8 @@ char *borg_prepared(int depth)
  */
 void borg_init_4(void)
 {
-    /* Do nothing? */
+    /* Start with an empty danger map */
+    borg_danger_map_wipe();
 }
 
 
@@ -60,6 +60,12 @@ extern int borg_danger_aux(int y, int x, int c, int i, bool average, bool full_d
  */
 extern int borg_danger(int y, int x, int c, bool average, bool full_damage);
 
+/*
+ * Maintain the cached danger map used by borg_danger()
+ */
+extern void borg_danger_map_wipe(void);
+extern void borg_danger_map_refresh(void);
+
 
 /*
  * Determine if the Borg is out of "crucial" supplies.
@@ -5,6 +5,7 @@
 #include "object/tvalsval.h"
 #include "cave.h"
 #include "monster/mon-spell.h"
+#include "observe.h"
 
 #include "borg1.h"
 #include "borg2.h"
@@ -123,6 +124,11 @@ static int borg_wank_num = 0;
 
 static borg_wank *borg_wanks;
 
+/*
+ * The monsters the game says the player can see (with borg_uses_observe)
+ */
+static struct observed_monster *borg_seen;
+
 
 
 
@@ -135,13 +141,17 @@ static borg_wank *borg_wanks;
  */
 static struct object_kind *borg_guess_kind(byte a, wchar_t c,int y,int x)
 {
+    object_type *o_ptr;
+
+    /* Ask the game what the player has seen there */
+    if (borg_uses_observe) return (observe_object_at(y, x));
+
     /* ok, this is an real cheat.  he ought to use the look command
      * in order to correctly id the object.  But I am passing that up for
      * the sake of speed and accuracy
      */
 
     /* Cheat the Actual item */
-    object_type *o_ptr;
     o_ptr= object_byid(cave->o_idx[y][x]);
     return (o_ptr->kind);
 #if 0
@@ -613,6 +623,16 @@ static int borg_guess_race(byte a, wchar_t c, bool multi, int y, int x)
 #endif
 
     monster_type   *m_ptr;
+
+    /* Ask the game what the player can see there */
+    if (borg_uses_observe)
+    {
+        struct observed_monster mon;
+
+        if (!observe_monster_at(y, x, &mon)) return (0);
+        return (mon.r_idx);
+    }
+
     m_ptr= cave_monster(cave, cave->m_idx[y][x]);
 
     /* Actual monsters */
@@ -3058,6 +3078,52 @@ static void borg_forget_map(void)
     borg_forget_view();
 }
 
+
+/*
+ * Add the monsters the player can see on the current map panel to the
+ * wanks, from the game's list of visible monsters.
+ */
+static void borg_update_map_kills(void)
+{
+    int i, n;
+
+    /* Ask the game which monsters the player can see */
+    n = observe_monsters(borg_seen, z_info->m_max);
+
+    for (i = 0; i < n; i++)
+    {
+        struct observed_monster *mon = &borg_seen[i];
+
+        /* The race is 0 when the player can't tell what it is */
+        monster_race *r_ptr = &r_info[mon->r_idx];
+
+        borg_wank *wank;
+
+        /* Only look at the current map panel */
+        if (mon->y < w_y || mon->y >= w_y + SCREEN_HGT) continue;
+        if (mon->x < w_x || mon->x >= w_x + SCREEN_WID) continue;
+
+        /* Check for memory overflow */
+        if (borg_wank_num == AUTO_VIEW_MAX)
+        {
+            borg_oops("too many monsters...");
+            return;
+        }
+
+        /* Access next wank, advance */
+        wank = &borg_wanks[borg_wank_num++];
+
+        /* Save some information */
+        wank->x = mon->x;
+        wank->y = mon->y;
+        wank->t_a = r_ptr->d_attr;
+        wank->t_c = r_ptr->d_char;
+        wank->is_take = FALSE;
+        wank->is_kill = TRUE;
+    }
+}
+
+
 /*
  * Update the "map" based on visual info on the screen
  *
@@ -3155,6 +3221,7 @@ static void borg_update_map(void)
 
     borg_grid *ag;
 	grid_data g;
+    struct observed_grid og;
 
     /* Analyze the current map panel */
     for (dy = 0; dy < SCREEN_HGT; dy++)
@@ -3169,9 +3236,22 @@ static void borg_update_map(void)
             x = w_x + dx;
             y = w_y + dy;
 
+            /* Ask the game what the player knows about the grid */
+            if (borg_uses_observe)
+            {
+                observe_grid(y, x, &og);
+                g.f_idx = og.feat;
+                g.lighting = og.lighting;
+                g.is_player = og.is_player;
+                g.first_kind = og.kind;
+
+                /* Monsters come from the monster list, below */
+                g.m_idx = 0;
+            }
+
 			/* map_info returns the information the player is allowed to
 			 * know about the screen location */
-			map_info(y, x, &g);
+			else map_info(y, x, &g);
 
             /* Get the borg_grid */
             ag = &borg_grids[y][x];
@@ -3555,6 +3635,9 @@ static void borg_update_map(void)
             }
         }
     }
+
+    /* Add the monsters on the panel */
+    if (borg_uses_observe) borg_update_map_kills();
 }
 
 
@@ -5191,6 +5274,12 @@ void borg_update(void)
     /* Default "goal" location */
     g_x = c_x;
     g_y = c_y;
+
+
+    /*** Danger ***/
+
+    /* Forget the danger near anything which changed */
+    borg_danger_map_refresh();
 }
 
 
@@ -5290,6 +5379,9 @@ void borg_init_5(void)
     /* Array of "wanks" */
     C_MAKE(borg_wanks, AUTO_VIEW_MAX, borg_wank);
 
+    /* Array of monsters seen by the player */
+    C_MAKE(borg_seen, z_info->m_max, struct observed_monster);
+
 
     /*** Reset the map ***/
 
@@ -8,6 +8,7 @@
 #include "target.h"
 #include "spells.h"
 #include "object/inventory.h"
+#include "observe.h"
 
 #include "borg1.h"
 #include "borg2.h"
@@ -2443,6 +2444,23 @@ static void borg_parse(char *msg)
     }
 }
 
+/*
+ * Parse the messages collected by the observation interface.
+ *
+ * These arrive whole and one at a time, so there is no need to guess
+ * where the screen split or joined them.
+ */
+static void borg_parse_observed(void)
+{
+    char buf[1024];
+
+    while (observe_message_next(buf, sizeof(buf), NULL))
+    {
+        borg_parse(buf);
+        borg_parse(NULL);
+    }
+}
+
 
 
 #ifndef BABLOS
@@ -3129,7 +3147,10 @@ void resurrect_borg(void)
 
 		/* Seed for random artifacts */
 		if (!seed_randart || !OPT(birth_keep_randarts))
+		{
 			seed_randart = randint0(0x10000000);
+			randart_version = RANDART_VERSION;
+		}
 
 		/* Randomize the artifacts if required */
 		if (OPT(birth_randarts))
@@ -3486,8 +3507,14 @@ static struct keypress borg_inkey_hack(int flush_first)
         (0 == borg_what_text(x-7, y, 7, &t_a, buf)) &&
         (streq(buf, " -more-")))
     {
+        /* Get the messages directly */
+        if (borg_uses_observe)
+        {
+            borg_parse_observed();
+        }
+
         /* Get the message */
-        if (0 == borg_what_text(0, 0, x-7, &t_a, buf))
+        else if (0 == borg_what_text(0, 0, x-7, &t_a, buf))
         {
             /* Parse it */
             borg_parse(buf);
@@ -3503,8 +3530,14 @@ static struct keypress borg_inkey_hack(int flush_first)
     /* And the game wants a command */
     if (borg_prompt && inkey_flag)
     {
+        /* Get the messages directly */
+        if (borg_uses_observe)
+        {
+            borg_parse_observed();
+        }
+
         /* Get the message(s) */
-        if (0 == borg_what_text(0, 0, ((Term->wid - 1) / (tile_width)), &t_a, buf))
+        else if (0 == borg_what_text(0, 0, ((Term->wid - 1) / (tile_width)), &t_a, buf))
         {
             int k = strlen(buf);
 
@@ -3523,6 +3556,10 @@ static struct keypress borg_inkey_hack(int flush_first)
         return key;
 
     }
+
+    /* Get any messages which never reached the screen */
+    if (borg_uses_observe) borg_parse_observed();
+
     /* Flush messages */
     borg_parse(NULL);
     borg_dont_react = FALSE;
@@ -4259,6 +4296,7 @@ void init_borg_txt_file(void)
 	borg_no_deeper = 127;
 	borg_stop_king = TRUE;
 	borg_uses_calcs = FALSE;
+	borg_uses_observe = FALSE;
 	borg_respawn_winners = FALSE;
 	borg_respawn_class = -1;
 	borg_respawn_race = -1;
@@ -4418,6 +4456,15 @@ void init_borg_txt_file(void)
             continue;
         }
 
+        if (prefix(buf, "borg_uses_observe ="))
+        {
+            if (buf[strlen("borg_uses_observe =")+1] == 'T' ||
+                buf[strlen("borg_uses_observe =")+1] == '1' ||
+                buf[strlen("borg_uses_observe =")+1] == 't') borg_uses_observe = TRUE;
+            else borg_uses_observe = FALSE;
+            continue;
+        }
+
         if (prefix(buf, "borg_respawn_winners ="))
         {
             if (buf[strlen("borg_respawn_winners =")+1] == 'T' ||
@@ -4623,6 +4670,9 @@ void borg_init_9(void)
     prt("Initializing the Borg... (borg.txt)", 0, 0);
     init_borg_txt_file();
 
+    /* Collect messages directly, if asked */
+    observe_messages_watch(borg_uses_observe);
+
 
     /*** Hack -- initialize game options ***/
 
@@ -5974,6 +6024,7 @@ void do_cmd_borg(void)
     		C_MAKE(n_pwr, MAX_CLASSES, int);
 
             init_borg_txt_file();
+            observe_messages_watch(borg_uses_observe);
             borg_note("# Ready...");
             break;
         }
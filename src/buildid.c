@@ -2,3 +2,6 @@
 
 const char *buildid = VERSION_NAME " " VERSION_STRING;
 const char *buildver = VERSION_STRING;
+
+/* When this build was made; buildid.o is rebuilt whenever anything changes */
+const char *buildstamp = __DATE__ " " __TIME__;
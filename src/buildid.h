@@ -13,5 +13,6 @@
 
 extern const char *buildid;
 extern const char *buildver;
+extern const char *buildstamp;
 
 #endif /* BUILDID */
@@ -19,6 +19,7 @@
 #include "angband.h"
 #include "cave.h"
 #include "cmds.h"
+#include "dist-field.h"
 #include "game-event.h"
 #include "game-cmd.h"
 #include "monster/mon-util.h"
@@ -526,6 +527,11 @@ static void grid_get_attr(grid_data *g, byte *a)
  */
 void grid_data_as_text(grid_data *g, byte *ap, wchar_t *cp, byte *tap, wchar_t *tcp)
 {
+	static const bitflag multi_hued[FLAG_MASK_MAX] =
+		FLAG_MASK(RF_ATTR_MULTI, RF_ATTR_FLICKER, RF_ATTR_RAND);
+	static const bitflag clear[FLAG_MASK_MAX] =
+		FLAG_MASK(RF_ATTR_CLEAR, RF_CHAR_CLEAR);
+
 	feature_type *f_ptr = &f_info[g->f_idx];
 
 	byte a = f_ptr->x_attr[g->lighting];
@@ -623,9 +629,7 @@ void grid_data_as_text(grid_data *g, byte *ap, wchar_t *cp, byte *tap, wchar_t *
 			}
 
 			/* Multi-hued monster */
-			else if (rf_has(r_ptr->flags, RF_ATTR_MULTI) ||
-					 rf_has(r_ptr->flags, RF_ATTR_FLICKER) ||
-					 rf_has(r_ptr->flags, RF_ATTR_RAND)) {
+			else if (rf_is_inter(r_ptr->flags, multi_hued)) {
 				/* Multi-hued attr */
 				a = m_ptr->attr ? m_ptr->attr : da;
 				
@@ -634,8 +638,7 @@ void grid_data_as_text(grid_data *g, byte *ap, wchar_t *cp, byte *tap, wchar_t *
 			}
 			
 			/* Normal monster (not "clear" in any way) */
-			else if (!flags_test(r_ptr->flags, RF_SIZE,
-				RF_ATTR_CLEAR, RF_CHAR_CLEAR, FLAG_END))
+			else if (!rf_is_inter(r_ptr->flags, clear))
 			{
 				/* Use attr */
 				a = da;
@@ -1058,6 +1061,9 @@ void print_rel(wchar_t c, byte a, int y, int x)
 	int ky, kx;
 	int vy, vx;
 
+	/* Pending map updates mustn't land on top of this */
+	event_flush();
+
 	/* Print on map sub-windows */
 	print_rel_map(c, a, y, x);
 
@@ -1088,6 +1094,144 @@ void print_rel(wchar_t c, byte a, int y, int x)
 
 
 
+/*
+ * The map as last drawn, one cell per grid, so that redrawing the whole map
+ * (which happens on every panel change, and a good deal more besides) only
+ * has to work out the grids which have changed since.
+ *
+ * A grid is worked out again if it has been marked dirty (by
+ * cave_light_spot(), cave_note_spot() and friends), if the few things about
+ * the grid itself which it was drawn from have changed, or if anything which
+ * could affect the whole map has.  Grids with a monster or the player in
+ * are never kept, as monsters can change colour whenever they like, and
+ * neither is anything drawn while the player is hallucinating.
+ */
+struct map_cell {
+	byte a, ta;
+	wchar_t c, tc;
+
+	/* What it was drawn from */
+	byte info;
+	byte info2;
+	byte feat;
+	byte trap;
+	bool trap_known;
+	s16b o_idx;
+	byte o_marked;
+	bool o_ignore;
+};
+
+#define MAP_DIRTY_WORDS	((DUNGEON_WID + 31) / 32)
+
+static struct map_cell map_cells[DUNGEON_HGT][DUNGEON_WID];
+static u32b map_dirty[DUNGEON_HGT][MAP_DIRTY_WORDS];
+
+/*
+ * Everything outside the grid that the whole map depends on
+ */
+static struct {
+	struct cave *cave;
+	s32b created_at;
+	int graphics;
+	bool unignoring;
+	u32b knowledge;
+	bool opt[OPT_MAX];
+} map_view;
+
+static void map_cell_dirty(struct cave *c, int y, int x)
+{
+	if (c == cave)
+		map_dirty[y][x / 32] |= 1L << (x % 32);
+}
+
+/*
+ * Forget the whole of the drawn map, so it is all worked out afresh next
+ * time.  Anything which changes how the map is drawn (visuals, squelch
+ * settings and so on) without telling us grid by grid should call this.
+ */
+void map_cache_reset(void)
+{
+	memset(map_dirty, 0xFF, sizeof(map_dirty));
+}
+
+/*
+ * Check that nothing which affects the whole map has changed since it was
+ * last drawn.
+ */
+static void map_view_check(void)
+{
+	if (map_view.cave == cave && map_view.created_at == cave->created_at &&
+			map_view.graphics == use_graphics &&
+			map_view.unignoring == p_ptr->unignoring &&
+			map_view.knowledge == object_knowledge &&
+			!memcmp(map_view.opt, op_ptr->opt, sizeof(map_view.opt)))
+		return;
+
+	map_view.cave = cave;
+	map_view.created_at = cave->created_at;
+	map_view.graphics = use_graphics;
+	map_view.unignoring = p_ptr->unignoring;
+	map_view.knowledge = object_knowledge;
+	memcpy(map_view.opt, op_ptr->opt, sizeof(map_view.opt));
+
+	map_cache_reset();
+}
+
+/*
+ * Work out how to draw the grid at (y, x), like map_info() followed by
+ * grid_data_as_text(), but using the last drawing of it if that still
+ * holds.
+ */
+void map_grid_text(int y, int x, byte *ap, wchar_t *cp, byte *tap,
+		wchar_t *tcp)
+{
+	struct map_cell *cell = &map_cells[y][x];
+	object_type *o_ptr = get_first_object(y, x);
+	struct map_cell now;
+	grid_data g;
+
+	/* Monsters, the player and hallucinations are always worked out */
+	if (cave->m_idx[y][x] || p_ptr->timed[TMD_IMAGE]) {
+		map_info(y, x, &g);
+		grid_data_as_text(&g, ap, cp, tap, tcp);
+		return;
+	}
+
+	now.info = cave->info[y][x];
+	now.info2 = cave->info2[y][x];
+	now.feat = cave->feat[y][x];
+	now.trap = cave->trap[y][x];
+	now.trap_known = cave_isknowntrap(cave, y, x);
+	now.o_idx = cave->o_idx[y][x];
+	now.o_marked = o_ptr ? o_ptr->marked : 0;
+	now.o_ignore = o_ptr ? o_ptr->ignore : FALSE;
+
+	if (!(map_dirty[y][x / 32] & (1L << (x % 32))) &&
+			cell->info == now.info && cell->info2 == now.info2 &&
+			cell->feat == now.feat && cell->trap == now.trap &&
+			cell->trap_known == now.trap_known &&
+			cell->o_idx == now.o_idx && cell->o_marked == now.o_marked &&
+			cell->o_ignore == now.o_ignore) {
+		*ap = cell->a;
+		*cp = cell->c;
+		*tap = cell->ta;
+		*tcp = cell->tc;
+		return;
+	}
+
+	map_info(y, x, &g);
+	grid_data_as_text(&g, &now.a, &now.c, &now.ta, &now.tc);
+
+	*cell = now;
+	map_dirty[y][x / 32] &= ~(1L << (x % 32));
+
+	*ap = now.a;
+	*cp = now.c;
+	*tap = now.ta;
+	*tcp = now.tc;
+}
+
+
 /*
  * Memorize interesting viewable object/features in the given grid
  *
@@ -1125,6 +1269,8 @@ void cave_note_spot(struct cave *c, int y, int x)
 	if (!(c->info[y][x] & CAVE_SEEN))
 		return;
 
+	map_cell_dirty(c, y, x);
+
 	for (o_ptr = get_first_object(y, x); o_ptr; o_ptr = get_next_object(o_ptr))
 		o_ptr->marked = MARK_SEEN;
 
@@ -1132,7 +1278,75 @@ void cave_note_spot(struct cave *c, int y, int x)
 		return;
 
 	/* Memorize this grid */
-	cave->info[y][x] |= (CAVE_MARK);
+	cave_memorize(c, y, x);
+}
+
+
+/*
+ * Note that the terrain at (y, x), or the player's memory of it, has
+ * changed.
+ *
+ * Anything which caches facts about the map as the player knows it can
+ * watch c->map_stamp, or cave_map_stamp_near() for just part of the map,
+ * to find out when it needs to look again.
+ */
+void cave_map_changed(struct cave *c, int y, int x)
+{
+	c->map_stamp++;
+	c->region_stamp[y / MAP_REGION_SIZE][x / MAP_REGION_SIZE] = c->map_stamp;
+}
+
+/*
+ * Note that the whole map has changed.
+ */
+void cave_map_changed_all(struct cave *c)
+{
+	int ry, rx;
+
+	c->map_stamp++;
+	for (ry = 0; ry < MAP_REGION_HGT; ry++)
+		for (rx = 0; rx < MAP_REGION_WID; rx++)
+			c->region_stamp[ry][rx] = c->map_stamp;
+}
+
+/*
+ * Return a stamp which changes whenever the terrain within `r` grids of
+ * (y, x), or the player's memory of it, does.
+ *
+ * Region stamps are all taken from c->map_stamp, which only goes up, so
+ * the latest of the regions around (y, x) does the job.
+ */
+u32b cave_map_stamp_near(struct cave *c, int y, int x, int r)
+{
+	int ry1 = MAX(y - r, 0) / MAP_REGION_SIZE;
+	int ry2 = MIN(y + r, DUNGEON_HGT - 1) / MAP_REGION_SIZE;
+	int rx1 = MAX(x - r, 0) / MAP_REGION_SIZE;
+	int rx2 = MIN(x + r, DUNGEON_WID - 1) / MAP_REGION_SIZE;
+	int ry, rx;
+	u32b stamp = 0;
+
+	for (ry = ry1; ry <= ry2; ry++)
+		for (rx = rx1; rx <= rx2; rx++)
+			stamp = MAX(stamp, c->region_stamp[ry][rx]);
+
+	return stamp;
+}
+
+/*
+ * Memorize or forget the terrain at (y, x).
+ */
+void cave_memorize(struct cave *c, int y, int x)
+{
+	c->info[y][x] |= (CAVE_MARK);
+	cave_map_changed(c, y, x);
+	map_cell_dirty(c, y, x);
+}
+
+void cave_forget(struct cave *c, int y, int x)
+{
+	c->info[y][x] &= ~(CAVE_MARK);
+	cave_map_changed(c, y, x);
+	map_cell_dirty(c, y, x);
 }
 
 
@@ -1144,6 +1358,7 @@ void cave_note_spot(struct cave *c, int y, int x)
  */
 void cave_light_spot(struct cave *c, int y, int x)
 {
+	map_cell_dirty(c, y, x);
 	event_signal_point(EVENT_MAP, x, y);
 }
 
@@ -1154,7 +1369,6 @@ static void prt_map_aux(void)
 	wchar_t c;
 	byte ta;
 	wchar_t tc;
-	grid_data g;
 
 	int y, x;
 	int vy, vx;
@@ -1189,8 +1403,7 @@ static void prt_map_aux(void)
 				if (vx + tile_width - 1 >= t->wid) continue;
 
 				/* Determine what is there */
-				map_info(y, x, &g);
-				grid_data_as_text(&g, &a, &c, &ta, &tc);
+				map_grid_text(y, x, &a, &c, &ta, &tc);
 				Term_queue_char(t, vx, vy, a, c, ta, tc);
 
 				if ((tile_width > 1) || (tile_height > 1))
@@ -1215,12 +1428,14 @@ void prt_map(void)
 	wchar_t c;
 	byte ta;
 	wchar_t tc;
-	grid_data g;
 
 	int y, x;
 	int vy, vx;
 	int ty, tx;
 
+	/* Start again if the whole map might look different */
+	map_view_check();
+
 	/* Redraw map sub-windows */
 	prt_map_aux();
 
@@ -1237,8 +1452,7 @@ void prt_map(void)
 			if (!in_bounds(y, x)) continue;
 
 			/* Determine what is there */
-			map_info(y, x, &g);
-			grid_data_as_text(&g, &a, &c, &ta, &tc);
+			map_grid_text(y, x, &a, &c, &ta, &tc);
 
 			/* Hack -- Queue it */
 			Term_queue_char(Term, vx, vy, a, c, ta, tc);
@@ -2814,11 +3028,6 @@ void update_view(void)
 
 
 
-/*
- * Size of the circular queue used by "update_flow()"
- */
-#define FLOW_MAX 2048
-
 /*
  * Hack -- provide some "speed" for the "flow" code
  * This entry is the "current index" for the "when" field
@@ -2863,6 +3072,19 @@ void cave_forget_flow(struct cave *c)
 }
 
 
+/*
+ * Distances from the player, for cave_update_flow()
+ */
+static struct dist_field flow_field;
+
+/*
+ * Monsters can flow through anything but walls and rubble.
+ */
+static bool flow_pass(struct cave *c, int y, int x)
+{
+	return c->feat[y][x] < FEAT_RUBBLE;
+}
+
 /*
  * Hack -- fill in the "cost" field of every grid that the player can
  * "reach" with the number of steps needed to reach that grid.  This
@@ -2871,30 +3093,19 @@ void cave_forget_flow(struct cave *c)
  * In addition, mark the "when" of the grids that can reach the player
  * with the incremented value of "flow_save".
  *
- * Hack -- use the local "flow_y" and "flow_x" arrays as a "circular
- * queue" of cave grids.
- *
- * We do not need a priority queue because the cost from grid to grid
- * is always "one" (even along diagonals) and we process them in order.
+ * Monsters don't look more than MONSTER_FLOW_DEPTH grids away, so the
+ * search doesn't either.
  */
 void cave_update_flow(struct cave *c)
 {
 	int py = p_ptr->py;
 	int px = p_ptr->px;
 
-	int ty, tx;
-
 	int y, x;
 
-	int n, d;
-
 	int flow_n;
 
-	int flow_tail = 0;
-	int flow_head = 0;
-
-	byte flow_y[FLOW_MAX];
-	byte flow_x[FLOW_MAX];
+	int pos = 0;
 
 
 	/*** Cycle the flow ***/
@@ -2920,71 +3131,18 @@ void cave_update_flow(struct cave *c)
 	flow_n = flow_save;
 
 
-	/*** Player Grid ***/
-
-	/* Save the time-stamp */
-	c->when[py][px] = flow_n;
-
-	/* Save the flow cost */
-	c->cost[py][px] = 0;
-
-	/* Enqueue that entry */
-	flow_y[flow_head] = py;
-	flow_x[flow_head] = px;
-
-	/* Advance the queue */
-	++flow_tail;
-
-
-	/*** Process Queue ***/
-
-	/* Now process the queue */
-	while (flow_head != flow_tail)
-	{
-		/* Extract the next entry */
-		ty = flow_y[flow_head];
-		tx = flow_x[flow_head];
-
-		/* Forget that entry (with wrap) */
-		if (++flow_head == FLOW_MAX) flow_head = 0;
-
-		/* Child cost */
-		n = c->cost[ty][tx] + 1;
-
-		/* Hack -- Limit flow depth */
-		if (n == MONSTER_FLOW_DEPTH) continue;
-
-		/* Add the "children" */
-		for (d = 0; d < 8; d++)
-		{
-			int old_head = flow_tail;
-
-			/* Child location */
-			y = ty + ddy_ddd[d];
-			x = tx + ddx_ddd[d];
-
-			/* Ignore "pre-stamped" entries */
-			if (c->when[y][x] == flow_n) continue;
+	/*** Find the distances ***/
 
-			/* Ignore "walls" and "rubble" */
-			if (c->feat[y][x] >= FEAT_RUBBLE) continue;
+	dist_field_init(&flow_field, DUNGEON_HGT, DUNGEON_WID, TRUE);
+	dist_field_fill_near(&flow_field, c, flow_pass, py, px,
+		MONSTER_FLOW_DEPTH);
+	dist_field_add_source(&flow_field, py, px);
+	dist_field_run(&flow_field, MONSTER_FLOW_DEPTH - 1);
 
-			/* Save the time-stamp */
-			c->when[y][x] = flow_n;
-
-			/* Save the flow cost */
-			c->cost[y][x] = n;
-
-			/* Enqueue that entry */
-			flow_y[flow_tail] = y;
-			flow_x[flow_tail] = x;
-
-			/* Advance the queue */
-			if (++flow_tail == FLOW_MAX) flow_tail = 0;
-
-			/* Hack -- Overflow by forgetting new entry */
-			if (flow_tail == flow_head) flow_tail = old_head;
-		}
+	/* Save the time-stamp and cost of every grid reached */
+	while (dist_field_next(&flow_field, &pos, &y, &x)) {
+		c->when[y][x] = flow_n;
+		c->cost[y][x] = dist_field_get(&flow_field, y, x);
 	}
 }
 
@@ -3038,7 +3196,7 @@ void wiz_light(bool full)
 
 					/* Memorize normal features */
 					if (cave->feat[yy][xx] > FEAT_FLOOR)
-						cave->info[yy][xx] |= (CAVE_MARK);
+						cave_memorize(cave, yy, xx);
 				}
 			}
 		}
@@ -3066,7 +3224,7 @@ void wiz_dark(void)
 		for (x = 0; x < DUNGEON_WID; x++)
 		{
 			/* Process the grid */
-			cave->info[y][x] &= ~(CAVE_MARK);
+			cave_forget(cave, y, x);
 			cave->info2[y][x] &= ~(CAVE2_DTRAP|CAVE2_DEDGE);
 		}
 	}
@@ -3115,7 +3273,7 @@ void cave_illuminate(struct cave *c, bool daytime)
 				c->info[y][x] |= (CAVE_GLOW);
 
 				/* Memorize the grid */
-				c->info[y][x] |= (CAVE_MARK);
+				cave_memorize(c, y, x);
 			}
 
 			/* Boring grids (light) */
@@ -3125,7 +3283,7 @@ void cave_illuminate(struct cave *c, bool daytime)
 				c->info[y][x] |= (CAVE_GLOW);
 
 				/* Memorize grids */
-				c->info[y][x] |= (CAVE_MARK);
+				cave_memorize(c, y, x);
 			}
 
 			/* Boring grids (dark) */
@@ -3135,7 +3293,7 @@ void cave_illuminate(struct cave *c, bool daytime)
 				c->info[y][x] &= ~(CAVE_GLOW);
 
 				/* Forget grids */
-				c->info[y][x] &= ~(CAVE_MARK);
+				cave_forget(c, y, x);
 			}
 		}
 	}
@@ -3157,7 +3315,7 @@ void cave_illuminate(struct cave *c, bool daytime)
 					c->info[yy][xx] |= (CAVE_GLOW);
 
 					/* Memorize grids */
-					c->info[yy][xx] |= (CAVE_MARK);
+					cave_memorize(c, yy, xx);
 				}
 			}
 		}
@@ -3180,6 +3338,7 @@ void cave_set_feat(struct cave *c, int y, int x, int feat)
 	 * honors those... */
 
 	c->feat[y][x] = feat;
+	cave_map_changed(c, y, x);
 
 	if (feat >= FEAT_DOOR_HEAD)
 		c->info[y][x] |= CAVE_WALL;
@@ -3192,6 +3351,39 @@ void cave_set_feat(struct cave *c, int y, int x, int feat)
 	}
 }
 
+/*
+ * Change `len` grids along the row from (y, x) to `feat`, as if by
+ * cave_set_feat() on each.
+ */
+void cave_set_feat_run(struct cave *c, int y, int x, int len, int feat)
+{
+	int i;
+
+	assert(c);
+	assert(y >= 0 && y < DUNGEON_HGT);
+	assert(x >= 0 && x + len <= DUNGEON_WID);
+
+	/* The player might see these, so do it properly */
+	if (character_dungeon) {
+		for (i = 0; i < len; i++)
+			cave_set_feat(c, y, x + i, feat);
+		return;
+	}
+
+	memset(&c->feat[y][x], feat, len);
+
+	for (i = 0; i < len; i++) {
+		/* Once for each region the run touches */
+		if (!i || !((x + i) % MAP_REGION_SIZE))
+			cave_map_changed(c, y, x + i);
+
+		if (feat >= FEAT_DOOR_HEAD)
+			c->info[y][x + i] |= CAVE_WALL;
+		else
+			c->info[y][x + i] &= ~CAVE_WALL;
+	}
+}
+
 bool cave_in_bounds(struct cave *c, int y, int x)
 {
 	return x >= 0 && x < c->width && y >= 0 && y < c->height;
@@ -3653,40 +3845,60 @@ bool is_quest(int level)
 
 struct cave *cave = NULL;
 
+/* How much memory the cave's arena gets at a time */
+#define CAVE_ARENA_BLOCK	(256 * 1024)
+
+/*
+ * Everything in the cave lives in its arena.  The arrays below are there
+ * for good; anything allocated after c->level lasts until the next level
+ * is generated, when it is all taken back at once (see cave_level_alloc()).
+ */
 struct cave *cave_new(void) {
 	struct cave *c = mem_zalloc(sizeof *c);
-	c->info = C_ZNEW(DUNGEON_HGT, byte_256);
-	c->info2 = C_ZNEW(DUNGEON_HGT, byte_256);
-	c->feat = C_ZNEW(DUNGEON_HGT, byte_wid);
-	c->trap = C_ZNEW(DUNGEON_HGT, byte_wid);
-	c->cost = C_ZNEW(DUNGEON_HGT, byte_wid);
-	c->when = C_ZNEW(DUNGEON_HGT, byte_wid);
-	c->m_idx = C_ZNEW(DUNGEON_HGT, s16b_wid);
-	c->o_idx = C_ZNEW(DUNGEON_HGT, s16b_wid);
-
-	c->monsters = C_ZNEW(z_info->m_max, struct monster);
+	struct mem_arena *a = mem_arena_new(CAVE_ARENA_BLOCK);
+
+	c->arena = a;
+	c->info = mem_arena_alloc(a, DUNGEON_HGT * sizeof(byte_256));
+	c->info2 = mem_arena_alloc(a, DUNGEON_HGT * sizeof(byte_256));
+	c->feat = mem_arena_alloc(a, DUNGEON_HGT * sizeof(byte_wid));
+	c->trap = mem_arena_alloc(a, DUNGEON_HGT * sizeof(byte_wid));
+	c->cost = mem_arena_alloc(a, DUNGEON_HGT * sizeof(byte_wid));
+	c->when = mem_arena_alloc(a, DUNGEON_HGT * sizeof(byte_wid));
+	c->m_idx = mem_arena_alloc(a, DUNGEON_HGT * sizeof(s16b_wid));
+	c->o_idx = mem_arena_alloc(a, DUNGEON_HGT * sizeof(s16b_wid));
+
+	c->monsters = mem_arena_alloc(a, z_info->m_max * sizeof(struct monster));
 	c->mon_max = 1;
-	c->traps = C_ZNEW(z_info->trap_max, struct trap);
+	c->traps = mem_arena_alloc(a, z_info->trap_max * sizeof(struct trap));
 	c->trap_max = 1;
 
+	c->level = mem_arena_mark(a);
+
 	c->created_at = 1;
 	return c;
 }
 
 void cave_free(struct cave *c) {
-	mem_free(c->info);
-	mem_free(c->info2);
-	mem_free(c->feat);
-	mem_free(c->trap);
-	mem_free(c->cost);
-	mem_free(c->when);
-	mem_free(c->m_idx);
-	mem_free(c->o_idx);
-	mem_free(c->monsters);
-	mem_free(c->traps);
+	mem_arena_free(c->arena);
 	mem_free(c);
 }
 
+/*
+ * Allocate `len` zeroed bytes which last until the next level is generated.
+ * Temporary workspace can be taken back sooner with mem_arena_mark() and
+ * mem_arena_release() on c->arena.
+ */
+void *cave_level_alloc(struct cave *c, size_t len) {
+	return mem_arena_alloc(c->arena, len);
+}
+
+/*
+ * Take back everything allocated for the last level.
+ */
+void cave_level_free(struct cave *c) {
+	mem_arena_release(c->arena, c->level);
+}
+
 /**
  * FEATURE PREDICATES
  *
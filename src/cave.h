@@ -19,6 +19,8 @@ extern void map_info(unsigned x, unsigned y, grid_data *g);
 extern void move_cursor_relative(int y, int x);
 extern void print_rel(wchar_t c, byte a, int y, int x);
 extern void prt_map(void);
+extern void map_grid_text(int y, int x, byte *ap, wchar_t *cp, byte *tap, wchar_t *tcp);
+extern void map_cache_reset(void);
 extern void display_map(int *cy, int *cx);
 extern void do_cmd_view_map(void);
 extern errr vinfo_init(void);
@@ -39,10 +41,36 @@ extern void disturb(struct player *p, int stop_search, int unused_flag);
 extern bool is_quest(int level);
 extern bool dtrap_edge(int y, int x);
 
+/*
+ * A vault or monster pit which was built on the current level.
+ */
+struct cave_room {
+	struct cave_room *next;
+	int kind;	/* CAVE_ROOM_VAULT or CAVE_ROOM_PIT */
+	int idx;	/* Index of the vault or pit type */
+};
+
+enum {
+	CAVE_ROOM_VAULT = 0,
+	CAVE_ROOM_PIT
+};
+
+/*
+ * The map is split into square regions, each of which has a stamp that
+ * changes whenever the terrain in it, or the player's memory of that
+ * terrain, does (see cave_map_stamp_near()).
+ */
+#define MAP_REGION_SIZE	8
+#define MAP_REGION_HGT	((DUNGEON_HGT + MAP_REGION_SIZE - 1) / MAP_REGION_SIZE)
+#define MAP_REGION_WID	((DUNGEON_WID + MAP_REGION_SIZE - 1) / MAP_REGION_SIZE)
+
 struct cave {
 	s32b created_at;
 	int depth;
 
+	u32b map_stamp; /* Changes whenever the terrain or the player's memory of it does */
+	u32b region_stamp[MAP_REGION_HGT][MAP_REGION_WID];
+
 	byte feeling;
 	u32b obj_rating;
 	u32b mon_rating;
@@ -67,6 +95,12 @@ struct cave {
 	int mon_cnt;
 	struct trap *traps;
 	int trap_max;
+
+	struct cave_room *rooms; /* Vaults and pits on this level */
+
+	/* Where the above arrays come from, and anything which lasts a level */
+	struct mem_arena *arena;
+	struct mem_arena_mark level;
 };
 
 /* XXX: temporary while I refactor */
@@ -74,9 +108,17 @@ extern struct cave *cave;
 
 extern struct cave *cave_new(void);
 extern void cave_free(struct cave *c);
+extern void *cave_level_alloc(struct cave *c, size_t len);
+extern void cave_level_free(struct cave *c);
 
 extern void cave_set_feat(struct cave *c, int y, int x, int feat);
+extern void cave_set_feat_run(struct cave *c, int y, int x, int len, int feat);
 extern void cave_note_spot(struct cave *c, int y, int x);
+extern void cave_memorize(struct cave *c, int y, int x);
+extern void cave_forget(struct cave *c, int y, int x);
+extern void cave_map_changed(struct cave *c, int y, int x);
+extern void cave_map_changed_all(struct cave *c);
+extern u32b cave_map_stamp_near(struct cave *c, int y, int x, int r);
 extern void cave_light_spot(struct cave *c, int y, int x);
 extern void cave_update_flow(struct cave *c);
 extern void cave_forget_flow(struct cave *c);
@@ -332,6 +332,7 @@ static void py_pickup_aux(int o_idx, bool domsg)
 	object_flags(o_ptr, f);
 	of_inter(f, p_ptr->known_runes);
 	of_union(o_ptr->known_flags, f);
+	object_knowledge_changed();
 	object_check_for_ident(o_ptr);
 
 	/* Optionally, display a message */
@@ -609,7 +610,7 @@ void move_player(int dir, bool disarm)
 			if (cave_isrubble(cave, y, x))
 			{
 				msgt(MSG_HITWALL, "You feel a pile of rubble blocking your way.");
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_memorize(cave, y, x);
 				cave_light_spot(cave, y, x);
 			}
 
@@ -617,7 +618,7 @@ void move_player(int dir, bool disarm)
 			else if (cave_iscloseddoor(cave, y, x))
 			{
 				msgt(MSG_HITWALL, "You feel a door blocking your way.");
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_memorize(cave, y, x);
 				cave_light_spot(cave, y, x);
 			}
 
@@ -625,7 +626,7 @@ void move_player(int dir, bool disarm)
 			else
 			{
 				msgt(MSG_HITWALL, "You feel a wall blocking your way.");
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_memorize(cave, y, x);
 				cave_light_spot(cave, y, x);
 			}
 		}
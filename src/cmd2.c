@@ -797,7 +797,7 @@ static bool twall(int y, int x)
 	sound(MSG_DIG);
 
 	/* Forget the wall */
-	cave->info[y][x] &= ~(CAVE_MARK);
+	cave_forget(cave, y, x);
 
 	/* Remove the feature */
 	cave_set_feat(cave, y, x, FEAT_FLOOR);
@@ -1188,7 +1188,7 @@ static bool do_cmd_disarm_aux(int y, int x)
 		player_exp_gain(p_ptr, power);
 
 		/* Forget the trap */
-		cave->info[y][x] &= ~(CAVE_MARK);
+		cave_forget(cave, y, x);
 
 		remove_trap(cave, y, x);
 	}
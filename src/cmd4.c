@@ -71,6 +71,9 @@ void do_cmd_redraw(void)
 	/* Hack -- React to changes */
 	Term_xtra(TERM_XTRA_REACT, 0);
 
+	/* Draw the whole map afresh */
+	map_cache_reset();
+
 
 	/* Combine and Reorder the pack (later) */
 	p_ptr->notice |= (PN_COMBINE | PN_REORDER);
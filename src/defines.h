@@ -476,6 +476,17 @@ enum
 #define ART_MORGOTH			34
 #define ART_GROND			111
 
+/* The lights, amulets and rings come first; randarts keep their base items */
+#define ART_MIN_NORMAL		16
+
+/*
+ * How randarts are made from their seed, as kept in the savefile.  Older
+ * savefiles all have RANDART_VERSION_SEQUENTIAL (or less), and keep their
+ * artifacts.
+ */
+#define RANDART_VERSION_SEQUENTIAL	63	/* One stream for the whole set */
+#define RANDART_VERSION			64	/* One stream per artifact */
+
 
 /*** Function flags ***/
 
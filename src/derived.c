@@ -0,0 +1,369 @@
+/*
+ * File: derived.c
+ * Purpose: On-disk cache of tables worked out from the edit files
+ *
+ * Copyright (c) 2012 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "buildid.h"
+#include "derived.h"
+
+/*
+ * Some tables, like monster power and the object allocation tables, are
+ * worked out from the edit files every time the game starts.  That's a
+ * large part of the start-up time of short runs, e.g. the stats and borg
+ * frontends, so we keep the results in the user directory and read them
+ * back on the next start if nothing has changed.
+ *
+ * The file starts with a magic number, the format version and a key made
+ * from the edit files, the build and anything else that changes the
+ * results (e.g. -r).  If the key doesn't match, the whole cache is thrown
+ * away.  The build part of the key is the version and the time of the
+ * build, so a rebuilt game won't load tables made by the old code; a build
+ * which doesn't go through the makefile's buildid.o rule may not get a new
+ * stamp, so DERIVED_VERSION must be bumped whenever eval_r_power(),
+ * init_obj_alloc() or the slay power code change what they work out.
+ *
+ * After that come the tables, each as:
+ *
+ *   u32b tag    - which table this is (DERIVED_*)
+ *   u32b len    - number of bytes which follow
+ *   u32b check  - FNV-1a hash of those bytes
+ *   len bytes   - the table, in whatever form its owner stored it
+ *
+ * Everything is in native byte order, since the file never leaves the
+ * machine which wrote it; a file from elsewhere just fails the version
+ * check.
+ *
+ * With DERIVED_CHECK set, owners are expected to work everything out
+ * afresh and pass it to derived_check(), which complains if the cache
+ * disagrees.
+ */
+#define DERIVED_MAGIC	"ADRV"
+#define DERIVED_VERSION	1
+#define DERIVED_FILE	"derived.cache"
+#define DERIVED_TEMP	"derived.cache.tmp"
+#define DERIVED_LEN_MAX	(1L << 24)	/* Bytes in one table, for sanity */
+
+int derived_flags;
+
+struct derived_table {
+	u32b tag;
+	size_t len;
+	byte *data;
+	struct derived_table *next;
+};
+
+static struct derived_table *tables;
+static bool loaded;
+static bool dirty;
+static u32b derived_key;
+
+static const char *table_names[DERIVED_MAX] = {
+	NULL,
+	"monster power",
+	"object allocation",
+	"slay values"
+};
+
+static u32b hash_bytes(u32b h, const byte *p, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		h ^= p[i];
+		h *= 16777619UL;
+	}
+
+	return h;
+}
+
+/*
+ * Hash the name and contents of one edit file.
+ */
+static u32b hash_file(const char *name)
+{
+	char path[1024];
+	char buf[4096];
+	u32b h = 2166136261UL;
+	ang_file *f;
+	int n;
+
+	path_build(path, sizeof(path), ANGBAND_DIR_EDIT, name);
+	f = file_open(path, MODE_READ, -1);
+	if (!f) return 0;
+
+	h = hash_bytes(h, (const byte *)name, strlen(name));
+	while ((n = file_read(f, buf, sizeof(buf))) > 0)
+		h = hash_bytes(h, (const byte *)buf, n);
+
+	file_close(f);
+	return h;
+}
+
+/*
+ * Make the key for the current edit files, build and options.  The files
+ * come back from the directory in no particular order, so their hashes
+ * are added together.
+ */
+static u32b make_key(void)
+{
+	char name[1024];
+	ang_dir *dir;
+	u32b sum = 0;
+	u32b h = 2166136261UL;
+	u32b extra[2];
+
+	dir = my_dopen(ANGBAND_DIR_EDIT);
+	if (!dir) return 0;
+
+	while (my_dread(dir, name, sizeof(name)))
+		if (suffix(name, ".txt"))
+			sum += hash_file(name);
+
+	my_dclose(dir);
+
+	extra[0] = sum;
+	extra[1] = arg_rebalance ? 1 : 0;
+	h = hash_bytes(h, (const byte *)extra, sizeof(extra));
+	h = hash_bytes(h, (const byte *)buildver, strlen(buildver));
+	h = hash_bytes(h, (const byte *)buildstamp, strlen(buildstamp));
+
+	return h;
+}
+
+static struct derived_table *find_table(u32b tag)
+{
+	struct derived_table *t;
+
+	for (t = tables; t; t = t->next)
+		if (t->tag == tag) return t;
+
+	return NULL;
+}
+
+static void free_tables(void)
+{
+	struct derived_table *t, *next;
+
+	for (t = tables; t; t = next) {
+		next = t->next;
+		mem_free(t->data);
+		mem_free(t);
+	}
+
+	tables = NULL;
+}
+
+/*
+ * Read the tables from the cache file, or nothing if it's missing, out of
+ * date or damaged.
+ */
+static void load_tables(void)
+{
+	char path[1024];
+	char magic[4];
+	u32b head[3];
+	ang_file *f;
+	bool bad = FALSE;
+
+	loaded = TRUE;
+
+	if ((derived_flags & DERIVED_OFF) || !ANGBAND_DIR_USER ||
+			!ANGBAND_DIR_EDIT)
+		return;
+
+	derived_key = make_key();
+
+	path_build(path, sizeof(path), ANGBAND_DIR_USER, DERIVED_FILE);
+	f = file_open(path, MODE_READ, -1);
+	if (!f) return;
+
+	if (file_read(f, magic, sizeof(magic)) != sizeof(magic) ||
+			memcmp(magic, DERIVED_MAGIC, sizeof(magic)) ||
+			file_read(f, (char *)head, 2 * sizeof(u32b)) !=
+				2 * sizeof(u32b) ||
+			head[0] != DERIVED_VERSION || head[1] != derived_key) {
+		file_close(f);
+		return;
+	}
+
+	while (!bad) {
+		struct derived_table *t;
+		int n = file_read(f, (char *)head, sizeof(head));
+
+		/* A clean end of file */
+		if (n == 0) break;
+
+		if (n != sizeof(head) || head[1] > DERIVED_LEN_MAX ||
+				find_table(head[0])) {
+			bad = TRUE;
+			break;
+		}
+
+		t = mem_zalloc(sizeof(*t));
+		t->tag = head[0];
+		t->len = head[1];
+		t->data = mem_alloc(t->len ? t->len : 1);
+		t->next = tables;
+		tables = t;
+
+		if (file_read(f, (char *)t->data, t->len) != (int)t->len ||
+				hash_bytes(2166136261UL, t->data, t->len) != head[2])
+			bad = TRUE;
+	}
+
+	/* Don't trust any of a damaged file */
+	if (bad) free_tables();
+
+	file_close(f);
+}
+
+/**
+ * Return the cached copy of table `tag` and put its size in `len`, or
+ * return NULL if there isn't one.
+ */
+const void *derived_find(u32b tag, size_t *len)
+{
+	struct derived_table *t;
+
+	if (!loaded) load_tables();
+
+	t = find_table(tag);
+	if (!t) return NULL;
+
+	*len = t->len;
+	return t->data;
+}
+
+/**
+ * Copy the cached copy of table `tag` into `buf`.  Returns FALSE, leaving
+ * `buf` alone, unless there's a cached copy exactly `len` bytes long.
+ */
+bool derived_fetch(u32b tag, void *buf, size_t len)
+{
+	size_t old_len;
+	const void *old = derived_find(tag, &old_len);
+
+	if (!old || old_len != len) return FALSE;
+
+	memcpy(buf, old, len);
+	return TRUE;
+}
+
+/**
+ * When checking the cache, complain if table `tag`, just worked out
+ * afresh, doesn't match the cached copy.
+ */
+void derived_check(u32b tag, const void *buf, size_t len)
+{
+	size_t old_len;
+	const void *old;
+
+	if (!(derived_flags & DERIVED_CHECK)) return;
+
+	old = derived_find(tag, &old_len);
+	if (old && (old_len != len || memcmp(old, buf, len)))
+		plog_fmt("The cached %s table is out of date.", table_names[tag]);
+}
+
+/**
+ * Replace the cached copy of table `tag` with `len` bytes from `buf`.  The
+ * cache file is rewritten by derived_save() if anything has changed.
+ */
+void derived_store(u32b tag, const void *buf, size_t len)
+{
+	struct derived_table *t;
+
+	if (!loaded) load_tables();
+	if ((derived_flags & DERIVED_OFF) || !derived_key) return;
+
+	t = find_table(tag);
+	if (t && t->len == len && !memcmp(t->data, buf, len)) return;
+
+	if (!t) {
+		t = mem_zalloc(sizeof(*t));
+		t->tag = tag;
+		t->next = tables;
+		tables = t;
+	}
+
+	mem_free(t->data);
+	t->data = mem_alloc(len ? len : 1);
+	memcpy(t->data, buf, len);
+	t->len = len;
+
+	dirty = TRUE;
+}
+
+/**
+ * Write the cache file out if any table has changed, and forget the
+ * tables.  The file is written under another name and moved into place,
+ * so a reader never sees half of it.  Several borg workers may save at
+ * once; they write the same tables, and if two of them mix up the temporary
+ * file the checks make the next load throw it away and work it out again.
+ */
+void derived_save(void)
+{
+	char path[1024], temp[1024];
+	struct derived_table *t;
+	ang_file *f;
+	bool ok;
+	u32b head[3];
+
+	if (!dirty || !ANGBAND_DIR_USER) {
+		free_tables();
+		loaded = FALSE;
+		return;
+	}
+
+	path_build(path, sizeof(path), ANGBAND_DIR_USER, DERIVED_FILE);
+	path_build(temp, sizeof(temp), ANGBAND_DIR_USER, DERIVED_TEMP);
+
+	f = file_open(temp, MODE_WRITE, FTYPE_RAW);
+	if (!f) {
+		free_tables();
+		loaded = FALSE;
+		dirty = FALSE;
+		return;
+	}
+
+	head[0] = DERIVED_VERSION;
+	head[1] = derived_key;
+	ok = file_write(f, DERIVED_MAGIC, 4) &&
+		file_write(f, (const char *)head, 2 * sizeof(u32b));
+
+	for (t = tables; t && ok; t = t->next) {
+		head[0] = t->tag;
+		head[1] = t->len;
+		head[2] = hash_bytes(2166136261UL, t->data, t->len);
+		ok = file_write(f, (const char *)head, sizeof(head)) &&
+			file_write(f, (const char *)t->data, t->len);
+	}
+
+	file_close(f);
+
+	/* Some systems won't move a file on top of another */
+	if (ok && !file_move(temp, path)) {
+		file_delete(path);
+		ok = file_move(temp, path);
+	}
+
+	if (!ok) file_delete(temp);
+
+	free_tables();
+	loaded = FALSE;
+	dirty = FALSE;
+}
@@ -0,0 +1,45 @@
+/*
+ * File: derived.h
+ * Purpose: On-disk cache of tables worked out from the edit files
+ *
+ * Copyright (c) 2012 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_DERIVED_H
+#define INCLUDED_DERIVED_H
+
+#include "h-basic.h"
+
+/* Flags for derived_flags */
+#define DERIVED_CHECK	0x01	/* Recompute everything and compare */
+#define DERIVED_OFF	0x02	/* Neither read nor write the cache */
+
+/* The tables which are cached */
+enum {
+	DERIVED_R_POWER = 1,
+	DERIVED_OBJ_ALLOC,
+	DERIVED_SLAYS,
+
+	DERIVED_MAX
+};
+
+extern int derived_flags;
+
+const void *derived_find(u32b tag, size_t *len);
+bool derived_fetch(u32b tag, void *buf, size_t len);
+void derived_check(u32b tag, const void *buf, size_t len);
+void derived_store(u32b tag, const void *buf, size_t len);
+void derived_save(void);
+
+#endif /* INCLUDED_DERIVED_H */
@@ -0,0 +1,321 @@
+/*
+ * File: dist-field.c
+ * Purpose: Breadth-first distances over the cave
+ *
+ * Copyright (c) 2012 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "dist-field.h"
+
+/*
+ * Grid (y, x) is bit x % 64 of word x / 64 of row y.  Every step costs
+ * one, so the grids at distance n + 1 are just the grids next to those at
+ * distance n which can be entered and haven't been reached yet.  Moving a
+ * row of bits one grid east or west is a shift, so the neighbours of a
+ * whole row of the front can be worked out with a few shifts and ors.
+ */
+#define DIST_ROW_BITS	(DIST_WORDS * 64)
+
+#define DIST_BIT(x)	((u64b)1 << ((x) % 64))
+
+/*
+ * Find the index of the only bit set in `bit`, by way of a de Bruijn
+ * sequence.
+ */
+static int bit_index(u64b bit)
+{
+	static const byte index[64] = {
+		0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+		62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+		63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+		46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+	};
+
+	return index[(bit * 0x03f79d71b4cb0a89ULL) >> 58];
+}
+
+/**
+ * Set up an empty field `height` by `width` grids, with nothing which can
+ * be entered and no sources.
+ */
+void dist_field_init(struct dist_field *f, int height, int width,
+	bool diagonal)
+{
+	f->height = MIN(height, DUNGEON_HGT);
+	f->width = MIN(width, DUNGEON_WID);
+	f->diagonal = diagonal;
+
+	memset(f->pass, 0, sizeof(f->pass));
+	dist_field_reset(f);
+}
+
+/**
+ * Mark every grid for which `pass` returns TRUE as one which can be
+ * entered.  A NULL `pass` lets every grid be entered.
+ */
+void dist_field_fill(struct dist_field *f, struct cave *c,
+	dist_pass_func pass)
+{
+	dist_field_fill_near(f, c, pass, 0, 0, MAX(f->height, f->width));
+}
+
+/**
+ * As dist_field_fill(), but only for the grids within `range` steps of
+ * (y, x); the rest are left as they were.  This is all a search which
+ * won't go further than `range` needs.
+ */
+void dist_field_fill_near(struct dist_field *f, struct cave *c,
+	dist_pass_func pass, int y, int x, int range)
+{
+	int y1 = MAX(y - range, 0), y2 = MIN(y + range, f->height - 1);
+	int x1 = MAX(x - range, 0), x2 = MIN(x + range, f->width - 1);
+	int ty, tx;
+
+	for (ty = y1; ty <= y2; ty++) {
+		u64b *row = f->pass[ty];
+
+		for (tx = x1; tx <= x2; tx++) {
+			if (!pass || pass(c, ty, tx))
+				row[tx / 64] |= DIST_BIT(tx);
+			else
+				row[tx / 64] &= ~DIST_BIT(tx);
+		}
+	}
+}
+
+void dist_field_set_pass(struct dist_field *f, int y, int x, bool pass)
+{
+	if (y < 0 || y >= f->height || x < 0 || x >= f->width) return;
+
+	if (pass)
+		f->pass[y][x / 64] |= DIST_BIT(x);
+	else
+		f->pass[y][x / 64] &= ~DIST_BIT(x);
+}
+
+/**
+ * Forget the sources and everything reached, but keep the grids which can
+ * be entered, ready for another search.
+ */
+void dist_field_reset(struct dist_field *f)
+{
+	memset(f->seen, 0, sizeof(f->seen));
+	f->depth = 0;
+	f->count = 0;
+	f->front_min = f->height;
+	f->front_max = -1;
+	f->cur = 0;
+}
+
+/**
+ * Add (y, x) as a source, at distance 0.  A source needn't be a grid which
+ * can be entered.  Sources should all be added before the first step.
+ *
+ * Once a search has run out of grids, new sources can be added and the
+ * search run again; grids which have already been reached are left alone,
+ * so a series of searches from grids which haven't been reached yet will
+ * pick out one connected region after another.
+ */
+void dist_field_add_source(struct dist_field *f, int y, int x)
+{
+	u64b (*front)[DIST_WORDS] = f->front[f->cur];
+	int ty;
+
+	if (y < 0 || y >= f->height || x < 0 || x >= f->width) return;
+	if (f->seen[y][x / 64] & DIST_BIT(x)) return;
+
+	/* Start again from distance 0 if the last search is over */
+	if (f->front_min > f->front_max) f->depth = 0;
+
+	/* Rows outside the front may hold leftovers, so clear any new ones */
+	if (f->front_min > f->front_max) {
+		memset(front[y], 0, sizeof(front[y]));
+		f->front_min = f->front_max = y;
+	}
+	for (ty = y; ty < f->front_min; ty++)
+		memset(front[ty], 0, sizeof(front[ty]));
+	for (ty = f->front_max + 1; ty <= y; ty++)
+		memset(front[ty], 0, sizeof(front[ty]));
+	f->front_min = MIN(f->front_min, y);
+	f->front_max = MAX(f->front_max, y);
+
+	front[y][x / 64] |= DIST_BIT(x);
+	f->seen[y][x / 64] |= DIST_BIT(x);
+	f->dist[y][x] = f->depth;
+	f->count++;
+}
+
+/*
+ * Add each grid in `src` and its east and west neighbours to `dst`.
+ */
+static void spread_row(const u64b *src, u64b *dst)
+{
+	int i;
+
+	for (i = 0; i < DIST_WORDS; i++) {
+		u64b east = src[i] << 1, west = src[i] >> 1;
+
+		if (i > 0) east |= src[i - 1] >> 63;
+		if (i < DIST_WORDS - 1) west |= src[i + 1] << 63;
+
+		dst[i] = src[i] | east | west;
+	}
+}
+
+/**
+ * Take one step out from the front, so that it holds the grids one
+ * further away.  Returns FALSE, leaving everything alone, if there
+ * are no more grids to reach.
+ */
+bool dist_field_step(struct dist_field *f)
+{
+	u64b (*front)[DIST_WORDS] = f->front[f->cur];
+	u64b (*next)[DIST_WORDS] = f->front[!f->cur];
+	u64b (*near)[DIST_WORDS] = f->diagonal ? f->wide : front;
+	int fmin = f->front_min, fmax = f->front_max;
+	int y1 = MAX(fmin - 1, 0), y2 = MIN(fmax + 1, f->height - 1);
+	int nmin = f->height, nmax = -1;
+	int y, i;
+
+	if (fmin > fmax) return FALSE;
+
+	/* Spread each row of the front sideways */
+	for (y = fmin; y <= fmax; y++)
+		spread_row(front[y], f->wide[y]);
+
+	for (y = y1; y <= y2; y++) {
+		bool any = FALSE;
+
+		for (i = 0; i < DIST_WORDS; i++) {
+			u64b bits = 0;
+
+			if (y - 1 >= fmin) bits |= near[y - 1][i];
+			if (y >= fmin && y <= fmax) bits |= f->wide[y][i];
+			if (y + 1 <= fmax) bits |= near[y + 1][i];
+
+			bits &= f->pass[y][i] & ~f->seen[y][i];
+			next[y][i] = bits;
+			if (!bits) continue;
+
+			any = TRUE;
+			f->seen[y][i] |= bits;
+
+			/* Record the distance to each new grid */
+			while (bits) {
+				u64b bit = bits & (~bits + 1);
+
+				f->dist[y][i * 64 + bit_index(bit)] = f->depth + 1;
+				f->count++;
+				bits ^= bit;
+			}
+		}
+
+		if (any) {
+			nmin = MIN(nmin, y);
+			nmax = y;
+		}
+	}
+
+	if (nmin > nmax) {
+		f->front_min = f->height;
+		f->front_max = -1;
+		return FALSE;
+	}
+
+	f->depth++;
+	f->cur = !f->cur;
+	f->front_min = nmin;
+	f->front_max = nmax;
+	return TRUE;
+}
+
+/**
+ * Step out from the sources until there's nowhere left to go, or until
+ * `max` steps out if `max` isn't 0.  Returns the distance reached.
+ */
+int dist_field_run(struct dist_field *f, int max)
+{
+	while (!max || f->depth < max)
+		if (!dist_field_step(f)) break;
+
+	return f->depth;
+}
+
+/**
+ * Return the distance to (y, x), or -1 if it hasn't been reached.
+ */
+int dist_field_get(const struct dist_field *f, int y, int x)
+{
+	if (y < 0 || y >= f->height || x < 0 || x >= f->width) return -1;
+	if (!(f->seen[y][x / 64] & DIST_BIT(x))) return -1;
+
+	return f->dist[y][x];
+}
+
+/*
+ * Find the next bit set in rows `y1` to `y2` of `bits` at or after
+ * position `*pos`.
+ */
+static bool next_bit(const u64b (*bits)[DIST_WORDS], int y1, int y2,
+	int *pos, int *y, int *x)
+{
+	int word = *pos / 64;
+	int end = (y2 + 1) * DIST_WORDS;
+
+	if (word < y1 * DIST_WORDS) {
+		word = y1 * DIST_WORDS;
+		*pos = word * 64;
+	}
+
+	while (word < end) {
+		u64b w = bits[word / DIST_WORDS][word % DIST_WORDS] &
+			(~(u64b)0 << (*pos % 64));
+
+		if (w) {
+			*pos = word * 64 + bit_index(w & (~w + 1));
+			*y = *pos / DIST_ROW_BITS;
+			*x = *pos % DIST_ROW_BITS;
+			(*pos)++;
+			return TRUE;
+		}
+
+		word++;
+		*pos = word * 64;
+	}
+
+	return FALSE;
+}
+
+/**
+ * Step through the grids which have been reached, from north to south.
+ * Set `*pos` to 0 to start; each call fills in the next grid and returns
+ * TRUE, or returns FALSE when there are none left.
+ */
+bool dist_field_next(const struct dist_field *f, int *pos, int *y, int *x)
+{
+	return next_bit((const u64b (*)[DIST_WORDS])f->seen, 0, f->height - 1,
+		pos, y, x);
+}
+
+/**
+ * As dist_field_next(), but just for the grids reached by the last step
+ * (or the sources, before the first step).
+ */
+bool dist_field_next_front(const struct dist_field *f, int *pos, int *y,
+	int *x)
+{
+	return next_bit((const u64b (*)[DIST_WORDS])f->front[f->cur],
+		f->front_min, f->front_max, pos, y, x);
+}
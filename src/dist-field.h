@@ -0,0 +1,61 @@
+/* dist-field.h - breadth-first distances over the cave */
+
+#ifndef DIST_FIELD_H
+#define DIST_FIELD_H
+
+#include "defines.h"
+#include "h-basic.h"
+
+struct cave;
+
+/* Words in one row of a bit grid */
+#define DIST_WORDS	((DUNGEON_WID + 63) / 64)
+
+/*
+ * A distance field holds the number of steps from the nearest of a set of
+ * source grids to every grid that can be reached from them.  Each grid
+ * which can be entered, each grid reached so far and the grids reached by
+ * the last step are kept one bit per grid, so that a step deals with 64
+ * grids at a time.
+ *
+ * Nothing is allocated; a field can be static, on the cave's arena, or
+ * anywhere else, and can be used again and again.
+ */
+struct dist_field {
+	int height;
+	int width;
+	bool diagonal;	/* Diagonal steps allowed, rather than just NESW */
+	int depth;	/* Distance reached by the last step */
+	int count;	/* Grids reached, sources included */
+
+	/* Rows of the front which might have anything in them */
+	int front_min, front_max;
+	int cur;	/* Which of the fronts is the current one */
+
+	u64b pass[DUNGEON_HGT][DIST_WORDS];
+	u64b seen[DUNGEON_HGT][DIST_WORDS];
+	u64b front[2][DUNGEON_HGT][DIST_WORDS];
+	u64b wide[DUNGEON_HGT][DIST_WORDS];	/* Workspace for dist_field_step() */
+	u16b dist[DUNGEON_HGT][DUNGEON_WID];	/* Only meaningful where seen */
+};
+
+/* Whether a grid can be entered */
+typedef bool (*dist_pass_func)(struct cave *c, int y, int x);
+
+void dist_field_init(struct dist_field *f, int height, int width,
+	bool diagonal);
+void dist_field_fill(struct dist_field *f, struct cave *c,
+	dist_pass_func pass);
+void dist_field_fill_near(struct dist_field *f, struct cave *c,
+	dist_pass_func pass, int y, int x, int range);
+void dist_field_set_pass(struct dist_field *f, int y, int x, bool pass);
+void dist_field_reset(struct dist_field *f);
+void dist_field_add_source(struct dist_field *f, int y, int x);
+bool dist_field_step(struct dist_field *f);
+int dist_field_run(struct dist_field *f, int max);
+int dist_field_get(const struct dist_field *f, int y, int x);
+bool dist_field_next(const struct dist_field *f, int *pos, int *y, int *x);
+bool dist_field_next_front(const struct dist_field *f, int *pos, int *y,
+	int *x);
+
+#endif /* DIST_FIELD_H */
@@ -47,6 +47,22 @@ void dungeon_change_level(int dlev)
 	if (!dlev && daycount)
 	{
 		if (OPT(cheat_xtra)) msg("Updating Shops...");
+
+		/*
+		 * Every day some of the stock is sold and new stock bought in,
+		 * so after a long enough absence there's almost certainly
+		 * nothing left of what the shops had before.  Rather than play
+		 * out every day, start them off empty and only maintain them
+		 * for the last STORE_MIXING_DAYS days.
+		 */
+		if (daycount > STORE_MIXING_DAYS)
+		{
+			int n;
+
+			for (n = 0; n < MAX_STORES; n++)
+				if (n != STORE_HOME) store_clear(&stores[n]);
+		}
+
 		while (daycount--)
 		{
 			int n;
@@ -57,6 +73,9 @@ void dungeon_change_level(int dlev)
 				/* Skip the home */
 				if (n == STORE_HOME) continue;
 
+				/* Skip days which won't make any difference */
+				if (daycount >= STORE_MIXING_DAYS) break;
+
 				/* Maintain */
 				store_maint(&stores[n]);
 			}
@@ -1014,6 +1033,9 @@ static void process_player(void)
 		/* Redraw stuff (if needed) */
 		if (p_ptr->redraw) redraw_stuff(p_ptr);
 
+		/* Send the redraws saved up over the last turn */
+		event_flush();
+
 
 		/* Place the cursor on the player */
 		move_cursor_relative(p_ptr->py, p_ptr->px);
@@ -1265,6 +1287,7 @@ void idle_update(void)
 	/* Animate and redraw if necessary */
 	do_animation();
 	redraw_stuff(p_ptr);
+	event_flush();
 
 	/* Refresh the main screen */
 	Term_fresh();
@@ -1403,6 +1426,7 @@ static void dungeon(struct cave *c)
 
 	/* Redraw stuff */
 	redraw_stuff(p_ptr);
+	event_flush();
 
 	/* Refresh */
 	Term_fresh();
@@ -1701,8 +1725,10 @@ void play_game(void)
 	}
 
 	/* Seed for random artifacts */
-	if (!seed_randart || (new_game && !OPT(birth_keep_randarts)))
+	if (!seed_randart || (new_game && !OPT(birth_keep_randarts))) {
 		seed_randart = randint0(0x10000000);
+		randart_version = RANDART_VERSION;
+	}
 
 	/* Randomize the artifacts if required */
 	if (OPT(birth_randarts))
@@ -1776,6 +1802,9 @@ void play_game(void)
 	/* Start playing */
 	p_ptr->playing = TRUE;
 
+	/* Merge redraws from here on; they're sent each turn and before input */
+	event_set_deferred(TRUE);
+
 	/* Save not required yet. */
 	p_ptr->autosave = FALSE;
 
@@ -1893,6 +1922,9 @@ void play_game(void)
 	/* Disallow big cursor */
 	smlcurs = TRUE;
 
+	/* Send anything left over, and go back to sending events at once */
+	event_set_deferred(FALSE);
+
 	/* Tell the UI we're done with the game state */
 	event_signal(EVENT_LEAVE_GAME);
 
@@ -51,6 +51,7 @@ extern bool character_saved;
 extern s16b character_icky;
 extern s16b character_xtra;
 extern u32b seed_randart;
+extern u32b randart_version;
 extern u32b seed_flavor;
 extern u32b seed_town;
 extern s16b num_repro;
@@ -196,7 +197,7 @@ extern int int_to_roman(int n, char *roman, size_t bufsize);
 extern void flush(void);
 extern void flush_fail(void);
 extern struct keypress inkey(void);
-extern ui_event inkey_m(void);
+extern ui_event inkey_m(void);
 extern ui_event inkey_ex(void);
 extern void anykey(void);
 extern void bell(const char *reason);
@@ -212,6 +213,7 @@ extern void c_prt(byte attr, const char *str, int row, int col);
 extern void prt(const char *str, int row, int col);
 extern void text_out_to_file(byte attr, const char *str);
 extern void text_out_to_screen(byte a, const char *str);
+extern void textblock_to_screen(textblock *tb);
 extern void text_out(const char *fmt, ...);
 extern void text_out_c(byte a, const char *fmt, ...);
 extern void text_out_e(const char *fmt, ...);
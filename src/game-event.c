@@ -29,6 +29,39 @@ struct event_handler_entry
 
 struct event_handler_entry *event_handlers[N_GAME_EVENTS];
 
+/*
+ * Deferred events.
+ *
+ * While deferral is on, events which only ask for something to be redrawn
+ * are queued up instead of being sent straight away, and a signal for an
+ * event which is already queued is dropped.  Points on the map are kept in
+ * a dirty bitmap (plus a list of the dirty points, so that sending them
+ * doesn't mean a scan of the whole bitmap), and a whole-map redraw throws
+ * away any points queued before or after it.  Everything is sent on the
+ * next call to event_flush(), in the order it was first signalled, with
+ * EVENT_END always last.
+ *
+ * Anything else - messages, context changes and so on - flushes the queue
+ * and is then sent as normal, so nothing overtakes an event which was
+ * signalled before it.
+ */
+#define EVENT_POINT_MAX		256
+#define EVENT_POINT_IDX(x, y)	((y) * EVENT_POINT_MAX + (x))
+
+static bool deferring;
+static bool flushing;
+
+static game_event_type pending_order[N_GAME_EVENTS];
+static size_t n_pending;
+static bool pending[N_GAME_EVENTS];
+static bool pending_has_flag[N_GAME_EVENTS];
+static bool pending_flag[N_GAME_EVENTS];
+
+static bool map_all;
+static byte *map_dirty;
+static u16b *map_points;
+static size_t n_map_points;
+
 static void game_event_dispatch(game_event_type type, game_event_data *data)
 {
 	struct event_handler_entry *this = event_handlers[type];
@@ -124,16 +157,189 @@ void event_remove_handler_set(game_event_type *type, size_t n_types, game_event_
 
 
 
+/*
+ * Events which just ask for part of the display to be brought up to date,
+ * and so can be put off and merged.  EVENT_PLAYERMOVED and EVENT_SEEFLOOR
+ * aren't: the first moves the panel, which direct drawing relies on, and
+ * the second prints a message.
+ */
+static bool event_can_defer(game_event_type type)
+{
+	switch (type)
+	{
+		case EVENT_MAP:
+		case EVENT_STATS:
+		case EVENT_HP:
+		case EVENT_MANA:
+		case EVENT_AC:
+		case EVENT_EXPERIENCE:
+		case EVENT_PLAYERLEVEL:
+		case EVENT_PLAYERTITLE:
+		case EVENT_GOLD:
+		case EVENT_MONSTERHEALTH:
+		case EVENT_DUNGEONLEVEL:
+		case EVENT_PLAYERSPEED:
+		case EVENT_RACE_CLASS:
+		case EVENT_STUDYSTATUS:
+		case EVENT_STATUS:
+		case EVENT_DETECTIONSTATUS:
+		case EVENT_STATE:
+		case EVENT_MOUSEBUTTONS:
+		case EVENT_INVENTORY:
+		case EVENT_EQUIPMENT:
+		case EVENT_ITEMLIST:
+		case EVENT_MONSTERLIST:
+		case EVENT_MONSTERTARGET:
+		case EVENT_OBJECTTARGET:
+		case EVENT_END:
+			return TRUE;
+
+		default:
+			return FALSE;
+	}
+}
+
+/*
+ * Note that `type` needs sending at the next flush.
+ */
+static void event_queue(game_event_type type)
+{
+	if (pending[type]) return;
+
+	pending[type] = TRUE;
+	if (type != EVENT_END)
+		pending_order[n_pending++] = type;
+}
+
+/*
+ * Send the queued map updates: either one whole-map redraw, or each dirty
+ * point once.
+ */
+static void event_flush_map(void)
+{
+	game_event_data data;
+	size_t i;
+
+	if (map_all) {
+		for (i = 0; i < n_map_points; i++)
+			map_dirty[map_points[i] / 8] = 0;
+		n_map_points = 0;
+		map_all = FALSE;
+
+		data.point.x = -1;
+		data.point.y = -1;
+		game_event_dispatch(EVENT_MAP, &data);
+		return;
+	}
+
+	/* Handlers may dirty more points, which just get added to the end */
+	for (i = 0; i < n_map_points; i++) {
+		u16b idx = map_points[i];
+
+		map_dirty[idx / 8] &= ~(1 << (idx % 8));
+
+		data.point.x = idx % EVENT_POINT_MAX;
+		data.point.y = idx / EVENT_POINT_MAX;
+		game_event_dispatch(EVENT_MAP, &data);
+	}
+	n_map_points = 0;
+}
+
+/**
+ * Turn deferred sending of redraw events on or off.  Turning it off sends
+ * anything still queued.
+ */
+void event_set_deferred(bool defer)
+{
+	if (defer == deferring) return;
+
+	if (defer) {
+		map_dirty = mem_zalloc(EVENT_POINT_MAX * EVENT_POINT_MAX / 8);
+		map_points = mem_zalloc(EVENT_POINT_MAX * EVENT_POINT_MAX *
+			sizeof(*map_points));
+		deferring = TRUE;
+	} else {
+		event_flush();
+		deferring = FALSE;
+		FREE(map_dirty);
+		FREE(map_points);
+	}
+}
+
+bool event_is_deferred(void)
+{
+	return deferring;
+}
+
+/**
+ * Send every queued event.  This should be called before anything which
+ * relies on the screen being up to date - asking for input, saving the
+ * screen, or drawing straight onto the map.
+ */
+void event_flush(void)
+{
+	if (!deferring || flushing) return;
+
+	flushing = TRUE;
+
+	while (n_pending || pending[EVENT_END]) {
+		game_event_type type;
+		game_event_data data;
+
+		/* EVENT_END waits until everything else has gone */
+		if (!n_pending) {
+			pending[EVENT_END] = FALSE;
+			game_event_dispatch(EVENT_END, NULL);
+			continue;
+		}
+
+		type = pending_order[0];
+		n_pending--;
+		memmove(pending_order, pending_order + 1,
+			n_pending * sizeof(*pending_order));
+		pending[type] = FALSE;
+
+		if (type == EVENT_MAP) {
+			event_flush_map();
+		} else if (pending_has_flag[type]) {
+			pending_has_flag[type] = FALSE;
+			data.flag = pending_flag[type];
+			game_event_dispatch(type, &data);
+		} else {
+			game_event_dispatch(type, NULL);
+		}
+	}
+
+	flushing = FALSE;
+}
+
+
 void event_signal(game_event_type type)
 {
+	if (deferring && event_can_defer(type) && type != EVENT_MAP) {
+		event_queue(type);
+		return;
+	}
+
+	event_flush();
 	game_event_dispatch(type, NULL);
 }
 
 void event_signal_flag(game_event_type type, bool flag)
 {
 	game_event_data data;
-	data.flag = flag;
 
+	if (deferring && event_can_defer(type) && type != EVENT_MAP) {
+		/* The most recent value is the one that counts */
+		pending_has_flag[type] = TRUE;
+		pending_flag[type] = flag;
+		event_queue(type);
+		return;
+	}
+
+	event_flush();
+
+	data.flag = flag;
 	game_event_dispatch(type, &data);
 }
 
@@ -141,9 +347,31 @@ void event_signal_flag(game_event_type type, bool flag)
 void event_signal_point(game_event_type type, int x, int y)
 {
 	game_event_data data;
+
+	if (deferring && type == EVENT_MAP) {
+		/* A whole-map redraw covers everything */
+		if (x == -1 && y == -1) {
+			map_all = TRUE;
+			event_queue(type);
+			return;
+		}
+
+		if (x >= 0 && x < EVENT_POINT_MAX && y >= 0 && y < EVENT_POINT_MAX) {
+			u16b idx = EVENT_POINT_IDX(x, y);
+
+			if (!map_all && !(map_dirty[idx / 8] & (1 << (idx % 8)))) {
+				map_dirty[idx / 8] |= 1 << (idx % 8);
+				map_points[n_map_points++] = idx;
+			}
+			event_queue(type);
+			return;
+		}
+	}
+
+	event_flush();
+
 	data.point.x = x;
 	data.point.y = y;
-
 	game_event_dispatch(type, &data);
 }
 
@@ -153,6 +381,17 @@ void event_signal_string(game_event_type type, const char *s)
 	game_event_data data;
 	data.string = s;
 
+	event_flush();
+	game_event_dispatch(type, &data);
+}
+
+void event_signal_message(game_event_type type, int t, const char *s)
+{
+	game_event_data data;
+	data.message.type = t;
+	data.message.msg = s;
+
+	event_flush();
 	game_event_dispatch(type, &data);
 }
 
@@ -163,6 +402,7 @@ void event_signal_birthpoints(int stats[6], int remaining)
 	data.birthstats.stats = stats;
 	data.birthstats.remaining = remaining;
 
+	event_flush();
 	game_event_dispatch(EVENT_BIRTHPOINTS, &data);
 }
 
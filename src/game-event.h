@@ -86,6 +86,12 @@ typedef union
 		int remaining;
 	} birthstats;
 
+	struct
+	{
+		const char *msg;
+		int type;
+	} message;
+
 } game_event_data;
 
 
@@ -107,7 +113,12 @@ void event_signal_birthpoints(int stats[6], int remaining);
 
 void event_signal_point(game_event_type, int x, int y);
 void event_signal_string(game_event_type, const char *s);
+void event_signal_message(game_event_type type, int t, const char *s);
 void event_signal_flag(game_event_type type, bool flag);
 void event_signal(game_event_type);
 
+void event_set_deferred(bool defer);
+bool event_is_deferred(void);
+void event_flush(void);
+
 #endif /* INCLUDED_GAME_EVENT_H */
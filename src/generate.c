@@ -19,6 +19,7 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "dist-field.h"
 #include "math.h"
 #include "files.h"
 #include "generate.h"
@@ -26,7 +27,6 @@
 #include "monster/mon-spell.h"
 #include "object/tvalsval.h"
 #include "trap.h"
-#include "z-queue.h"
 #include "z-type.h"
 
 /**
@@ -358,14 +358,15 @@ static bool cave_find_in_range(struct cave *c, int *y, int y1, int y2,
 	int i, found;
 
 	/* Allocate the squares, and randomize their order */
-	int *squares = C_ZNEW(n, int);
+	struct mem_arena_mark mark = mem_arena_mark(c->arena);
+	int *squares = cave_level_alloc(c, n * sizeof(int));
 	for (i = 0; i < n; i++) squares[i] = i;
 
 	/* Do the actual search */
 	found = _find_in_range(c, y, y1, y2, x, x1, x2, squares, pred);
 
 	/* Deallocate memory */
-	FREE(squares);
+	mem_arena_release(c->arena, mark);
 
 	/* Return whether or not we found an empty square */
 	return found;
@@ -1504,6 +1505,21 @@ static bool build_large(struct cave *c, int y0, int x0)
 }
 
 
+/**
+ * Remember that a vault or pit was built on this level, for anything
+ * (such as the stats frontend) which wants to know afterwards.
+ */
+static void note_room(struct cave *c, int kind, int idx)
+{
+	struct cave_room *room = cave_level_alloc(c, sizeof(*room));
+
+	room->kind = kind;
+	room->idx = idx;
+	room->next = c->rooms;
+	c->rooms = room;
+}
+
+
 /* Hook for which type of pit we are building */
 pit_profile *pit_type = NULL;
 
@@ -1693,6 +1709,7 @@ static bool build_nest(struct cave *c, int y0, int x0)
 
 	/* Describe */
 	ROOM_LOG("Monster nest (%s)", pit_info[pit_idx].name);
+	note_room(c, CAVE_ROOM_PIT, pit_idx);
 
 	/* Increase the level rating */
 	c->mon_rating += (5 + pit_info[pit_idx].ave / 10);
@@ -1805,6 +1822,7 @@ static bool build_pit(struct cave *c, int y0, int x0)
 		return FALSE;
 
 	ROOM_LOG("Monster pit (%s)", pit_info[pit_idx].name);
+	note_room(c, CAVE_ROOM_PIT, pit_idx);
 
 	/* Sort the entries XXX XXX XXX */
 	for (i = 0; i < 16 - 1; i++) {
@@ -1892,14 +1910,146 @@ static bool build_pit(struct cave *c, int y0, int x0)
 }
 
 /**
- * Build a room template from its string representation.
+ * Add a grid to a tile program being built up, extending the last run if
+ * it can go on the end of it.
+ */
+static void tile_add(struct tile_program *prog, int dy, int dx, int feat,
+		bool icky, char glyph, int arg)
+{
+	struct tile_op *last = prog->n_ops ? &prog->ops[prog->n_ops - 1] : NULL;
+	struct tile_op *op;
+
+	if (!glyph && last && !last->glyph && last->dy == dy &&
+			last->dx + last->len == dx && last->feat == feat &&
+			last->icky == icky && last->len < 255) {
+		last->len++;
+		return;
+	}
+
+	op = &prog->ops[prog->n_ops++];
+	op->dy = dy;
+	op->dx = dx;
+	op->len = 1;
+	op->feat = feat;
+	op->icky = icky;
+	op->glyph = glyph;
+	op->arg = arg;
+}
+
+/**
+ * Work out a vault from its text.  Everything not mentioned here is floor.
+ *
+ * '%' is part of the "door step" to the vault rather than the vault, so
+ * isn't marked icky; that way the tunneling code knows it is allowed to
+ * remove this wall.  '^' and '*' get traps and treasure as they are laid
+ * down, and the monster glyphs are kept as spots for afterwards.
  */
+struct tile_program *tile_program_vault(const char *text, int hgt, int wid)
+{
+	struct tile_program *prog = mem_zalloc(sizeof(*prog));
+	const char *t;
+	int dx, dy;
+
+	prog->ops = mem_zalloc(hgt * wid * sizeof(*prog->ops));
+	prog->spots = mem_zalloc(hgt * wid * sizeof(*prog->spots));
+
+	for (t = text, dy = 0; t && dy < hgt && *t; dy++) {
+		for (dx = 0; dx < wid && *t; dx++, t++) {
+			int feat = FEAT_FLOOR;
+			bool icky = TRUE;
+			char glyph = 0;
+
+			switch (*t) {
+				case ' ': continue;
+				case '%': feat = FEAT_WALL_OUTER; icky = FALSE; break;
+				case '#': feat = FEAT_WALL_INNER; break;
+				case 'X': feat = FEAT_PERM_INNER; break;
+				case '+': feat = FEAT_SECRET; break;
+				case '^':
+				case '*': glyph = *t; break;
+				case '&':
+				case '@':
+				case '9':
+				case '8':
+				case ',': {
+					struct tile_op *spot = &prog->spots[prog->n_spots++];
+					spot->dy = dy;
+					spot->dx = dx;
+					spot->len = 1;
+					spot->glyph = *t;
+					break;
+				}
+			}
+
+			tile_add(prog, dy, dx, feat, icky, glyph, 0);
+		}
+	}
 
+	return prog;
+}
 
-static void build_room_template(struct cave *c, int y0, int x0, int ymax, int xmax, int doors, const char *data, int tval)
+/**
+ * Work out a room template from its text.  Everything not mentioned here
+ * is floor; the glyphs which depend on chance are left to placement.
+ */
+struct tile_program *tile_program_room(const char *text, int hgt, int wid)
 {
-	int dx, dy, x, y, rnddoors, doorpos, info;
+	struct tile_program *prog = mem_zalloc(sizeof(*prog));
 	const char *t;
+	int dx, dy;
+
+	prog->ops = mem_zalloc(hgt * wid * sizeof(*prog->ops));
+
+	for (t = text, dy = 0; t && dy < hgt && *t; dy++) {
+		for (dx = 0; dx < wid && *t; dx++, t++) {
+			int feat = FEAT_FLOOR;
+			char glyph = 0;
+			int arg = 0;
+
+			switch (*t) {
+				case ' ': continue;
+				case '%': feat = FEAT_WALL_OUTER; break;
+				case '#': feat = FEAT_WALL_SOLID; break;
+				case '+': feat = FEAT_SECRET; break;
+				case 'x':
+				case '=':
+				case '~':
+				case '!':
+				case '*': glyph = *t; break;
+				case '1':
+				case '2':
+				case '3':
+				case '4':
+				case '5':
+				case '6':
+				case '7':
+				case '8':
+				case '9': glyph = *t; arg = atoi(t); break;
+			}
+
+			tile_add(prog, dy, dx, feat, FALSE, glyph, arg);
+		}
+	}
+
+	return prog;
+}
+
+void tile_program_free(struct tile_program *prog)
+{
+	if (!prog) return;
+
+	mem_free(prog->ops);
+	mem_free(prog->spots);
+	mem_free(prog);
+}
+
+
+/**
+ * Build a room template from its compiled representation.
+ */
+static void build_room_template(struct cave *c, int y0, int x0, int ymax, int xmax, int doors, const struct tile_program *prog, int tval)
+{
+	int i, j, x, y, rnddoors, info;
 	bool rndwalls, light;
 
 	assert(c);
@@ -1918,111 +2068,100 @@ static void build_room_template(struct cave *c, int y0, int x0, int ymax, int xm
 	rndwalls = one_in_(2) ? TRUE : FALSE;
 
 	/* Place dungeon features and objects */
-	for (t = data, dy = 0; dy < ymax && *t; dy++) {
-		for (dx = 0; dx < xmax && *t; dx++, t++) {
-			/* Extract the location */
-			x = x0 - (xmax / 2) + dx;
-			y = y0 - (ymax / 2) + dy;
-
-			/* Skip non-grids */
-			if (*t == ' ') continue;
-
-			/* Lay down a floor */
-			cave_set_feat(c, y, x, FEAT_FLOOR);
-
-			/* Debugging assertion */
-			assert(cave_isempty(c, y, x));
+	for (i = 0; i < prog->n_ops; i++) {
+		const struct tile_op *op = &prog->ops[i];
 
-			/* Analyze the grid */
-			switch (*t) {
-				case '%': cave_set_feat(c, y, x, FEAT_WALL_OUTER); break;
-				case '#': cave_set_feat(c, y, x, FEAT_WALL_SOLID); break;
-				case '+': place_secret_door(c, y, x); break;
-				case 'x': {
+		/* Extract the location */
+		x = x0 - (xmax / 2) + op->dx;
+		y = y0 - (ymax / 2) + op->dy;
 
-					/* If optional walls are generated, put a wall in this square */
+		/* Lay down the features */
+		cave_set_feat_run(c, y, x, op->len, op->feat);
 
-					if (rndwalls)
-						cave_set_feat(c, y, x, FEAT_WALL_SOLID);
-					break;
-				}
-				case '=': {
+		/* Analyze the grid */
+		switch (op->glyph) {
+			case 'x': {
 
-					/* If optional walls are generated, put a door in this square */
+				/* If optional walls are generated, put a wall in this square */
 
-					if (rndwalls)
-						place_secret_door(c, y, x);
-					break;
-				}
-				case '~': {
+				if (rndwalls)
+					cave_set_feat(c, y, x, FEAT_WALL_SOLID);
+				break;
+			}
+			case '=': {
 
-					/* Put something nice in this square
-					 * Object (80%) or Stairs (20%) */
-					if (randint0(100) < 80)
-						place_object(c, y, x, c->depth, FALSE, FALSE, ORIGIN_SPECIAL, 0);
-					else
-						place_random_stairs(c, y, x);
+				/* If optional walls are generated, put a door in this square */
 
-					/* Some monsters to guard it */
-					vault_monsters(c, y, x, c->depth + 2, randint0(2) + 3);
+				if (rndwalls)
+					place_secret_door(c, y, x);
+				break;
+			}
+			case '~': {
 
-					/* And some traps too */
-					vault_traps(c, y, x, 4, 4, randint0(3) + 2);
+				/* Put something nice in this square
+				 * Object (80%) or Stairs (20%) */
+				if (randint0(100) < 80)
+					place_object(c, y, x, c->depth, FALSE, FALSE, ORIGIN_SPECIAL, 0);
+				else
+					place_random_stairs(c, y, x);
 
-					break;
-				}
-				case '!': {
+				/* Some monsters to guard it */
+				vault_monsters(c, y, x, c->depth + 2, randint0(2) + 3);
 
-					/* Create some interesting stuff nearby */
+				/* And some traps too */
+				vault_traps(c, y, x, 4, 4, randint0(3) + 2);
 
-					/* A few monsters */
-					vault_monsters(c, y - 3, x - 3, c->depth + randint0(2), randint1(2));
-					vault_monsters(c, y + 3, x + 3, c->depth + randint0(2), randint1(2));
+				break;
+			}
+			case '!': {
 
-					/* And maybe a bit of treasure */
+				/* Create some interesting stuff nearby */
 
-					if (one_in_(2))
-						vault_objects(c, y - 2, x + 2, c->depth, 1 + randint0(2));
+				/* A few monsters */
+				vault_monsters(c, y - 3, x - 3, c->depth + randint0(2), randint1(2));
+				vault_monsters(c, y + 3, x + 3, c->depth + randint0(2), randint1(2));
 
-					if (one_in_(2))
-						vault_objects(c, y + 2, x - 2, c->depth, 1 + randint0(2));
+				/* And maybe a bit of treasure */
 
-					break;
+				if (one_in_(2))
+					vault_objects(c, y - 2, x + 2, c->depth, 1 + randint0(2));
 
-				}
-				case '*': {
-				
-					/* Place an object of the template's specified tval */
-					place_object(c, y, x, c->depth, FALSE, FALSE, ORIGIN_SPECIAL, tval);
-					break;
-				}
-				case '1':
-				case '2':
-				case '3':
-				case '4':
-				case '5':
-				case '6':
-				case '7':
-				case '8':
-				case '9': {
-
-					/* Check if this is chosen random door position */
+				if (one_in_(2))
+					vault_objects(c, y + 2, x - 2, c->depth, 1 + randint0(2));
 
-					doorpos = atoi(t);
+				break;
 
-					if (doorpos == rnddoors)
-						place_secret_door(c, y, x);
-					else
-						cave_set_feat(c, y, x, FEAT_WALL_SOLID);
+			}
+			case '*': {
+			
+				/* Place an object of the template's specified tval */
+				place_object(c, y, x, c->depth, FALSE, FALSE, ORIGIN_SPECIAL, tval);
+				break;
+			}
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9': {
+
+				/* Check if this is chosen random door position */
+
+				if (op->arg == rnddoors)
+					place_secret_door(c, y, x);
+				else
+					cave_set_feat(c, y, x, FEAT_WALL_SOLID);
 
-					break;
-				}
+				break;
 			}
+		}
 
 		/* Part of a room */
-		c->info[y][x] |= info;
-
-		}
+		for (j = 0; j < op->len; j++)
+			c->info[y][x + j] |= info;
 	}
 }
 
@@ -2041,7 +2180,7 @@ static bool build_room_template_type(struct cave*c, int y0, int x0, int typ, con
 	ROOM_LOG("Room template (%s)", t_ptr->name);
 
 	/* Build the room */
-	build_room_template(c, y0, x0, t_ptr->hgt, t_ptr->wid, t_ptr->dor, t_ptr->text, t_ptr->tval);
+	build_room_template(c, y0, x0, t_ptr->hgt, t_ptr->wid, t_ptr->dor, t_ptr->prog, t_ptr->tval);
 
 	return TRUE;
 }
@@ -2056,117 +2195,91 @@ static bool build_template(struct cave *c, int y0, int x0)
 
 
 /**
- * Build a vault from its string representation.
+ * Build a vault from its compiled representation.
  */
-static void build_vault(struct cave *c, int y0, int x0, int ymax, int xmax, const char *data)
+static void build_vault(struct cave *c, int y0, int x0, int ymax, int xmax, const struct tile_program *prog)
 {
-	int dx, dy, x, y;
-	const char *t;
-	bool icky;
+	int i, j, x, y;
 
 	assert(c);
 
 	/* Place dungeon features and objects */
-	for (t = data, dy = 0; dy < ymax && *t; dy++) {
-		for (dx = 0; dx < xmax && *t; dx++, t++) {
-			/* Extract the location */
-			x = x0 - (xmax / 2) + dx;
-			y = y0 - (ymax / 2) + dy;
+	for (i = 0; i < prog->n_ops; i++) {
+		const struct tile_op *op = &prog->ops[i];
 
-			/* Skip non-grids */
-			if (*t == ' ') continue;
-
-			/* Lay down a floor */
-			cave_set_feat(c, y, x, FEAT_FLOOR);
-
-			/* Debugging assertion */
-			assert(cave_isempty(c, y, x));
-
-			/* By default vault squares are marked icky */
-			icky = TRUE;
-
-			/* Analyze the grid */
-			switch (*t) {
-				case '%': {
-					/* In this case, the square isn't really part of the
-					 * vault, but rather is part of the "door step" to the
-					 * vault. We don't mark it icky so that the tunneling
-					 * code knows its allowed to remove this wall. */
-					cave_set_feat(c, y, x, FEAT_WALL_OUTER);
-					icky = FALSE;
-					break;
-				}
-				case '#': cave_set_feat(c, y, x, FEAT_WALL_INNER); break;
-				case 'X': cave_set_feat(c, y, x, FEAT_PERM_INNER); break;
-				case '+': place_secret_door(c, y, x); break;
-				case '^': {
-					if (randint0(100) < 25)
-						/* Place a deep trap */
-						pick_and_place_trap(c, y, x, c->depth + 10); 
-					break;
-				}
-				case '*': {
-					/* Treasure or a trap */
-					if (randint0(100) < 75)
-						place_object(c, y, x, c->depth, FALSE, FALSE, ORIGIN_VAULT, 0);
-					else
-						pick_and_place_trap(c, y, x, c->depth + 5);
-					break;
-				}
+		/* Extract the location */
+		x = x0 - (xmax / 2) + op->dx;
+		y = y0 - (ymax / 2) + op->dy;
+
+		/* Lay down the features */
+		cave_set_feat_run(c, y, x, op->len, op->feat);
+
+		/* Analyze the grid */
+		switch (op->glyph) {
+			case '^': {
+				if (randint0(100) < 25)
+					/* Place a deep trap */
+					pick_and_place_trap(c, y, x, c->depth + 10); 
+				break;
+			}
+			case '*': {
+				/* Treasure or a trap */
+				if (randint0(100) < 75)
+					place_object(c, y, x, c->depth, FALSE, FALSE, ORIGIN_VAULT, 0);
+				else
+					pick_and_place_trap(c, y, x, c->depth + 5);
+				break;
 			}
-
-			/* Part of a vault */
-			c->info[y][x] |= CAVE_ROOM;
-			if (icky) c->info[y][x] |= CAVE_ICKY;
 		}
+
+		/* Part of a vault */
+		for (j = 0; j < op->len; j++)
+			c->info[y][x + j] |= CAVE_ROOM | (op->icky ? CAVE_ICKY : 0);
 	}
 
 
 	/* Place dungeon monsters and objects */
-	for (t = data, dy = 0; dy < ymax && *t; dy++) {
-		for (dx = 0; dx < xmax && *t; dx++, t++) {
-			/* Extract the grid */
-			x = x0 - (xmax / 2) + dx;
-			y = y0 - (ymax / 2) + dy;
-
-			/* Hack -- skip "non-grids" */
-			if (*t == ' ') continue;
+	for (i = 0; i < prog->n_spots; i++) {
+		const struct tile_op *spot = &prog->spots[i];
+
+		/* Extract the grid */
+		x = x0 - (xmax / 2) + spot->dx;
+		y = y0 - (ymax / 2) + spot->dy;
+
+		/* Analyze the symbol */
+		switch (spot->glyph) {
+			case '&': pick_and_place_monster(c, y, x, c->depth + 5, TRUE, TRUE,
+				ORIGIN_DROP_VAULT); break;
+			case '@': pick_and_place_monster(c, y, x, c->depth + 11, TRUE, TRUE,
+				ORIGIN_DROP_VAULT); break;
+
+			case '9': {
+				/* Meaner monster, plus treasure */
+				pick_and_place_monster(c, y, x, c->depth + 9, TRUE, TRUE,
+					ORIGIN_DROP_VAULT);
+				place_object(c, y, x, c->depth + 7, TRUE, FALSE,
+					ORIGIN_VAULT, 0);
+				break;
+			}
 
-			/* Analyze the symbol */
-			switch (*t) {
-				case '&': pick_and_place_monster(c, y, x, c->depth + 5, TRUE, TRUE,
-					ORIGIN_DROP_VAULT); break;
-				case '@': pick_and_place_monster(c, y, x, c->depth + 11, TRUE, TRUE,
-					ORIGIN_DROP_VAULT); break;
-
-				case '9': {
-					/* Meaner monster, plus treasure */
-					pick_and_place_monster(c, y, x, c->depth + 9, TRUE, TRUE,
-						ORIGIN_DROP_VAULT);
-					place_object(c, y, x, c->depth + 7, TRUE, FALSE,
-						ORIGIN_VAULT, 0);
-					break;
-				}
+			case '8': {
+				/* Nasty monster and treasure */
+				pick_and_place_monster(c, y, x, c->depth + 40, TRUE, TRUE,
+					ORIGIN_DROP_VAULT);
+				place_object(c, y, x, c->depth + 20, TRUE, TRUE,
+					ORIGIN_VAULT, 0);
+				break;
+			}
 
-				case '8': {
-					/* Nasty monster and treasure */
-					pick_and_place_monster(c, y, x, c->depth + 40, TRUE, TRUE,
+			case ',': {
+				/* Monster and/or object */
+				if (randint0(100) < 50)
+					pick_and_place_monster(c, y, x, c->depth + 3, TRUE, TRUE,
 						ORIGIN_DROP_VAULT);
-					place_object(c, y, x, c->depth + 20, TRUE, TRUE,
+				if (randint0(100) < 50)
+					place_object(c, y, x, c->depth + 7, FALSE, FALSE,
 						ORIGIN_VAULT, 0);
-					break;
-				}
-
-				case ',': {
-					/* Monster and/or object */
-					if (randint0(100) < 50)
-						pick_and_place_monster(c, y, x, c->depth + 3, TRUE, TRUE,
-							ORIGIN_DROP_VAULT);
-					if (randint0(100) < 50)
-						place_object(c, y, x, c->depth + 7, FALSE, FALSE,
-							ORIGIN_VAULT, 0);
-					break;
-				}
+				break;
 			}
 		}
 	}
@@ -2190,7 +2303,8 @@ static bool build_vault_type(struct cave*c, int y0, int x0, int typ, const char
 	c->mon_rating += v_ptr->rat;
 
 	/* Build the vault */
-	build_vault(c, y0, x0, v_ptr->hgt, v_ptr->wid, v_ptr->text);
+	build_vault(c, y0, x0, v_ptr->hgt, v_ptr->wid, v_ptr->prog);
+	note_room(c, CAVE_ROOM_VAULT, v_ptr->vidx);
 
 	return TRUE;
 }
@@ -2592,8 +2706,7 @@ static void set_cave_dimensions(struct cave *c, int h, int w)
 	int i, n = h * w;
 	c->height = h;
 	c->width = w;
-	if (cave_squares != NULL) FREE(cave_squares);
-	cave_squares = C_ZNEW(n, int);
+	cave_squares = cave_level_alloc(c, n * sizeof(int));
 	for (i = 0; i < n; i++) cave_squares[i] = i;
 }
 
@@ -2925,9 +3038,9 @@ static bool labyrinth_gen(struct cave *c, struct player *p) {
 	 * labyrinth cave profile. */
 	if (randint0(100) >= chance) return FALSE;
 
-	/* allocate our arrays */
-	sets = C_ZNEW(n, int);
-	walls = C_ZNEW(n, int);
+	/* allocate our arrays (they go when the level does) */
+	sets = cave_level_alloc(c, n * sizeof(int));
+	walls = cave_level_alloc(c, n * sizeof(int));
 
 	/* This is the dungeon size, which does include the enclosing walls */
 	set_cave_dimensions(c, h + 2, w + 2);
@@ -3047,10 +3160,6 @@ static bool labyrinth_gen(struct cave *c, struct player *p) {
 	/* If we want the players to see the maze layout, do that now */
 	if (known) wiz_light(FALSE);
 
-	/* Deallocate our lists */
-	FREE(sets);
-	FREE(walls);
-
 	return TRUE;
 }
 
@@ -3107,7 +3216,8 @@ static void mutate_cavern(struct cave *c) {
 	int h = c->height;
 	int w = c->width;
 
-	int *temp = C_ZNEW(h * w, int);
+	struct mem_arena_mark mark = mem_arena_mark(c->arena);
+	int *temp = cave_level_alloc(c, h * w * sizeof(int));
 
 	for (y = 1; y < h - 1; y++) {
 		for (x = 1; x < w - 1; x++) {
@@ -3127,7 +3237,7 @@ static void mutate_cavern(struct cave *c) {
 		}
 	}
 
-	FREE(temp);
+	mem_arena_release(c->arena, mark);
 }
 
 /**
@@ -3138,6 +3248,16 @@ static void array_filler(int data[], int value, int size) {
 	for (i = 0; i < size; i++) data[i] = value;
 }
 
+/**
+ * Determine if a point can be part of a colored region.
+ */
+static bool color_pass(struct cave *c, int y, int x) {
+	if (cave_isvault(c, y, x)) return TRUE;
+	if (cave_ispassable(c, y, x)) return TRUE;
+	if (cave_isdoor(c, y, x)) return TRUE;
+	return FALSE;
+}
+
 /**
  * Determine if we need to worry about coloring a point, or can ignore it.
  */
@@ -3148,11 +3268,7 @@ static int ignore_point(struct cave *c, int colors[], int y, int x) {
 
 	if (y < 0 || x < 0 || y >= h || x >= w) return TRUE;
 	if (colors[n]) return TRUE;
-	//if (cave_isvault(c, y, x)) return TRUE;
-	if (cave_isvault(c, y, x)) return FALSE;
-	if (cave_ispassable(c, y, x)) return FALSE;
-	if (cave_isdoor(c, y, x)) return FALSE;
-	return TRUE;
+	return !color_pass(c, y, x);
 }
 
 static int xds[] = {0, 0, 1, -1, -1, -1, 1, 1};
@@ -3170,48 +3286,22 @@ static void glow_point(struct cave *c, int y, int x) {
 /**
  * Color a particular point, and all adjacent points.
  */
-static void build_color_point(struct cave *c, int colors[], int counts[], int y, int x, int color, bool diagonal) {
-	int h = c->height;
+static void build_color_point(struct cave *c, struct dist_field *f, int colors[], int counts[], int y, int x, int color) {
 	int w = c->width;
-	int size = h * w;
-	struct queue *queue = q_new(size);
-
-	int dslimit = diagonal ? 8 : 4;
+	int pos = 0;
 
-	int *added = C_ZNEW(size, int);
-	array_filler(added, 0, size);
-
-	q_push_int(queue, lab_toi(y, x, w));
+	dist_field_reset(f);
+	dist_field_add_source(f, y, x);
+	dist_field_run(f, 0);
 
 	counts[color] = 0;
 
-	while (q_len(queue) > 0) {
-		int i, y2, x2;
-		int n2 = q_pop_int(queue);
-
-		lab_toyx(n2, w, &y2, &x2);
-
-		if (ignore_point(cave, colors, y2, x2)) continue;
-
-		colors[n2] = color;
+	while (dist_field_next(f, &pos, &y, &x)) {
+		colors[lab_toi(y, x, w)] = color;
 		counts[color]++;
 
-		/*if (lit) glow_point(c, y2, x2);*/
-
-		for (i = 0; i < dslimit; i++) {
-			int y3 = y2 + yds[i];
-			int x3 = x2 + xds[i];
-			int n3 = lab_toi(y3, x3, w);
-			if (ignore_point(cave, colors, y3, x3)) continue;
-			if (added[n3]) continue;
-
-			q_push_int(queue, n3);
-			added[n3] = 1;
-		}
+		/*if (lit) glow_point(c, y, x);*/
 	}
-
-	FREE(added);
-	q_free(queue);
 }
 
 /**
@@ -3223,13 +3313,21 @@ static void build_colors(struct cave *c, int colors[], int counts[], bool diagon
 	int w = c->width;
 	int color = 1;
 
+	struct mem_arena_mark mark = mem_arena_mark(c->arena);
+	struct dist_field *f = cave_level_alloc(c, sizeof(*f));
+
+	dist_field_init(f, h, w, diagonal);
+	dist_field_fill(f, c, color_pass);
+
 	for (y = 0; y < h; y++) {
 		for (x = 0; x < w; x++) {
-			if (ignore_point(cave, colors, y, x)) continue;
-			build_color_point(cave, colors, counts, y, x, color, diagonal);
+			if (ignore_point(c, colors, y, x)) continue;
+			build_color_point(c, f, colors, counts, y, x, color);
 			color++;
 		}
 	}
+
+	mem_arena_release(c->arena, mark);
 }
 
 /**
@@ -3241,7 +3339,8 @@ static void clear_small_regions(struct cave *c, int colors[], int counts[]) {
 	int w = c->width;
 	int size = h * w;
 
-	int *deleted = C_ZNEW(size, int);
+	struct mem_arena_mark mark = mem_arena_mark(c->arena);
+	int *deleted = cave_level_alloc(c, size * sizeof(int));
 	array_filler(deleted, 0, size);
 
 	for (i = 0; i < size; i++) {
@@ -3261,7 +3360,7 @@ static void clear_small_regions(struct cave *c, int colors[], int counts[]) {
 			cave_set_feat(c, y, x, FEAT_WALL_SOLID);
 		}
 	}
-	FREE(deleted);
+	mem_arena_release(c->arena, mark);
 }
 
 /**
@@ -3295,82 +3394,61 @@ static void fix_colors(int colors[], int counts[], int from, int to, int size) {
 
 /**
  * Create a tunnel connecting a region to one of its nearest neighbors.
+ *
+ * The field lets every square be entered, so the tunnel can go through
+ * stone.
  */
-static void join_region(struct cave *c, int colors[], int counts[], int color) {
+static void join_region(struct cave *c, struct dist_field *f, int colors[], int counts[], int color) {
 	int i;
 	int h = c->height;
 	int w = c->width;
 	int size = h * w;
+	int n = -1, color2, d;
+	int y, x;
 
-	/* Allocate a processing queue */
-	struct queue *queue = q_new(size);
-
-	/* Allocate an array to keep track of handled squares, and which square
-	 * we reached them from.
-	 */
-	int *previous = C_ZNEW(size, int);
-	array_filler(previous, -1, size);
-
-	/* Push all squares of the given color onto the queue */
+	/* Start from all squares of the given color */
+	dist_field_reset(f);
 	for (i = 0; i < size; i++) {
-		if (colors[i] == color) {
-			q_push_int(queue, i);
-			previous[i] = i;
-		}
+		if (colors[i] != color) continue;
+		lab_toyx(i, w, &y, &x);
+		dist_field_add_source(f, y, x);
 	}
 
-	/* Process all squares into the queue */
-	while (q_len(queue) > 0) {
-		/* Get the current square and its color */
-		int n = q_pop_int(queue);
-		int color2 = colors[n];
-
-		/* See if we've reached a square with a new color */
-		if (color2 && color2 != color) {
-			/* Step backward through the path, turning stone to tunnel */
-			while (colors[n] != color) {
-				int x, y;
-				lab_toyx(n, w, &y, &x);
-				colors[n] = color;
-				if (!cave_isperm(c, y, x) && !cave_isvault(c, y, x)) {
-					cave_set_feat(c, y, x, FEAT_FLOOR);
-				}
-				n = previous[n];
+	/* Step outwards until we reach a square with a new color */
+	while (n < 0 && dist_field_step(f)) {
+		int pos = 0;
+
+		while (dist_field_next_front(f, &pos, &y, &x)) {
+			color2 = colors[lab_toi(y, x, w)];
+			if (color2 && color2 != color) {
+				n = lab_toi(y, x, w);
+				break;
 			}
+		}
+	}
 
-			/* Update the color mapping to combine the two colors */
-			fix_colors(colors, counts, color2, color, size);
+	if (n < 0) return;
+	color2 = colors[n];
 
-			/* We're done now */
-			break;
+	/* Step backward through the path, turning stone to tunnel */
+	while (colors[n] != color) {
+		colors[n] = color;
+		if (!cave_isperm(c, y, x) && !cave_isvault(c, y, x)) {
+			cave_set_feat(c, y, x, FEAT_FLOOR);
 		}
 
-		/* If we haven't reached a new color, add all the unprocessed adjacent
-		 * squares to our queue.
-		 */
-		for (i = 0; i < 4; i++) {
-			int y, x, n2;
-			lab_toyx(n, w, &y, &x);
-
-			/* Move to the adjacent square */
-			y += yds[i];
-			x += xds[i];
-
-			/* make sure we stay inside the boundaries */
-			if (y < 0 || y >= h) continue;
-			if (x < 0 || x >= w) continue;
-
-			/* If the cell hasn't already been procssed, add it to the queue */
-			n2 = lab_toi(y, x, w);
-			if (previous[n2] >= 0) continue;
-			q_push_int(queue, n2);
-			previous[n2] = n;
-		}
+		/* Move to an adjacent square one step nearer the start */
+		d = dist_field_get(f, y, x);
+		for (i = 0; i < 4; i++)
+			if (dist_field_get(f, y + yds[i], x + xds[i]) == d - 1) break;
+
+		y += yds[i];
+		x += xds[i];
+		n = lab_toi(y, x, w);
 	}
 
-	/* Free the memory we've allocated */
-	q_free(queue);
-	FREE(previous);
+	/* Update the color mapping to combine the two colors */
+	fix_colors(colors, counts, color2, color, size);
 }
 
 
@@ -3383,14 +3461,22 @@ static void join_regions(struct cave *c, int colors[], int counts[]) {
 	int size = h * w;
 	int num = count_colors(counts, size);
 
+	struct mem_arena_mark mark = mem_arena_mark(c->arena);
+	struct dist_field *f = cave_level_alloc(c, sizeof(*f));
+
+	dist_field_init(f, h, w, FALSE);
+	dist_field_fill(f, c, NULL);
+
 	/* While we have multiple colors (i.e. disconnected regions), join one of
 	 * the regions to another one.
 	 */
 	while (num > 1) {
 		int color = first_color(counts, size);
-		join_region(c, colors, counts, color);
+		join_region(c, f, colors, counts, color);
 		num--;
 	}
+
+	mem_arena_release(c->arena, mark);
 }
 
 
@@ -3417,14 +3503,14 @@ static int open_count(struct cave *c) {
  */
 void ensure_connectedness(struct cave *c) {
 	int size = c->height * c->width;
-	int *colors = C_ZNEW(size, int);
-	int *counts = C_ZNEW(size, int);
+	struct mem_arena_mark mark = mem_arena_mark(c->arena);
+	int *colors = cave_level_alloc(c, size * sizeof(int));
+	int *counts = cave_level_alloc(c, size * sizeof(int));
 
 	build_colors(c, colors, counts, TRUE);
 	join_regions(c, colors, counts);
 
-	FREE(colors);
-	FREE(counts);
+	mem_arena_release(c->arena, mark);
 }
 
 
@@ -3443,8 +3529,9 @@ bool cavern_gen(struct cave *c, struct player *p) {
 	int density = rand_range(25, 40);
 	int times = rand_range(3, 6);
 
-	int *colors = C_ZNEW(size, int);
-	int *counts = C_ZNEW(size, int);
+	/* These go when the level does, as cave_squares is allocated after */
+	int *colors = cave_level_alloc(c, size * sizeof(int));
+	int *counts = cave_level_alloc(c, size * sizeof(int));
 
 	int tries = 0;
 
@@ -3519,9 +3606,6 @@ bool cavern_gen(struct cave *c, struct player *p) {
 			ORIGIN_CAVERN);
 	}
 
-	FREE(colors);
-	FREE(counts);
-
 	return ok;
 }
 
@@ -3659,34 +3743,30 @@ static bool town_gen(struct cave *c, struct player *p) {
  * Clear the dungeon, ready for generation to begin.
  */
 static void cave_clear(struct cave *c, struct player *p) {
-	int x, y;
-
 	wipe_o_list(c);
 	wipe_mon_list(c, p);
 	wipe_trap_list(c);
 
-	/* Clear flags and flow information. */
-	for (y = 0; y < DUNGEON_HGT; y++) {
-		for (x = 0; x < DUNGEON_WID; x++) {
-			/* Erase features and traps */
-			c->feat[y][x] = 0;
-			c->trap[y][x] = 0;
-
-			/* Erase flags */
-			c->info[y][x] = 0;
-			c->info2[y][x] = 0;
-
-			/* Erase flow */
-			c->cost[y][x] = 0;
-			c->when[y][x] = 0;
-
-			/* Erase monsters/player */
-			c->m_idx[y][x] = 0;
+	/* Take back everything allocated for the old level */
+	cave_level_free(c);
+	c->rooms = NULL;
+
+	/*
+	 * Erase flags, flow and monsters/player.  The list wipes above have
+	 * already taken the objects and traps off the map, and every builder
+	 * fills the whole map with rock before it does anything else, so those
+	 * planes are left alone.  The monster plane isn't, as the player's
+	 * mark can outlive p->py/p->px (e.g. when a new character is started
+	 * in the same process).
+	 */
+	C_WIPE(c->info, DUNGEON_HGT, byte_256);
+	C_WIPE(c->info2, DUNGEON_HGT, byte_256);
+	C_WIPE(c->cost, DUNGEON_HGT, byte_wid);
+	C_WIPE(c->when, DUNGEON_HGT, byte_wid);
+	C_WIPE(c->m_idx, DUNGEON_HGT, s16b_wid);
 
-			/* Erase items */
-			c->o_idx[y][x] = 0;
-		}
-	}
+	/* Anything cached about the old map is now wrong */
+	cave_map_changed_all(c);
 
 	/* Unset the player's coordinates */
 	p->px = p->py = 0;
@@ -3887,7 +3967,7 @@ void cave_generate(struct cave *c, struct player *p) {
 		if (error) ROOM_LOG("Generation restarted: %s.", error);
 	}
 
-	FREE(cave_squares);
+	/* cave_squares goes with the level's other allocations */
 	cave_squares = NULL;
 
 	if (error) quit_fmt("cave_generate() failed 100 times!");
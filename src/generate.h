@@ -15,6 +15,36 @@ void place_random_door(struct cave *c, int y, int x);
 extern struct room_template *random_room_template(int typ);
 extern struct vault *random_vault(int typ);
 
+/**
+ * One step in laying down a vault or room template: a run of grids along a
+ * row which all get the same feature, or a single grid which needs more
+ * done to it than that.
+ */
+struct tile_op {
+	byte dy, dx;	/* Offset from the top left corner */
+	byte len;	/* Number of grids along the row */
+	byte feat;	/* Feature to lay down */
+	bool icky;	/* Whether the grids are part of a vault proper */
+	char glyph;	/* What else to do to a single grid, or 0 */
+	int arg;	/* Door number, for room template digits */
+};
+
+/**
+ * A vault or room template, worked out from its text once at startup.
+ * The ops are carried out in order; the spots (monsters and objects for
+ * vaults) are placed afterwards.
+ */
+struct tile_program {
+	int n_ops;
+	struct tile_op *ops;
+	int n_spots;
+	struct tile_op *spots;
+};
+
+struct tile_program *tile_program_vault(const char *text, int hgt, int wid);
+struct tile_program *tile_program_room(const char *text, int hgt, int wid);
+void tile_program_free(struct tile_program *prog);
+
 struct tunnel_profile {
 	const char *name;
     int rnd; /* % chance of choosing random direction */
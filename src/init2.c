@@ -21,16 +21,19 @@
 #include "button.h"
 #include "cave.h"
 #include "cmds.h"
+#include "derived.h"
 #include "game-event.h"
 #include "generate.h"
 #include "history.h"
 #include "keymap.h"
 #include "init.h"
 #include "monster/init.h"
+#include "monster/mon-lore.h"
 #include "monster/mon-msg.h"
 #include "monster/mon-util.h"
 #include "object/slays.h"
 #include "object/tvalsval.h"
+#include "observe.h"
 #include "option.h"
 #include "parser.h"
 #include "prefs.h"
@@ -1769,6 +1772,7 @@ static void cleanup_e(void)
 	}
 	mem_free(e_info);
 	free_slay_cache();
+	free_power_cache();
 }
 
 struct file_parser e_parser = {
@@ -2450,8 +2454,13 @@ static errr run_parse_v(struct parser *p) {
 }
 
 static errr finish_parse_v(struct parser *p) {
+	struct vault *v;
+
 	vaults = parser_priv(p);
 	parser_destroy(p);
+
+	for (v = vaults; v; v = v->next)
+		v->prog = tile_program_vault(v->text, v->hgt, v->wid);
 	return 0;
 }
 
@@ -2460,6 +2469,7 @@ static void cleanup_v(void)
 	struct vault *v, *next;
 	for (v = vaults; v; v = next) {
 		next = v->next;
+		tile_program_free(v->prog);
 		mem_free(v->name);
 		mem_free(v->text);
 		mem_free(v);
@@ -2525,8 +2535,13 @@ static errr run_parse_room(struct parser *p) {
 }
 
 static errr finish_parse_room(struct parser *p) {
+	struct room_template *t;
+
 	room_templates = parser_priv(p);
 	parser_destroy(p);
+
+	for (t = room_templates; t; t = t->next)
+		t->prog = tile_program_room(t->text, t->hgt, t->wid);
 	return 0;
 }
 
@@ -2535,6 +2550,7 @@ static void cleanup_room(void)
 	struct room_template *t, *next;
 	for (t = room_templates; t; t = next) {
 		next = t->next;
+		tile_program_free(t->prog);
 		mem_free(t->name);
 		mem_free(t->text);
 		mem_free(t);
@@ -3682,7 +3698,9 @@ void cleanup_angband(void)
 
 	/* Free the lore, monster, and object lists */
 	FREE(l_list);
+	free_lore_cache();
 	objects_destroy();
+	free_obj_info();
 
 	/* Free the temp array */
 	FREE(temp_g);
@@ -3693,15 +3711,24 @@ void cleanup_angband(void)
 	FREE(mon_msg);
 	FREE(mon_message_hist);
 
+	/* Free the visible monster list */
+	monlist_free();
+
 	/* Free the messages */
 	messages_free();
 
+	/* Free any messages queued for automated players */
+	observe_cleanup();
+
 	/* Free the history */
 	history_clear();
 
 	/* Free the "quarks" */
 	quarks_free();
 
+	/* Free the compiled squelch rules */
+	squelch_cleanup();
+
 	cleanup_parser(&k_parser);
 	cleanup_parser(&kb_parser);
 	cleanup_parser(&a_parser);
@@ -3723,9 +3750,22 @@ void cleanup_angband(void)
 	cleanup_parser(&pit_parser);
 	cleanup_parser(&z_parser);
 
+	/* Write out any derived tables which have changed */
+	derived_save();
+
 	/* Free the format() buffer */
 	vformat_kill();
 
+#ifdef MEM_PROFILE
+	/* Anything still live now has been leaked or is about to be freed */
+	if (ANGBAND_DIR_USER) {
+		char buf[1024];
+
+		path_build(buf, sizeof(buf), ANGBAND_DIR_USER, "memprof.csv");
+		mem_profile_dump(buf);
+	}
+#endif
+
 	/* Free the directories */
 	string_free(ANGBAND_DIR_APEX);
 	string_free(ANGBAND_DIR_EDIT);
@@ -1517,6 +1517,7 @@ int rd_object_memory(void)
 		if (tmp8u & 0x04) kind_squelch_when_aware(k_ptr);
 		if (tmp8u & 0x10) kind_squelch_when_unaware(k_ptr);
 	}
+	object_knowledge_changed();
 	
 	return 0;
 }
@@ -2002,7 +2003,7 @@ int rd_misc(void)
 	byte tmp8u;
 
 	/* Read the randart version */
-	strip_bytes(4);
+	rd_u32b(&randart_version);
 
 	/* Read the randart seed */
 	rd_u32b(&seed_randart);
@@ -2044,7 +2045,7 @@ int rd_misc_2(void)
 	u16b tmp16u;
 	
 	/* Read the randart version */
-	strip_bytes(4);
+	rd_u32b(&randart_version);
 
 	/* Read the randart seed */
 	rd_u32b(&seed_randart);
@@ -2829,6 +2830,8 @@ static int rd_objects(rd_item_t rd_item_version)
 
 			/* Link the floor to the object */
 			cave->o_idx[y][x] = o_idx;
+
+			floor_object_add(o_idx);
 		}
 	}
 
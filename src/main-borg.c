@@ -0,0 +1,488 @@
+/*
+ * File: main-borg.c
+ * Purpose: Headless frontend for running batches of borg games
+ *
+ * Copyright (c) 2012 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "derived.h"
+#include "files.h"
+#include "game-cmd.h"
+#include "game-event.h"
+#include "object/slays.h"
+
+#if defined(USE_BORG_RUNNER) && defined(ALLOW_BORG)
+
+#include <signal.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+/*
+ * The parent process forks one worker per game, running at most `num_jobs`
+ * of them at once.  Each worker plays an ordinary game with the borg at the
+ * keyboard, starting from a fixed seed, and when the borg stops (usually
+ * because the character died) it writes a borg_result down a pipe and
+ * exits.  The parent collects the results and prints a summary.
+ *
+ * The game itself has no idea any of this is going on; the worker just
+ * answers the few prompts the borg can't (the splash screen and character
+ * birth) and then presses ^Z z.
+ */
+
+static int num_games = 1;
+static int num_jobs = 1;
+static u32b base_seed = 1;
+static int time_limit = 0;
+
+/* What a worker reports back about its game */
+struct borg_result {
+	u32b seed;
+	char race[32];
+	char class[32];
+	s16b max_lev;
+	s16b max_depth;
+	s32b turns;
+	char cause[80];
+};
+
+/* A running worker, as seen by the parent */
+struct borg_worker {
+	pid_t pid;
+	int fd;
+	struct timeval start;
+	int game;
+};
+
+
+/*** Worker side ***/
+
+/* This worker's seed and where its result goes */
+static u32b worker_seed;
+static int worker_fd = -1;
+
+/* How far the worker has got through setting up the game */
+static enum {
+	WORKER_STARTING,
+	WORKER_PLAYING,
+	WORKER_DONE
+} worker_state = WORKER_STARTING;
+
+/*
+ * Send this game's result to the parent and stop.
+ */
+static void worker_finish(const char *cause)
+{
+	struct borg_result res;
+
+	memset(&res, 0, sizeof(res));
+	res.seed = worker_seed;
+	if (p_ptr->race) my_strcpy(res.race, p_ptr->race->name, sizeof(res.race));
+	if (p_ptr->class) my_strcpy(res.class, p_ptr->class->name, sizeof(res.class));
+	res.max_lev = p_ptr->max_lev;
+	res.max_depth = p_ptr->max_depth;
+	res.turns = turn;
+	my_strcpy(res.cause, cause, sizeof(res.cause));
+
+	if (write(worker_fd, &res, sizeof(res)) != sizeof(res))
+		_exit(2);
+
+#ifdef MEM_PROFILE
+	/* Workers don't clean up, so write their profile out here */
+	{
+		char buf[1024];
+		char name[40];
+
+		strnfmt(name, sizeof(name), "memprof-%lu.csv",
+				(unsigned long)worker_seed);
+		path_build(buf, sizeof(buf), ANGBAND_DIR_USER, name);
+		mem_profile_dump(buf);
+	}
+#endif
+
+	/* Nobody will want to load this character */
+	file_delete(savefile);
+
+	/* Workers don't clean up either, so keep any new derived tables */
+	store_slay_cache();
+	derived_save();
+
+	_exit(0);
+}
+
+/*
+ * Nothing much is safe in a signal handler, so the time limit just sets a
+ * flag for term_xtra_borg() to act on.  If nothing has noticed it within
+ * TIMEOUT_GRACE seconds the game must be stuck, so send back what we have
+ * and stop on the spot.
+ */
+#define TIMEOUT_GRACE	10
+
+static volatile sig_atomic_t worker_timed_out;
+static struct borg_result worker_stuck;
+
+static void worker_timeout(int sig)
+{
+	if (!worker_timed_out) {
+		worker_timed_out = 1;
+		alarm(TIMEOUT_GRACE);
+		return;
+	}
+
+	if (write(worker_fd, &worker_stuck, sizeof(worker_stuck)) < 0)
+		_exit(2);
+	_exit(0);
+}
+
+/*
+ * Roll up a random character from this worker's seed, by queueing the same
+ * commands the birth screen would send.
+ */
+static void worker_birth(game_event_type type, game_event_data *data,
+		void *user)
+{
+	struct player_race *r;
+	struct player_class *c;
+	int n_races = 0, n_classes = 0;
+
+	for (r = races; r; r = r->next) n_races++;
+	for (c = classes; c; c = c->next) n_classes++;
+
+	Rand_state_init(worker_seed);
+
+	/* Reroll the seeds play_game() took from the clock */
+	seed_flavor = randint0(0x10000000);
+	seed_town = randint0(0x10000000);
+
+	cmd_insert(CMD_CHOOSE_SEX);
+	cmd_set_arg_choice(cmd_get_top(), 0, randint0(MAX_SEXES));
+	cmd_insert(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmd_get_top(), 0, randint0(n_races));
+	cmd_insert(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmd_get_top(), 0, randint0(n_classes));
+	cmd_insert(CMD_ROLL_STATS);
+	cmd_insert(CMD_ACCEPT_CHARACTER);
+}
+
+/*
+ * The game wants a key and the borg isn't supplying it.
+ */
+static void worker_wait(void)
+{
+	switch (worker_state) {
+		case WORKER_STARTING:
+		{
+			/* Get past the splash screen */
+			if (!character_generated) {
+				Term_keypress(ESCAPE, 0);
+				break;
+			}
+
+			/* Skip the "are you sure" and hand over to the borg */
+			p_ptr->noscore |= NOSCORE_BORG;
+			Term_keypress(KTRL('Z'), 0);
+			Term_keypress('z', 0);
+			worker_state = WORKER_PLAYING;
+			break;
+		}
+
+		case WORKER_PLAYING:
+		{
+			/* The borg has given up the keyboard, so this game is over */
+			worker_state = WORKER_DONE;
+			worker_finish(p_ptr->is_dead ? p_ptr->died_from : "(borg stopped)");
+			break;
+		}
+
+		case WORKER_DONE:
+			break;
+	}
+}
+
+/*
+ * Set up a freshly forked worker to play game `game`.
+ */
+static void worker_init(int game, int fd)
+{
+	worker_seed = base_seed + game;
+	worker_fd = fd;
+
+	/* Give each game its own savefile, and throw away any stale one */
+	strnfmt(op_ptr->full_name, sizeof(op_ptr->full_name), "Borg%lu",
+			(unsigned long)worker_seed);
+	process_player_name(TRUE);
+	file_delete(savefile);
+
+	event_add_handler(EVENT_ENTER_BIRTH, worker_birth, NULL);
+
+	if (time_limit) {
+		memset(&worker_stuck, 0, sizeof(worker_stuck));
+		worker_stuck.seed = worker_seed;
+		my_strcpy(worker_stuck.cause, "(time limit, stuck)",
+				sizeof(worker_stuck.cause));
+
+		signal(SIGALRM, worker_timeout);
+		alarm(time_limit);
+	}
+}
+
+
+/*** Parent side ***/
+
+static double elapsed(const struct timeval *from)
+{
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	return (now.tv_sec - from->tv_sec) +
+			(now.tv_usec - from->tv_usec) / 1000000.0;
+}
+
+/*
+ * Start game `game` in a new worker.  Returns FALSE in the parent if the
+ * worker couldn't be started, and TRUE in both the parent and the worker
+ * otherwise.
+ */
+static bool spawn_worker(struct borg_worker *w, int game, bool *is_worker)
+{
+	int fds[2];
+
+	if (pipe(fds) < 0)
+		return FALSE;
+
+	w->pid = fork();
+	if (w->pid < 0) {
+		close(fds[0]);
+		close(fds[1]);
+		return FALSE;
+	}
+
+	if (w->pid == 0) {
+		close(fds[0]);
+		*is_worker = TRUE;
+		worker_init(game, fds[1]);
+		return TRUE;
+	}
+
+	close(fds[1]);
+	w->fd = fds[0];
+	w->game = game;
+	gettimeofday(&w->start, NULL);
+	return TRUE;
+}
+
+static void print_result(int game, const struct borg_result *res,
+		double secs)
+{
+	char who[40];
+
+	strnfmt(who, sizeof(who), "%s %s", res->race, res->class);
+	printf("%5d %10lu  %-24s %3d %5d %9ld %8.1f  %s\n", game + 1,
+			(unsigned long)res->seed, who, res->max_lev, res->max_depth,
+			(long)res->turns, secs, res->cause);
+	fflush(stdout);
+}
+
+/*
+ * Run all the games, printing each result as it comes in and a summary at
+ * the end.  Only returns in the workers.
+ */
+static void run_borgs(void)
+{
+	struct borg_worker *workers = mem_zalloc(num_jobs * sizeof(*workers));
+	struct timeval start;
+	int next = 0, running = 0, finished = 0, failed = 0;
+	long total_lev = 0, total_depth = 0;
+	int best_depth = 0;
+	double secs;
+
+	printf("Running %d borg games, %d at a time, from seed %lu\n\n",
+			num_games, num_jobs, (unsigned long)base_seed);
+	printf(" Game       Seed  Character                 CL Depth     Turns  Seconds  Result\n");
+	fflush(stdout);
+
+	gettimeofday(&start, NULL);
+
+	while (next < num_games || running) {
+		struct borg_result res;
+		struct borg_worker *w = NULL;
+		int i, status;
+		pid_t pid;
+
+		/* Keep every job slot busy */
+		for (i = 0; i < num_jobs && next < num_games; i++) {
+			bool is_worker = FALSE;
+
+			if (workers[i].pid) continue;
+
+			if (!spawn_worker(&workers[i], next, &is_worker))
+				quit("Couldn't start a borg worker");
+
+			/* Workers go off and play the game */
+			if (is_worker) {
+				mem_free(workers);
+				return;
+			}
+
+			next++;
+			running++;
+		}
+
+		pid = wait(&status);
+		if (pid < 0) break;
+
+		for (i = 0; i < num_jobs; i++)
+			if (workers[i].pid == pid) w = &workers[i];
+		if (!w) continue;
+
+		secs = elapsed(&w->start);
+		if (read(w->fd, &res, sizeof(res)) != sizeof(res)) {
+			memset(&res, 0, sizeof(res));
+			res.seed = base_seed + w->game;
+			if (WIFSIGNALED(status))
+				strnfmt(res.cause, sizeof(res.cause),
+						"(crashed, signal %d)", WTERMSIG(status));
+			else
+				strnfmt(res.cause, sizeof(res.cause),
+						"(crashed, status %d)", WEXITSTATUS(status));
+			failed++;
+		}
+
+		print_result(w->game, &res, secs);
+
+		total_lev += res.max_lev;
+		total_depth += res.max_depth;
+		if (res.max_depth > best_depth) best_depth = res.max_depth;
+
+		close(w->fd);
+		w->pid = 0;
+		running--;
+		finished++;
+	}
+
+	secs = elapsed(&start);
+
+	printf("\n%d games (%d failed) in %.1f seconds: %.1f games per hour\n",
+			finished, failed, secs, secs > 0 ? finished * 3600.0 / secs : 0.0);
+	if (finished)
+		printf("Average clevel %.1f, average depth %.1f, deepest %d\n",
+				(double)total_lev / finished, (double)total_depth / finished,
+				best_depth);
+
+	mem_free(workers);
+	exit(failed ? 1 : 0);
+}
+
+
+/*** Terminal ***/
+
+typedef struct term_data term_data;
+struct term_data {
+	term t;
+};
+
+static term_data td;
+
+static errr term_xtra_borg(int n, int v) {
+	/* The borg refreshes the screen often enough to notice the time limit */
+	if (worker_timed_out && worker_state != WORKER_DONE) {
+		worker_state = WORKER_DONE;
+		worker_finish("(time limit)");
+	}
+
+	/* Otherwise only a blocking wait for a key matters */
+	if (n == TERM_XTRA_EVENT && v)
+		worker_wait();
+
+	return 0;
+}
+
+static errr term_curs_borg(int x, int y) {
+	return 0;
+}
+
+static errr term_wipe_borg(int x, int y, int n) {
+	return 0;
+}
+
+static errr term_text_borg(int x, int y, int n, byte a, const wchar_t *s) {
+	return 0;
+}
+
+static void term_data_link(int i) {
+	term *t = &td.t;
+
+	term_init(t, 80, 24, 256);
+
+	t->xtra_hook = term_xtra_borg;
+	t->curs_hook = term_curs_borg;
+	t->wipe_hook = term_wipe_borg;
+	t->text_hook = term_text_borg;
+
+	t->data = &td;
+
+	Term_activate(t);
+
+	angband_term[i] = t;
+}
+
+const char help_borg[] = "Borg batch mode, subopts -n(# of games) -j(obs) -s(eed) -t(ime limit)";
+
+/*
+ * Usage:
+ *
+ * angband -mborg -- [-nNNN] [-jNN] [-sSEED] [-tSECS]
+ *
+ *   -nNNN   Play NNN games (default: 1)
+ *   -jNN    Run up to NN games at once (default: 1)
+ *   -sSEED  Seed the first game with SEED, the next with SEED+1, and so
+ *           on (default: 1)
+ *   -tSECS  Stop each game after SECS seconds (default: no limit)
+ */
+errr init_borg(int argc, char *argv[]) {
+	int i;
+
+	/* Skip over argv[0] */
+	for (i = 1; i < argc; i++) {
+		if (prefix(argv[i], "-n")) {
+			num_games = atoi(&argv[i][2]);
+			continue;
+		}
+		if (prefix(argv[i], "-j")) {
+			num_jobs = atoi(&argv[i][2]);
+			continue;
+		}
+		if (prefix(argv[i], "-s")) {
+			base_seed = strtoul(&argv[i][2], NULL, 0);
+			continue;
+		}
+		if (prefix(argv[i], "-t")) {
+			time_limit = atoi(&argv[i][2]);
+			continue;
+		}
+		printf("init-borg: bad argument '%s'\n", argv[i]);
+	}
+
+	if (num_games < 1) num_games = 1;
+	if (num_jobs < 1) num_jobs = 1;
+	if (num_jobs > num_games) num_jobs = num_games;
+
+	/* Only the workers get past here */
+	run_borgs();
+
+	term_data_link(0);
+	return 0;
+}
+
+#endif /* USE_BORG_RUNNER && ALLOW_BORG */
@@ -22,12 +22,17 @@
 
 #include "birth.h"
 #include "buildid.h"
+#include "cave.h"
+#include "generate.h"
 #include "init.h"
 #include "monster/mon-make.h"
 #include "object/pval.h"
 #include "object/tvalsval.h"
 #include "stats/db.h"
+#include "stats/hist.h"
+#include "stats/stream.h"
 #include "stats/structs.h"
+#include "wizard.h"
 #include <stddef.h>
 #include <time.h>
 
@@ -39,147 +44,143 @@
 #define TOP_AC			146
 #define TOP_PLUS		 56
 #define TOP_POWER		999
+#define POWER_BAND		 10 /* width of the bands object power is counted in */
 #define TOP_PVAL		 25
-#define RUNS_PER_CHECKPOINT	20000
+#define RUNS_PER_CHECKPOINT	1000
+
+/* Most memory the counters may take between checkpoints, in bytes */
+#define STATS_HIST_LIMIT	(32L << 20)
 
 /* For ref, e_max is ~200, a_max is ~140, r_max is ~650,
 	ORIGIN_STATS is 14, OF_MAX is ~120 */
 
 /* There are ~400 kinds, of which about 150-200 are wearable */
 
+/*
+ * Count tables which are kept in the sparse counters, rather than as arrays
+ * in level_data.  Each has a level, a count and an index column, then some
+ * of origin and two values, in that order; see stats_write_db_hist().
+ * The tables with no columns given are kept in level_data, but have keys
+ * so that they can go in the checkpoint file.
+ */
+enum stats_table {
+	ST_NONE = 0,
+	ST_MONSTERS,
+	ST_VAULTS,
+	ST_PITS,
+	ST_ARTIFACTS,
+	ST_CONSUMABLES,
+	ST_WEARABLES_COUNT,
+	ST_WEARABLES_DICE,
+	ST_WEARABLES_AC,
+	ST_WEARABLES_HIT,
+	ST_WEARABLES_DAM,
+	ST_WEARABLES_POWER,
+	ST_WEARABLES_AFFIXES,
+	ST_WEARABLES_THEMES,
+	ST_WEARABLES_FLAGS,
+	ST_WEARABLES_PVAL_FLAGS,
+	ST_OBJ_FEELINGS,
+	ST_MON_FEELINGS,
+	ST_GOLD,
+	ST_MAX
+};
+
+static const struct {
+	const char *name;
+	int cols;
+} stats_tables[ST_MAX] = {
+	{ NULL, 0 },
+	{ "monsters", 3 },
+	{ "vaults", 3 },
+	{ "pits", 3 },
+	{ "artifacts", 4 },
+	{ "consumables", 4 },
+	{ "wearables_count", 4 },
+	{ "wearables_dice", 6 },
+	{ "wearables_ac", 5 },
+	{ "wearables_hit", 5 },
+	{ "wearables_dam", 5 },
+	{ "wearables_power", 5 },
+	{ "wearables_affixes", 5 },
+	{ "wearables_themes", 5 },
+	{ "wearables_flags", 5 },
+	{ "wearables_pval_flags", 6 },
+	{ "obj_feelings", 0 },
+	{ "mon_feelings", 0 },
+	{ "gold", 0 },
+};
+
 static int randarts = 0;
 static int no_selling = 0;
 static u32b num_runs = 1;
 static bool quiet = FALSE;
+static int level_sim = 0;
+static int num_jobs = 1;
 static int nextkey = 0;
 static int running_stats = 0;
 static char *ANGBAND_DIR_STATS;
 
-static int *consumables_index, *consumables_rev_index;
-static int *wearables_index, *wearables_rev_index;
-static int *pval_flags_index, *pval_flags_rev_index;
-static int wearable_count = 0;
-static int consumable_count = 0;
-static int pval_flags_count = 0;
-
-struct wearables_data {
-	u32b count;
-	u32b dice[TOP_DICE][TOP_SIDES];
-	u32b ac[TOP_AC];
-	u32b hit[TOP_PLUS];
-	u32b dam[TOP_PLUS];
-/*	u32b power[TOP_POWER]; not enough memory - add it later in bands */
-	u32b *affixes;
-	u32b *themes;
-	u32b flags[OF_MAX];
-	u32b *pval_flags[TOP_PVAL];
-};
-
+/*
+ * The small, dense tables are kept per level; everything else goes in the
+ * sparse counters, which only take up room for counts that are nonzero.
+ */
 static struct level_data {
-	u32b *monsters;
-/*  u32b *vaults;  Add these later - requires passing into generate.c
-	u32b *pits; */
 	u32b obj_feelings[OBJ_FEEL_MAX];
 	u32b mon_feelings[MON_FEEL_MAX];
 	long long gold[ORIGIN_STATS];
-	u32b *artifacts[ORIGIN_STATS];
-	u32b *consumables[ORIGIN_STATS];
-	struct wearables_data *wearables[ORIGIN_STATS];
 } level_data[LEVEL_MAX];
 
-static void create_indices()
-{
-	int i;
-
-	consumables_index = C_ZNEW(z_info->k_max, int);
-	consumables_rev_index = C_ZNEW(z_info->k_max, int);
-	wearables_index = C_ZNEW(z_info->k_max, int);
-	wearables_rev_index = C_ZNEW(z_info->k_max, int);
-	pval_flags_index = C_ZNEW(OF_MAX, int);
-	pval_flags_rev_index = C_ZNEW(OF_MAX, int);
-
-	for (i = 0; i < z_info->k_max; i++) {
-
-		object_type object_type_body;
-		object_type *o_ptr = &object_type_body;
-		object_kind *kind = &k_info[i];
-		o_ptr->tval = kind->tval;
-
-		if (! kind->name) continue;
-
-		if (wearable_p(o_ptr)) {
-			wearables_index[i] = ++wearable_count;
-			wearables_rev_index[wearable_count] = i;
-		} else {
-			consumables_index[i] = ++consumable_count;
-			consumables_rev_index[consumable_count] = i;
-		}
-	}
+/*
+ * While the runs are going, the counts are only those since the last
+ * checkpoint; each checkpoint adds them to the end of the checkpoint file
+ * and starts again from zero.  They are added up again from the file at
+ * the end, and written to the database in one go, after which the file
+ * is removed.
+ */
+static struct stats_hist *counts;
+static struct stats_stream *stream;
+static char *stream_filename;
+static u32b runs_finished;
 
-	for (i = 0; i < OF_MAX; i++)
-		if (flag_uses_pval(i)) {
-			pval_flags_index[i] = ++pval_flags_count;
-			pval_flags_rev_index[pval_flags_count] = i;
-		}
-}
+/* Database to finish off from its checkpoint file, rather than doing runs */
+static char *finish_filename = NULL;
 
 static void alloc_memory()
 {
-	int i, j, k, l;
-
-	for (i = 0; i < LEVEL_MAX; i++) {
-		level_data[i].monsters = C_ZNEW(z_info->r_max, u32b);
-/*		level_data[i].vaults = C_ZNEW(z_info->v_max, u32b);
-		level_data[i].pits = C_ZNEW(z_info->pit_max, u32b); */
-
-		for (j = 0; j < ORIGIN_STATS; j++) {
-			level_data[i].artifacts[j] = C_ZNEW(z_info->a_max, u32b);
-			level_data[i].consumables[j] = C_ZNEW(consumable_count + 1, u32b);
-			level_data[i].wearables[j]
-				= C_ZNEW(wearable_count + 1, struct wearables_data);
-
-			for (k = 0; k < wearable_count + 1; k++) {
-				level_data[i].wearables[j][k].affixes
-					= C_ZNEW(z_info->e_max, u32b);
-				level_data[i].wearables[j][k].themes
-					= C_ZNEW(z_info->theme_max, u32b);
-				for (l = 0; l < TOP_PVAL; l++)
-					level_data[i].wearables[j][k].pval_flags[l]
-						= C_ZNEW(pval_flags_count + 1, u32b);
-			}
-		}
-	}
+	counts = stats_hist_new(1 << 16);
+	stream = stats_stream_new();
 }
 
 static void free_stats_memory(void)
 {
-	int i, j, k, l;
-	for (i = 0; i < LEVEL_MAX; i++) {
-		mem_free(level_data[i].monsters);
-/*		mem_free(level_data[i].vaults);
- 		mem_free(level_data[i].pits); */
-		for (j = 0; j < ORIGIN_STATS; j++) {
-			mem_free(level_data[i].artifacts[j]);
-			mem_free(level_data[i].consumables[j]);
-			for (k = 0; k < wearable_count + 1; k++) {
-				for (l = 0; l < TOP_PVAL; l++) {
-					mem_free(level_data[i].wearables[j][k].pval_flags[l]);
-				}
-				mem_free(level_data[i].wearables[j][k].affixes);
-				mem_free(level_data[i].wearables[j][k].themes);
-			}
-			mem_free(level_data[i].wearables[j]);
-		}
-	}
-	mem_free(consumables_index);
-	mem_free(consumables_rev_index);
-	mem_free(wearables_index);
-	mem_free(wearables_rev_index);
-	mem_free(pval_flags_index);
-	mem_free(pval_flags_rev_index);
+	stats_hist_free(counts);
+	stats_stream_free(stream);
+	string_free(stream_filename);
 	string_free(ANGBAND_DIR_STATS);
 }
 
+/*
+ * Count one of something in one of the sparse tables.  If the counters
+ * have used up their memory, they go to the checkpoint file early to make
+ * room.
+ */
+static bool stats_checkpoint(u32b runs);
+
+static void stats_count(enum stats_table table, int level, int origin,
+	int idx, int a, int b)
+{
+	a = MIN(MAX(a, 0), STATS_KEY_VAL_MAX);
+	b = MIN(MAX(b, 0), STATS_KEY_VAL_MAX);
+
+	if (stats_hist_full(counts) && !stats_checkpoint(runs_finished)) {
+		stats_db_close();
+		quit_fmt("Problems writing to %s!", stream_filename);
+	}
+
+	stats_hist_add(counts, STATS_KEY(table, level, origin, idx, a, b), 1);
+}
+
 /* Copied from birth.c:generate_player() */
 static void generate_player_for_stats()
 {
@@ -238,6 +239,7 @@ static void initialize_character(void)
 	seed_flavor = randint0(0x10000000);
 	seed_town = randint0(0x10000000);
 	seed_randart = randint0(0x10000000);
+	randart_version = RANDART_VERSION;
 
 	if (randarts)
 	{
@@ -259,7 +261,8 @@ static void kill_all_monsters(int level)
 		monster_type *m_ptr = cave_monster(cave, i);
 		monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
-		level_data[level].monsters[m_ptr->r_idx]++;
+		if (m_ptr->r_idx)
+			stats_count(ST_MONSTERS, level, 0, m_ptr->r_idx, 0, 0);
 
 		monster_death(m_ptr, TRUE);
 
@@ -301,64 +304,83 @@ static void reset_artifacts(void)
 
 static void log_all_objects(int level)
 {
-	int x, y, i;
-
-	for (y = 1; y < DUNGEON_HGT - 1; y++) {
-		for (x = 1; x < DUNGEON_WID - 1; x++) {
-			object_type *o_ptr = get_first_object(y, x);
-
-			if (o_ptr) do {
-			/*	u32b o_power = 0; */
-
-				/* Mark object as fully known */
-				object_notice_everything(o_ptr);
-
-/*				o_power = object_power(o_ptr, FALSE, NULL, TRUE); */
-
-				/* Capture gold amounts */
-				if (o_ptr->tval == TV_GOLD)
-					level_data[level].gold[o_ptr->origin] += o_ptr->extent;
-
-				/* Capture artifact drops */
-				if (o_ptr->artifact)
-					level_data[level].artifacts[o_ptr->origin][o_ptr->artifact->aidx]++;
-
-				/* Capture kind details */
-				if (wearable_p(o_ptr)) {
-					struct wearables_data *w
-						= &level_data[level].wearables[o_ptr->origin][wearables_index[o_ptr->kind->kidx]];
-
-					w->count++;
-					w->dice[MIN(o_ptr->dd, TOP_DICE - 1)][MIN(o_ptr->ds, TOP_SIDES - 1)]++;
-					w->ac[MIN(MAX(o_ptr->ac + o_ptr->to_a, 0), TOP_AC - 1)]++;
-					w->hit[MIN(MAX(o_ptr->to_finesse, 0), TOP_PLUS - 1)]++;
-					w->dam[MIN(MAX(o_ptr->to_prowess, 0), TOP_PLUS - 1)]++;
-
-					/* Capture egos */
-					if (o_ptr->theme)
-						w->themes[o_ptr->theme->index]++;
-
-					for (i = 0; i < MAX_AFFIXES; i++)
-						if (o_ptr->affix[i])
-							w->affixes[o_ptr->affix[i]->eidx]++;
-
-					/* Capture object flags */
-					for (i = of_next(o_ptr->flags, FLAG_START); i != FLAG_END;
-							i = of_next(o_ptr->flags, i + 1)) {
-						w->flags[i]++;
-						if (flag_uses_pval(i)) {
-							int p = o_ptr->pval[which_pval(o_ptr, i)];
-							w->pval_flags[MIN(MAX(p, 0), TOP_PVAL - 1)][pval_flags_index[i]]++;
-						}
-					}
-				} else
-					level_data[level].consumables[o_ptr->origin][consumables_index[o_ptr->kind->kidx]]++;
+	s16b o_idx;
+	int i;
+
+	for (o_idx = floor_object_first(); o_idx;
+			o_idx = floor_object_next(o_idx)) {
+		object_type *o_ptr = object_byid(o_idx);
+		int origin = o_ptr->origin;
+		int k_idx = o_ptr->kind->kidx;
+
+		/* Mark object as fully known */
+		object_notice_everything(o_ptr);
+
+		/* Capture gold amounts */
+		if (o_ptr->tval == TV_GOLD)
+			level_data[level].gold[origin] += o_ptr->extent;
+
+		/* Capture artifact drops */
+		if (o_ptr->artifact)
+			stats_count(ST_ARTIFACTS, level, origin,
+				o_ptr->artifact->aidx, 0, 0);
+
+		/* Capture kind details */
+		if (wearable_p(o_ptr)) {
+			s32b power = object_power(o_ptr, FALSE, NULL, TRUE);
+
+			stats_count(ST_WEARABLES_COUNT, level, origin, k_idx, 0, 0);
+			if (o_ptr->dd || o_ptr->ds)
+				stats_count(ST_WEARABLES_DICE, level, origin, k_idx,
+					MIN(o_ptr->dd, TOP_DICE - 1),
+					MIN(o_ptr->ds, TOP_SIDES - 1));
+			stats_count(ST_WEARABLES_AC, level, origin, k_idx,
+				MIN(o_ptr->ac + o_ptr->to_a, TOP_AC - 1), 0);
+			stats_count(ST_WEARABLES_HIT, level, origin, k_idx,
+				MIN(o_ptr->to_finesse, TOP_PLUS - 1), 0);
+			stats_count(ST_WEARABLES_DAM, level, origin, k_idx,
+				MIN(o_ptr->to_prowess, TOP_PLUS - 1), 0);
+
+			/* Capture power, in bands */
+			power = MIN(MAX(power, 0), TOP_POWER);
+			stats_count(ST_WEARABLES_POWER, level, origin, k_idx,
+				power - power % POWER_BAND, 0);
+
+			/* Capture egos */
+			if (o_ptr->theme)
+				stats_count(ST_WEARABLES_THEMES, level, origin, k_idx,
+					o_ptr->theme->index, 0);
+
+			for (i = 0; i < MAX_AFFIXES; i++)
+				if (o_ptr->affix[i])
+					stats_count(ST_WEARABLES_AFFIXES, level, origin,
+						k_idx, o_ptr->affix[i]->eidx, 0);
+
+			/* Capture object flags */
+			for (i = of_next(o_ptr->flags, FLAG_START); i != FLAG_END;
+					i = of_next(o_ptr->flags, i + 1)) {
+				stats_count(ST_WEARABLES_FLAGS, level, origin, k_idx,
+					i, 0);
+				if (flag_uses_pval(i)) {
+					int p = o_ptr->pval[which_pval(o_ptr, i)];
+					stats_count(ST_WEARABLES_PVAL_FLAGS, level, origin,
+						k_idx, MIN(p, TOP_PVAL - 1), i);
+				}
 			}
-			while ((o_ptr = get_next_object(o_ptr)));
-		}
+		} else
+			stats_count(ST_CONSUMABLES, level, origin, k_idx, 0, 0);
 	}
 }
 
+static void log_all_rooms(int level)
+{
+	struct cave_room *room;
+
+	for (room = cave->rooms; room; room = room->next)
+		stats_count(room->kind == CAVE_ROOM_VAULT ? ST_VAULTS : ST_PITS,
+			level, 0, room->idx, 0, 0);
+}
+
 static void descend_dungeon(void)
 {
 	int level;
@@ -388,6 +410,7 @@ static void descend_dungeon(void)
 		level_data[level].obj_feelings[MIN(obj_f, OBJ_FEEL_MAX - 1)]++;
 		level_data[level].mon_feelings[MIN(mon_f, MON_FEEL_MAX - 1)]++;
 
+		log_all_rooms(level);
 		kill_all_monsters(level);
 		log_all_objects(level);
 	}
@@ -986,7 +1009,7 @@ static int stats_dump_lists(void)
 	STATS_DB_FINALIZE(sql_stmt)
 
 	err = stats_db_stmt_prep(&sql_stmt,
-		"INSERT INTO object_slays_list VALUES(?,?,?,?,?);");
+		"INSERT INTO object_slays_list VALUES(?,?,?,?,NULL,?);");
 	if (err) return err;
 
 	for (idx = 1; idx < SL_MAX; idx++) {
@@ -997,7 +1020,7 @@ static int stats_dump_lists(void)
 			s_ptr->object_flag, s_ptr->monster_flag,
 			s_ptr->resist_flag);
 		if (err) return err;
-		err = sqlite3_bind_text(sql_stmt, 6, s_ptr->desc,
+		err = sqlite3_bind_text(sql_stmt, 5, s_ptr->desc,
 			strlen(s_ptr->desc), SQLITE_STATIC);
 		if (err) return err;
 		STATS_DB_STEP_RESET(sql_stmt)
@@ -1030,6 +1053,54 @@ static int stats_dump_lists(void)
 	return SQLITE_OK;
 }
 
+static int stats_dump_rooms(void)
+{
+	int err, idx;
+	sqlite3_stmt *vault_stmt, *pit_stmt;
+	struct vault *v;
+
+	err = stats_db_stmt_prep(&vault_stmt,
+		"INSERT INTO vault_info VALUES(?,?,?,?,?,?);");
+	if (err) return err;
+
+	err = stats_db_stmt_prep(&pit_stmt,
+		"INSERT INTO pit_info VALUES(?,?,?,?,?,?);");
+	if (err) return err;
+
+	for (v = vaults; v; v = v->next) {
+		err = stats_db_bind_ints(vault_stmt, 1, 0, v->vidx);
+		if (err) return err;
+		err = sqlite3_bind_text(vault_stmt, 2, v->name,
+			strlen(v->name), SQLITE_STATIC);
+		if (err) return err;
+		err = stats_db_bind_ints(vault_stmt, 4, 2, v->typ, v->rat,
+			v->hgt, v->wid);
+		if (err) return err;
+		STATS_DB_STEP_RESET(vault_stmt)
+	}
+
+	for (idx = 0; idx < z_info->pit_max; idx++) {
+		pit_profile *pit = &pit_info[idx];
+
+		if (!pit->name) continue;
+
+		err = stats_db_bind_ints(pit_stmt, 1, 0, idx);
+		if (err) return err;
+		err = sqlite3_bind_text(pit_stmt, 2, pit->name,
+			strlen(pit->name), SQLITE_STATIC);
+		if (err) return err;
+		err = stats_db_bind_ints(pit_stmt, 4, 2, pit->room_type, pit->ave,
+			pit->rarity, pit->obj_rarity);
+		if (err) return err;
+		STATS_DB_STEP_RESET(pit_stmt)
+	}
+
+	STATS_DB_FINALIZE(vault_stmt)
+	STATS_DB_FINALIZE(pit_stmt)
+
+	return SQLITE_OK;
+}
+
 static int stats_dump_info(void)
 {
 	int err;
@@ -1073,6 +1144,9 @@ static int stats_dump_info(void)
 	err = stats_dump_lists();
 	if (err) return err;
 
+	err = stats_dump_rooms();
+	if (err) return err;
+
 	/* Commit transaction */
 	return stats_db_exec("COMMIT;");
 }
@@ -1111,8 +1185,12 @@ static int stats_dump_info(void)
  *	   theme_info -- dump of ego_themes.txt
  *     theme_affixes_map -- map of affixes in each theme
  *     theme_type_map -- map between themes and tvals/svals, with alloc_min/max
+ *     vault_info -- dump of vault.txt
+ *     pit_info -- dump of pit.txt
  * Count tables:
  *     monsters
+ *     vaults
+ *     pits
  *     obj_feelings
  *     mon_feelings
  *     gold
@@ -1123,6 +1201,7 @@ static int stats_dump_info(void)
  *     wearables_ac
  *     wearables_hit
  *     wearables_dam
+ *     wearables_power -- in bands of POWER_BAND
  *     wearables_egos
  *     wearables_flags
  *     wearables_pval_flags
@@ -1219,9 +1298,21 @@ static bool stats_prep_db(void)
 	err = stats_db_exec("CREATE TABLE origin_flags_list(idx INT PRIMARY KEY, name TEXT);");
 	if (err) return false;
 
+	err = stats_db_exec("CREATE TABLE vault_info(idx INT PRIMARY KEY, name TEXT, typ INT, rating INT, height INT, width INT);");
+	if (err) return false;
+
+	err = stats_db_exec("CREATE TABLE pit_info(idx INT PRIMARY KEY, name TEXT, room_type INT, ave INT, rarity INT, obj_rarity INT);");
+	if (err) return false;
+
 	err = stats_db_exec("CREATE TABLE monsters(level INT, count INT, k_idx INT, UNIQUE (level, k_idx) ON CONFLICT REPLACE);");
 	if (err) return false;
 
+	err = stats_db_exec("CREATE TABLE vaults(level INT, count INT, v_idx INT, UNIQUE (level, v_idx) ON CONFLICT REPLACE);");
+	if (err) return false;
+
+	err = stats_db_exec("CREATE TABLE pits(level INT, count INT, pit_idx INT, UNIQUE (level, pit_idx) ON CONFLICT REPLACE);");
+	if (err) return false;
+
 	err = stats_db_exec("CREATE TABLE obj_feelings(level INT, count INT, feeling INT, UNIQUE (level, feeling) ON CONFLICT REPLACE);");
 	if (err) return false;
 
@@ -1252,6 +1343,9 @@ static bool stats_prep_db(void)
 	err = stats_db_exec("CREATE TABLE wearables_dam(level INT, count INT, k_idx INT, origin INT, to_prowess INT, UNIQUE (level, k_idx, origin, to_prowess) ON CONFLICT REPLACE);");
 	if (err) return false;
 
+	err = stats_db_exec("CREATE TABLE wearables_power(level INT, count INT, k_idx INT, origin INT, power INT, UNIQUE (level, k_idx, origin, power) ON CONFLICT REPLACE);");
+	if (err) return false;
+
 	err = stats_db_exec("CREATE TABLE wearables_affixes(level INT, count INT, k_idx INT, origin INT, e_idx INT, UNIQUE (level, k_idx, origin, e_idx) ON CONFLICT REPLACE);");
 	if (err) return false;
 
@@ -1275,49 +1369,12 @@ static bool stats_prep_db(void)
  */
 static int stats_level_data_offsetof(const char *member)
 {
-	if (streq(member, "monsters"))
-		return offsetof(struct level_data, monsters);
-	else if (streq(member, "obj_feelings"))
+	if (streq(member, "obj_feelings"))
 		return offsetof(struct level_data, obj_feelings);
 	else if (streq(member, "mon_feelings"))
 		return offsetof(struct level_data, mon_feelings);
 	else if (streq(member, "gold"))
 		return offsetof(struct level_data, gold);
-	else if (streq(member, "artifacts"))
-		return offsetof(struct level_data, artifacts);
-	else if (streq(member, "consumables"))
-		return offsetof(struct level_data, consumables);
-	else if (streq(member, "wearables"))
-		return offsetof(struct level_data, wearables);
-
-	/* We should not get to this point. */
-	assert(0);
-}
-
-/**
- * Find the offset of the given member of the wearables_data struct. Not
- * elegant.
- */
-static int stats_wearables_data_offsetof(const char *member)
-{
-	if (streq(member, "count"))
-		return offsetof(struct wearables_data, count);
-	else if (streq(member, "dice"))
-		return offsetof(struct wearables_data, dice);
-	else if (streq(member, "ac"))
-		return offsetof(struct wearables_data, ac);
-	else if (streq(member, "hit"))
-		return offsetof(struct wearables_data, hit);
-	else if (streq(member, "dam"))
-		return offsetof(struct wearables_data, dam);
-	else if (streq(member, "affixes"))
-		return offsetof(struct wearables_data, affixes);
-	else if (streq(member, "themes"))
-		return offsetof(struct wearables_data, themes);
-	else if (streq(member, "flags"))
-		return offsetof(struct wearables_data, flags);
-	else if (streq(member, "pval_flags"))
-		return offsetof(struct wearables_data, pval_flags);
 
 	/* We should not get to this point. */
 	assert(0);
@@ -1363,202 +1420,52 @@ static int stats_write_db_level_data(const char *table, int max_idx)
 	return sqlite3_finalize(sql_stmt);
 }
 
-static int stats_write_db_level_data_items(const char *table, int max_idx, 
-	bool translate_consumables)
-{
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, i, offset;
-
-	strnfmt(sql_buf, 256, "INSERT INTO %s VALUES(?,?,?,?);", table);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
-	if (err) return err;
-
-	offset = stats_level_data_offsetof(table);
-
-	for (level = 1; level < LEVEL_MAX; level++)
-	{
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-		{
-			for (i = 0; i < max_idx; i++)
-			{
-				/* This arcane expression finds the value of 
-				 * level_data[level].<table>[origin][i] */
-				u32b count = ((u32b **)((byte *)&level_data[level] + offset))[origin][i];
-				if (!count) continue;
-
-				err = stats_db_bind_ints(sql_stmt, 4, 0,
-					level, count, 
-					translate_consumables ? consumables_rev_index[i] : i, origin);
-				if (err) return err;
-
-				STATS_DB_STEP_RESET(sql_stmt)
-			}
-		}
-	}
-
-	return sqlite3_finalize(sql_stmt);
-}
-
-static int stats_write_db_wearables_count(void)
-{
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, k_idx, idx;
-
-	err = stats_db_stmt_prep(&sql_stmt, 
-		"INSERT INTO wearables_count VALUES(?,?,?,?);");
-	if (err) return err;
-
-	for (level = 1; level < LEVEL_MAX; level++)
-	{
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-		{
-			for (idx = 0; idx < wearable_count + 1; idx++)
-			{
-				u32b count = level_data[level].wearables[origin][idx].count;
-				/* Skip if object did not appear */
-				if (!count) continue;
-
-				k_idx = wearables_rev_index[idx];
-
-				/* Skip if pile */
-				if (! k_idx) continue;
-
-				err = stats_db_bind_ints(sql_stmt, 4, 0,
-					level, count, k_idx, origin);
-				if (err) return err;
-
-				STATS_DB_STEP_RESET(sql_stmt)
-			}
-		}
-	}
-
-	return sqlite3_finalize(sql_stmt);
-}
-
 /**
- * Unfortunately, the arcane expression used to find the value of an array 
- * member of a struct differs depending on whether the member is declared
- * as an array or as a pointer. Pass in true if the member is an array, and
- * false if the member is a pointer.
+ * Write out everything in the sparse counters, in one pass over them.
  */
-static int stats_write_db_wearables_array(const char *field, int max_val, bool array_p)
+static int stats_write_db_hist(void)
 {
 	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, idx, k_idx, i, offset;
+	sqlite3_stmt *sql_stmt[ST_MAX];
+	int err, table;
+	size_t iter = 0;
+	u64b key;
+	u32b count;
 
-	strnfmt(sql_buf, 256, "INSERT INTO wearables_%s VALUES(?,?,?,?,?);", field);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
-	if (err) return err;
+	for (table = 1; table < ST_MAX; table++) {
+		const char *qs[] = { "", "?", "?,?", "?,?,?", "?,?,?,?",
+			"?,?,?,?,?", "?,?,?,?,?,?" };
 
-	offset = stats_wearables_data_offsetof(field);
+		sql_stmt[table] = NULL;
+		if (!stats_tables[table].cols) continue;
 
-	for (level = 1; level < LEVEL_MAX; level++)
-	{
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-		{
-			for (idx = 0; idx < wearable_count + 1; idx++)
-			{
-				k_idx = wearables_rev_index[idx];
-
-				/* Skip if pile */
-				if (! k_idx) continue;
-
-				for (i = 0; i < max_val; i++)
-				{
-					/* This arcane expression finds the value of
-					 * level_data[level].wearables[origin][idx].<field>[i] */
-					u32b count;
-					if (array_p)
-					{
-						count = ((u32b *)((byte *)&level_data[level].wearables[origin][idx] + offset))[i];
-					}
-					else
-					{
-						count = ((u32b *)*((u32b **)((byte *)&level_data[level].wearables[origin][idx] + offset)))[i];
-					}
-					if (!count) continue;
-
-					err = stats_db_bind_ints(sql_stmt, 5, 0,
-						level, count, k_idx, origin, i);
-					if (err) return err;
-
-					STATS_DB_STEP_RESET(sql_stmt)
-				}
-			}
-		}
+		strnfmt(sql_buf, 256, "INSERT INTO %s VALUES(%s);",
+			stats_tables[table].name, qs[stats_tables[table].cols]);
+		err = stats_db_stmt_prep(&sql_stmt[table], sql_buf);
+		if (err) return err;
 	}
 
-	return sqlite3_finalize(sql_stmt);
-}
-
-/**
- * Unfortunately, the arcane expression used to find the value of an array 
- * member of a struct differs depending on whether the member is declared
- * as an array or as a pointer. Pass in true if the member is an array, and
- * false if the member is a pointer.
- */
-static int stats_write_db_wearables_2d_array(const char *field, 
-	int max_val1, int max_val2, bool array_p, bool translate_pval_flags)
-{
-	char sql_buf[256];
-	sqlite3_stmt *sql_stmt;
-	int err, level, origin, idx, k_idx, i, j, offset;
+	while (stats_hist_next(counts, &iter, &key, &count)) {
+		table = STATS_KEY_TABLE(key);
+		if (!sql_stmt[table]) continue;
 
-	strnfmt(sql_buf, 256, "INSERT INTO wearables_%s VALUES(?,?,?,?,?,?);", field);
-	err = stats_db_stmt_prep(&sql_stmt, sql_buf);
-	if (err) return err;
+		err = stats_db_bind_ints(sql_stmt[table], stats_tables[table].cols,
+			0, STATS_KEY_LEVEL(key), count, STATS_KEY_IDX(key),
+			STATS_KEY_ORIGIN(key), STATS_KEY_A(key), STATS_KEY_B(key));
+		if (err) return err;
 
-	offset = stats_wearables_data_offsetof(field);
+		STATS_DB_STEP_RESET(sql_stmt[table])
+	}
 
-	for (level = 1; level < LEVEL_MAX; level++)
-	{
-		for (origin = 0; origin < ORIGIN_STATS; origin++)
-		{
-			for (idx = 0; idx < wearable_count + 1; idx++)
-			{
-				k_idx = wearables_rev_index[idx];
-
-				/* Skip if pile */
-				if (! k_idx) continue;
-
-				for (i = 0; i < max_val1; i++)
-				{
-					for (j = 0; j < max_val2; j++)
-					{
-						/* This arcane expression finds the value of
-				 		* level_data[level].wearables[origin][idx].<field>[i][j] */
-						u32b count;
-						int real_j = translate_pval_flags ? pval_flags_rev_index[j] : j; 
-
-						if (i == 0 && real_j == 0) continue;
-
-						if (array_p)
-						{
-							count = ((u32b *)((byte *)&level_data[level].wearables[origin][idx] + offset))[i * max_val2 + j];
-						}
-						else
-						{
-							count = *(*((u32b **)((byte *)&level_data[level].wearables[origin][idx] + offset) + i) + j);
-						}
-						if (!count) continue;
-
-						err = stats_db_bind_ints(sql_stmt, 6, 0,
-							level, count, k_idx, origin, i, real_j);
-						if (err) return err;
-
-						STATS_DB_STEP_RESET(sql_stmt)
-					}
-				}
-			}
-		}
+	for (table = 1; table < ST_MAX; table++) {
+		if (!sql_stmt[table]) continue;
+		STATS_DB_FINALIZE(sql_stmt[table])
 	}
 
-	return sqlite3_finalize(sql_stmt);
+	return SQLITE_OK;
 }
 
-static int stats_write_db(u32b run)
+static int stats_write_db(u32b runs)
 {
 	char sql_buf[256];
 	int err;
@@ -1568,13 +1475,10 @@ static int stats_write_db(u32b run)
 	if (err) return err;
 
 	strnfmt(sql_buf, 256,
-		"INSERT OR REPLACE INTO metadata VALUES('runs', %d);", (run - 1));
+		"INSERT OR REPLACE INTO metadata VALUES('runs', %d);", runs);
 	err = stats_db_exec(sql_buf);
 	if (err) return err;
 
-	err = stats_write_db_level_data("monsters", z_info->r_max);
-	if (err) return err;
-
 	err = stats_write_db_level_data("obj_feelings", OBJ_FEEL_MAX);
 	if (err) return err;
 
@@ -1584,44 +1488,129 @@ static int stats_write_db(u32b run)
 	err = stats_write_db_level_data("gold", ORIGIN_STATS);
 	if (err) return err;
 
-	err = stats_write_db_level_data_items("artifacts", z_info->a_max, false);
+	err = stats_write_db_hist();
 	if (err) return err;
 
-	err = stats_write_db_level_data_items("consumables",
-		consumable_count + 1, true);
+	/* Commit transaction */
+	err = stats_db_exec("COMMIT;");
 	if (err) return err;
 
-	err = stats_write_db_wearables_count();
-	if (err) return err;
+	return SQLITE_OK;
+}
 
-	err = stats_write_db_wearables_2d_array("dice", TOP_DICE, TOP_SIDES, true, false);
-	if (err) return err;
+/**
+ * Add the counts since the last checkpoint to the checkpoint file, then
+ * start them again from zero.  Call with the number of runs that have been
+ * completed.
+ */
+static bool stats_checkpoint(u32b runs)
+{
+	size_t iter = 0;
+	u64b key;
+	u32b count;
+	int level, i;
+
+	while (stats_hist_next(counts, &iter, &key, &count))
+		stats_stream_put(stream, key, count);
+
+	for (level = 1; level < LEVEL_MAX; level++) {
+		struct level_data *ld = &level_data[level];
+
+		for (i = 0; i < OBJ_FEEL_MAX; i++)
+			if (ld->obj_feelings[i])
+				stats_stream_put(stream,
+					STATS_KEY(ST_OBJ_FEELINGS, level, 0, i, 0, 0),
+					ld->obj_feelings[i]);
+
+		for (i = 0; i < MON_FEEL_MAX; i++)
+			if (ld->mon_feelings[i])
+				stats_stream_put(stream,
+					STATS_KEY(ST_MON_FEELINGS, level, 0, i, 0, 0),
+					ld->mon_feelings[i]);
+
+		for (i = 0; i < ORIGIN_STATS; i++)
+			if (ld->gold[i])
+				stats_stream_put(stream,
+					STATS_KEY(ST_GOLD, level, 0, i, 0, 0),
+					(u64b)ld->gold[i]);
+	}
 
-	err = stats_write_db_wearables_array("ac", TOP_AC, true);
-	if (err) return err;
+	stats_hist_clear(counts);
+	memset(level_data, 0, sizeof(level_data));
 
-	err = stats_write_db_wearables_array("hit", TOP_PLUS, true);
-	if (err) return err;
+	return stats_stream_append(stream, stream_filename, runs);
+}
 
-	err = stats_write_db_wearables_array("dam", TOP_PLUS, true);
-	if (err) return err;
+/**
+ * Add one entry from the checkpoint file back into the counts.
+ */
+static void stats_replay_entry(u64b key, u64b value, void *data)
+{
+	int level = STATS_KEY_LEVEL(key);
+	int idx = STATS_KEY_IDX(key);
 
-	err = stats_write_db_wearables_array("affixes", z_info->e_max, false);
-	if (err) return err;
-	err = stats_write_db_wearables_array("themes", z_info->theme_max, false);
-	if (err) return err;
+	if (level >= LEVEL_MAX) return;
 
-	err = stats_write_db_wearables_array("flags", OF_MAX, true);
-	if (err) return err;
+	switch (STATS_KEY_TABLE(key))
+	{
+		case ST_OBJ_FEELINGS:
+			if (idx < OBJ_FEEL_MAX)
+				level_data[level].obj_feelings[idx] += (u32b)value;
+			break;
+
+		case ST_MON_FEELINGS:
+			if (idx < MON_FEEL_MAX)
+				level_data[level].mon_feelings[idx] += (u32b)value;
+			break;
+
+		case ST_GOLD:
+			if (idx < ORIGIN_STATS)
+				level_data[level].gold[idx] += (long long)value;
+			break;
+
+		default:
+			if (STATS_KEY_TABLE(key) > ST_NONE && STATS_KEY_TABLE(key) < ST_MAX)
+				stats_hist_add(counts, key, (u32b)value);
+			break;
+	}
+}
 
-	err = stats_write_db_wearables_2d_array("pval_flags", TOP_PVAL, pval_flags_count + 1, false, true);
-	if (err) return err;
+/**
+ * Add up everything in the checkpoint file and write it to the database,
+ * which must be open already.  Returns a sqlite3 error code, or -1 if the
+ * checkpoint file couldn't be read.
+ */
+static int stats_finish_db(void)
+{
+	u32b runs;
+	int records;
 
-	/* Commit transaction */
-	err = stats_db_exec("COMMIT;");
-	if (err) return err;
+	/* The totals are written in one go, so they need room for everything */
+	stats_hist_set_limit(counts, 0);
+	stats_hist_clear(counts);
+	memset(level_data, 0, sizeof(level_data));
 
-	return SQLITE_OK;
+	records = stats_stream_replay(stream_filename, stats_replay_entry, NULL,
+		&runs);
+	if (records < 0) return -1;
+
+	if (!quiet) {
+		printf("Read %d checkpoints covering %d runs.\n", records, runs);
+		fflush(stdout);
+	}
+
+	return stats_write_db(runs);
+}
+
+/**
+ * Point stream_filename at the checkpoint file for the open database.
+ */
+static void stats_set_stream_filename(void)
+{
+	size_t size = strlen(stats_db_filename()) + 6;
+
+	stream_filename = mem_alloc(size);
+	strnfmt(stream_filename, size, "%s.ckpt", stats_db_filename());
 }
 
 /**
@@ -1662,6 +1651,33 @@ static void stats_cleanup_angband_run(void)
 	if (p_ptr->history) FREE(p_ptr->history);
 }
 
+/**
+ * Do the wizard-mode level stats from wiz-stats.c instead of the database
+ * runs, writing them to stats.log in the user directory.
+ */
+static void run_level_stats(void)
+{
+	u32b seed = time(NULL);
+
+	initialize_character();
+
+	if (!quiet) {
+		printf("Running %d %s iterations, %d at a time, from seed %lu...\n",
+			num_runs, level_sim == 2 ? "clearing" : "diving", num_jobs,
+			(unsigned long)seed);
+		fflush(stdout);
+	}
+
+	if (!stats_collect_batch(level_sim, num_runs, randarts, num_jobs, seed))
+		quit("Couldn't collect the level stats!");
+
+	stats_cleanup_angband_run();
+	cleanup_angband();
+	if (!quiet) printf("Done!\n");
+	quit(NULL);
+	exit(0);
+}
+
 static errr run_stats(void)
 {
 	u32b run;
@@ -1672,9 +1688,30 @@ static errr run_stats(void)
 
 	time_t start;
 
+	if (level_sim) run_level_stats();
+
 	prep_output_dir();
-	create_indices();
 	alloc_memory();
+
+	/* Just finish off the database from an earlier run */
+	if (finish_filename) {
+		if (!stats_db_reopen(finish_filename))
+			quit_fmt("Couldn't open database %s!", finish_filename);
+		stats_set_stream_filename();
+
+		err = stats_finish_db();
+		stats_db_close();
+		if (err < 0) quit_fmt("Couldn't read %s!", stream_filename);
+		if (err) quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
+		file_delete(stream_filename);
+
+		free_stats_memory();
+		cleanup_angband();
+		if (!quiet) printf("Done!\n");
+		quit(NULL);
+		exit(0);
+	}
+
 	if (randarts)
 	{
 		a_info_save = mem_zalloc(z_info->a_max * sizeof(artifact_type));
@@ -1689,6 +1726,12 @@ static errr run_stats(void)
 	if (!quiet) printf("Creating the database and dumping info...\n");
 	status = stats_prep_db();
 	if (!status) quit("Couldn't prepare database!");
+	stats_set_stream_filename();
+	if (!stats_stream_open(stream_filename)) {
+		stats_db_close();
+		quit_fmt("Problems writing to %s!", stream_filename);
+	}
+	stats_hist_set_limit(counts, STATS_HIST_LIMIT);
 
 	if (!quiet) {
 		printf("Beginning %d runs...\n", num_runs);
@@ -1714,15 +1757,13 @@ static errr run_stats(void)
 		descend_dungeon();
 		stats_cleanup_angband_run();
 
+		runs_finished = run;
+
 		/* Checkpoint every so many runs */
-		if (run % RUNS_PER_CHECKPOINT == 0)
+		if (run % RUNS_PER_CHECKPOINT == 0 && !stats_checkpoint(run))
 		{
-			err = stats_write_db(run);
-			if (err)
-			{
-				stats_db_close();
-				quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
-			}
+			stats_db_close();
+			quit_fmt("Problems writing to %s!", stream_filename);
 		}
 
 		if (quiet && run % 1000 == 0) {
@@ -1732,14 +1773,29 @@ static errr run_stats(void)
 	}
 
 	if (!quiet) {
+		u32b hits, misses;
+
 		progress_bar(num_runs, start);
-		printf("\nSaving the data...\n");
+		power_cache_counts(&hits, &misses);
+		printf("\nObject power cache: %lu hits, %lu misses\n",
+			(unsigned long)hits, (unsigned long)misses);
+		printf("Saving the data...\n");
 		fflush(stdout);
 	}
 
-	err = stats_write_db(run);
+	if (num_runs % RUNS_PER_CHECKPOINT && !stats_checkpoint(num_runs))
+	{
+		stats_db_close();
+		quit_fmt("Problems writing to %s!", stream_filename);
+	}
+
+	err = stats_finish_db();
 	stats_db_close();
+	if (err < 0) quit_fmt("Couldn't read %s!", stream_filename);
 	if (err) quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
+
+	/* Everything is in the database now */
+	file_delete(stream_filename);
 	free_stats_memory();
 	cleanup_angband();
 	if (!quiet) printf("Done!\n");
@@ -1869,17 +1925,24 @@ static void term_data_link(int i) {
 	angband_term[i] = t;
 }
 
-const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling)";
+const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling) -f(inish database) -w(izard level stats) -j(obs)";
 
 /*
  * Usage:
  *
- * angband -mstats -- [-q] [-r] [-nNNNN] [-s]
+ * angband -mstats -- [-q] [-r] [-nNNNN] [-s] [-fFILE] [-wN [-jN]]
  *
  *   -q      Quiet mode (turn off progress messages)
  *   -r      Turn on randarts
  *   -nNNNN  Make NNNN runs through the dungeon (default: 1)
  *   -s      Turn on no-selling
+ *   -fFILE  Don't make any runs; fill in the counts in database FILE from
+ *           its checkpoint file FILE.ckpt, e.g. after a run was cut short
+ *   -wN     Don't make any runs; do NNNN tries of the wizard level stats
+ *           instead, as diving (N = 1) or clearing (N = 2), with -r also
+ *           regenerating the randarts each clearing try.  The results go to
+ *           stats.log in the user directory.
+ *   -jN     Share the wizard level stats out between N processes
  */
 
 errr init_stats(int argc, char *argv[]) {
@@ -1903,6 +1966,18 @@ errr init_stats(int argc, char *argv[]) {
 			no_selling = 1;
 			continue;
 		}
+		if (prefix(argv[i], "-f")) {
+			finish_filename = &argv[i][2];
+			continue;
+		}
+		if (prefix(argv[i], "-w")) {
+			level_sim = atoi(&argv[i][2]);
+			continue;
+		}
+		if (prefix(argv[i], "-j")) {
+			num_jobs = MAX(atoi(&argv[i][2]), 1);
+			continue;
+		}
 		printf("init-stats: bad argument '%s'\n", argv[i]);
 	}
 
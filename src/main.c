@@ -17,6 +17,7 @@
  */
 
 #include "angband.h"
+#include "derived.h"
 #include "files.h"
 #include "init.h"
 
@@ -59,6 +60,10 @@ static const struct module modules[] =
 #ifdef USE_STATS
 	{ "stats", help_stats, init_stats },
 #endif /* USE_STATS */
+
+#if defined(USE_BORG_RUNNER) && defined(ALLOW_BORG)
+	{ "borg", help_borg, init_borg },
+#endif /* USE_BORG_RUNNER && ALLOW_BORG */
 };
 
 static int init_sound_dummy(int argc, char *argv[]) {
@@ -234,10 +239,16 @@ static void debug_opt(const char *arg) {
 		mem_flags |= MEM_POISON_ALLOC;
 	else if (streq(arg, "mem-poison-free"))
 		mem_flags |= MEM_POISON_FREE;
+	else if (streq(arg, "check-cache"))
+		derived_flags |= DERIVED_CHECK;
+	else if (streq(arg, "no-cache"))
+		derived_flags |= DERIVED_OFF;
 	else {
 		puts("Debug flags:");
 		puts("  mem-poison-alloc: Poison all memory allocations");
 		puts("   mem-poison-free: Poison all freed memory");
+		puts("       check-cache: Check the derived table cache");
+		puts("          no-cache: Don't use the derived table cache");
 		exit(0);
 	}
 }
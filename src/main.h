@@ -32,6 +32,7 @@ extern errr init_vcs(int argc, char **argv);
 extern errr init_sdl(int argc, char **argv);
 extern errr init_test(int argc, char **argv);
 extern errr init_stats(int argc, char **argv);
+extern errr init_borg(int argc, char **argv);
 
 
 extern const char help_lfb[];
@@ -51,6 +52,7 @@ extern const char help_dos[];
 extern const char help_sdl[];
 extern const char help_test[];
 extern const char help_stats[];
+extern const char help_borg[];
 
 
 struct module
@@ -84,6 +84,9 @@ enum
 #define RF_SIZE                FLAG_SIZE(RF_MAX)
 #define RF_BYTES	  		   32 /* savefile bytes, i.e. 256 flags */
 
+/* Monster flags are checked against constant masks (FLAG_MASK()) */
+FLAG_MASK_FITS(rf, RF_SIZE);
+
 #define rf_has(f, flag)        flag_has_dbg(f, RF_SIZE, flag, #f, #flag)
 #define rf_next(f, flag)       flag_next(f, RF_SIZE, flag)
 #define rf_is_empty(f)         flag_is_empty(f, RF_SIZE)
@@ -35,6 +35,14 @@
 #define clean_shot(Y1, X1, Y2, X2) \
 	projectable(Y1, X1, Y2, X2, PROJECT_STOP)
 
+/*
+ * Monsters which can go through walls, and monsters which move erratically
+ */
+static const bitflag tunnellers[FLAG_MASK_MAX] =
+	FLAG_MASK(RF_PASS_WALL, RF_KILL_WALL);
+static const bitflag erratic[FLAG_MASK_MAX] =
+	FLAG_MASK(RF_RAND_25, RF_RAND_50);
+
 
 /*
  * And now for Intelligent monster attacks (including spells).
@@ -645,7 +653,7 @@ static bool get_moves_aux(struct cave *c, int m_idx, int *yp, int *xp)
 	monster_race *r_ptr = &r_info[m_ptr->r_idx];
 
 	/* Monster can go through rocks */
-	if (flags_test(r_ptr->flags, RF_SIZE, RF_PASS_WALL, RF_KILL_WALL, FLAG_END)){
+	if (rf_is_inter(r_ptr->flags, tunnellers)){
 	
 	    /* If monster is near a permwall, use normal pathfinding */
 	    if (!near_permwall(m_ptr, c)) return (FALSE);
@@ -1132,7 +1140,7 @@ static bool get_moves(struct cave *c, int m_idx, int mm[5])
 	/* Normal animal packs try to get the player out of corridors. */
 	if (OPT(birth_ai_packs) &&
 	    rf_has(r_ptr->flags, RF_FRIENDS) && rf_has(r_ptr->flags, RF_ANIMAL) &&
-	    !flags_test(r_ptr->flags, RF_SIZE, RF_PASS_WALL, RF_KILL_WALL, FLAG_END))
+	    !rf_is_inter(r_ptr->flags, tunnellers))
 	{
 		int i, open = 0;
 
@@ -3012,7 +3020,7 @@ static void process_monster(struct cave *c, int m_idx)
 				rf_on(l_ptr->flags, RF_RAND_25);
 
 			/* Stagger */
-			if (flags_test(r_ptr->flags, RF_SIZE, RF_RAND_25, RF_RAND_50, FLAG_END))
+			if (rf_is_inter(r_ptr->flags, erratic))
 				stagger = TRUE;
 
 		/* Random movement (50%) */
@@ -3028,7 +3036,7 @@ static void process_monster(struct cave *c, int m_idx)
 		/* Random movement (75%) */
 		} else if (roll < 75) {
 			/* Stagger */
-			if (flags_test_all(r_ptr->flags, RF_SIZE, RF_RAND_25, RF_RAND_50, FLAG_END))
+			if (rf_is_subset(r_ptr->flags, erratic))
 				stagger = TRUE;
 		}
 	}
@@ -3087,7 +3095,7 @@ static void process_monster(struct cave *c, int m_idx)
 				do_move = TRUE;
 
 				/* Forget the wall */
-				cave->info[ny][nx] &= ~(CAVE_MARK);
+				cave_forget(cave, ny, nx);
 
 				/* Notice */
 				cave_set_feat(c, ny, nx, FEAT_FLOOR);
@@ -3209,7 +3217,7 @@ static void process_monster(struct cave *c, int m_idx)
 					msg("The rune of protection is broken!");
 
 				/* Forget the rune */
-				cave->info[ny][nx] &= ~CAVE_MARK;
+				cave_forget(cave, ny, nx);
 
 				/* Break the rune */
 				cave_set_feat(c, ny, nx, FEAT_FLOOR);
@@ -554,7 +554,7 @@ static errr finish_parse_r(struct parser *p) {
 		mem_free(r);
 	}
 	z_info->r_max += 1;
-	eval_r_power(r_info);
+	init_r_power(r_info);
 
 	parser_destroy(p);
 	return 0;
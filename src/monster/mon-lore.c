@@ -2078,6 +2078,114 @@ void describe_monster(const monster_race *r_ptr, const monster_lore *l_ptr, bool
 
 
 
+/*
+ * Working out monster recall is slow, and the same recall gets shown over
+ * and over again (in the recall window, say, or while browsing the
+ * knowledge menus), so the recall for each race is kept in a textblock,
+ * along with everything that it was worked out from.  Once any of that has
+ * changed - most often the monster lore itself - it gets worked out again.
+ */
+struct lore_key {
+	monster_lore lore;
+	int melee_colors[RBE_MAX];
+	int spell_colors[RSF_MAX];
+	int chance;
+	s16b lev;
+	s16b max_depth;
+	byte max_num;	/* Whether a unique is shown as dead */
+	bool cheat_know;
+	bool small_range;
+};
+
+struct lore_cache_entry {
+	struct lore_key key;
+	textblock *tb;
+};
+
+static struct lore_cache_entry *lore_cache;
+
+/* The textblock that lore_text_out() is writing to */
+static textblock *lore_tb;
+
+static void lore_text_out(byte a, const char *str)
+{
+	textblock_append_c(lore_tb, a, "%s", str);
+}
+
+/*
+ * Get the recall for a race, working it out again if need be.  The
+ * textblock belongs to the cache.
+ */
+static textblock *lore_textblock(const monster_race *r_ptr,
+		const monster_lore *l_ptr)
+{
+	struct lore_cache_entry *entry;
+	struct lore_key key;
+	void (*old_hook)(byte a, const char *str) = text_out_hook;
+
+	if (!lore_cache)
+		lore_cache = mem_zalloc(z_info->r_max * sizeof(*lore_cache));
+	entry = &lore_cache[r_ptr->ridx];
+
+	/* Everything the recall depends on */
+	WIPE_KEY(&key);
+	COPY(&key.lore, l_ptr, monster_lore);
+	get_attack_colors(key.melee_colors, key.spell_colors);
+	key.chance = get_hit_chance(p_ptr->state, r_ptr);
+	key.lev = p_ptr->lev;
+	key.max_depth = p_ptr->max_depth;
+	key.max_num = r_ptr->max_num;
+	key.cheat_know = OPT(cheat_know);
+	key.small_range = OPT(birth_small_range);
+
+	if (entry->tb && !memcmp(&entry->key, &key, sizeof(key)))
+		return entry->tb;
+
+	if (entry->tb) textblock_free(entry->tb);
+	entry->tb = textblock_new();
+	entry->key = key;
+
+	lore_tb = entry->tb;
+	text_out_hook = lore_text_out;
+	describe_monster(r_ptr, l_ptr, FALSE);
+	text_out_hook = old_hook;
+	lore_tb = NULL;
+
+	return entry->tb;
+}
+
+/**
+ * Show the recall for a monster race at the cursor, as describe_monster()
+ * would with text_out_to_screen(), but without working it all out again
+ * if it hasn't changed since last time.
+ */
+void describe_monster_to_screen(const monster_race *r_ptr,
+		const monster_lore *l_ptr)
+{
+	assert(r_ptr);
+	assert(l_ptr);
+
+	textblock_to_screen(lore_textblock(r_ptr, l_ptr));
+}
+
+/**
+ * Free all the remembered monster recall.
+ */
+void free_lore_cache(void)
+{
+	int i;
+
+	if (!lore_cache) return;
+
+	for (i = 0; i < z_info->r_max; i++)
+		if (lore_cache[i].tb) textblock_free(lore_cache[i].tb);
+
+	mem_free(lore_cache);
+	lore_cache = NULL;
+}
+
+
+
 /**
  * Display the "name" and "attr/chars" of a monster race.
  */
@@ -2147,7 +2255,7 @@ void screen_roff(const monster_race *r_ptr, const monster_lore *l_ptr)
 	text_out_hook = text_out_to_screen;
 
 	/* Recall monster */
-	describe_monster(r_ptr, l_ptr, FALSE);
+	describe_monster_to_screen(r_ptr, l_ptr);
 
 	/* Describe monster */
 	roff_top(r_ptr);
@@ -2177,7 +2285,7 @@ void display_roff(const monster_race *r_ptr, const monster_lore *l_ptr)
 	text_out_hook = text_out_to_screen;
 
 	/* Recall monster */
-	describe_monster(r_ptr, l_ptr, FALSE);
+	describe_monster_to_screen(r_ptr, l_ptr);
 
 	/* Describe monster */
 	roff_top(r_ptr);
@@ -33,6 +33,8 @@
 void cheat_monster_lore(const monster_race *r_ptr, monster_lore *l_ptr);
 void wipe_monster_lore(const monster_race *r_ptr, monster_lore *l_ptr);
 void describe_monster(const monster_race *r_ptr, const monster_lore *l_ptr, bool spoilers);
+void describe_monster_to_screen(const monster_race *r_ptr, const monster_lore *l_ptr);
+void free_lore_cache(void);
 void roff_top(const monster_race *r_ptr);
 void screen_roff(const monster_race *r_ptr, const monster_lore *l_ptr);
 void display_roff(const monster_race *r_ptr, const monster_lore *l_ptr);
@@ -100,6 +100,7 @@ void delete_monster_idx(int m_idx)
 
 	/* Visual update */
 	cave_light_spot(cave, y, x);
+	monlist_changed(m_idx);
 }
 
 
@@ -180,6 +181,10 @@ static void compact_monsters_aux(int i1, int i2)
 
 	/* Hack -- wipe hole */
 	(void)WIPE(cave_monster(cave, i1), monster_type);
+
+	/* The monster list goes by index */
+	monlist_changed(i1);
+	monlist_changed(i2);
 }
 
 
@@ -315,6 +320,9 @@ void wipe_mon_list(struct cave *c, struct player *p)
 
 	/* Hack -- no more tracking */
 	health_track(p, 0);
+
+	/* Start the monster list afresh */
+	monlist_free();
 }
 
 /**
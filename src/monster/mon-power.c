@@ -17,6 +17,7 @@
  */
 
 #include "angband.h"
+#include "derived.h"
 #include "monster/mon-power.h"
 #include "monster/mon-spell.h"
 
@@ -677,3 +678,78 @@ for (iteration = 0; iteration < 3; iteration ++) {
 	/* Success */
 	return 0;
 }
+
+
+/*
+ * The results of eval_r_power() for one race, as kept in the derived
+ * table cache.
+ */
+struct r_power_entry {
+	s32b highest_threat;
+	s32b melee_dam;
+	s32b spell_dam;
+	s32b hp;
+	s32b mexp;
+	s32b power;
+	s32b scaled_power;
+	s32b level;
+	s32b rarity;
+};
+
+/**
+ * Set up monster power for `races`, from the derived table cache if it has
+ * an up to date copy, or else by eval_r_power().
+ */
+errr init_r_power(struct monster_race *races)
+{
+	size_t len = (z_info->r_max + 1) * sizeof(struct r_power_entry);
+	struct r_power_entry *entries = mem_zalloc(len);
+	int i;
+
+	if (!(derived_flags & DERIVED_CHECK) &&
+			derived_fetch(DERIVED_R_POWER, entries, len)) {
+		for (i = 0; i < z_info->r_max; i++) {
+			monster_race *r_ptr = &races[i];
+
+			r_ptr->highest_threat = entries[i].highest_threat;
+			r_ptr->melee_dam = entries[i].melee_dam;
+			r_ptr->spell_dam = entries[i].spell_dam;
+			r_ptr->hp = entries[i].hp;
+			r_ptr->mexp = entries[i].mexp;
+			r_ptr->power = entries[i].power;
+			r_ptr->scaled_power = entries[i].scaled_power;
+			r_ptr->level = entries[i].level;
+			r_ptr->rarity = entries[i].rarity;
+		}
+
+		tot_mon_power = entries[z_info->r_max].power;
+
+		mem_free(entries);
+		return 0;
+	}
+
+	eval_r_power(races);
+
+	for (i = 0; i < z_info->r_max; i++) {
+		monster_race *r_ptr = &races[i];
+
+		entries[i].highest_threat = r_ptr->highest_threat;
+		entries[i].melee_dam = r_ptr->melee_dam;
+		entries[i].spell_dam = r_ptr->spell_dam;
+		entries[i].hp = r_ptr->hp;
+		entries[i].mexp = r_ptr->mexp;
+		entries[i].power = r_ptr->power;
+		entries[i].scaled_power = r_ptr->scaled_power;
+		entries[i].level = r_ptr->level;
+		entries[i].rarity = r_ptr->rarity;
+	}
+
+	/* The extra entry at the end holds the total */
+	entries[z_info->r_max].power = tot_mon_power;
+
+	derived_check(DERIVED_R_POWER, entries, len);
+	derived_store(DERIVED_R_POWER, entries, len);
+
+	mem_free(entries);
+	return 0;
+}
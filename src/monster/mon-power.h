@@ -26,6 +26,7 @@ extern s32b tot_mon_power;
 
 /** Functions **/
 errr eval_r_power(struct monster_race *races);
+errr init_r_power(struct monster_race *races);
 
 
 #endif /* MONSTER_POWER_H */
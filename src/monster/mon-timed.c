@@ -208,6 +208,7 @@ static bool mon_set_timed(monster_type *m_ptr, int ef_idx, int timer,
 
 	/* Update the visuals, as appropriate. */
 	p_ptr->redraw |= (PR_MONLIST);
+	monlist_changed(m_ptr->midx);
 
 	/* Print a message if there is one, if the effect allows for it, and if
 	 * either the monster is visible, or we're trying to ID something */
@@ -293,15 +293,198 @@ typedef struct
 	u16b los;		/* number in LOS */
 	u16b los_asleep;	/* number asleep and in LOS */
 	byte attr; /* attr to use for drawing */
+	s16b first;		/* lowest m_idx of this race in the list */
 } monster_vis; 
 
+/*
+ * What a single monster adds to the list
+ */
+struct monlist_seen {
+	u16b r_idx;		/* race, or 0 if not listed */
+	bool los;
+	bool asleep;
+};
+
+/*
+ * The visible monster list is kept from one redraw to the next.  The
+ * places which change whether or how a monster is listed (update_mon(),
+ * sleep, awareness and death) queue it with monlist_changed(), and an
+ * update only looks at the queued monsters, adjusting the per-race counts
+ * and the sorted order of races as they come into and go out of view.
+ */
+static struct {
+	monster_vis *vis;			/* per-race totals, by r_idx */
+	u16b *order;				/* races with any monsters listed */
+	unsigned types;				/* number of entries in order[] */
+	struct monlist_seen *seen;	/* per-monster entries, by m_idx */
+	unsigned total;				/* monsters listed */
+	unsigned los;				/* monsters listed in LOS */
+	s16b *queue;				/* monsters to look at again */
+	unsigned queued;
+	bool *in_queue;				/* by m_idx */
+} monlist;
+
+/*
+ * Whether race `a` comes before race `b` in the list: deeper races first,
+ * then more powerful ones, then in monster.txt order
+ */
+static bool monlist_before(u16b a, u16b b)
+{
+	const monster_race *ra = &r_info[a];
+	const monster_race *rb = &r_info[b];
+
+	if (ra->level != rb->level)
+		return ra->level > rb->level;
+	if (ra->power != rb->power)
+		return ra->power > rb->power;
+	return a < b;
+}
+
+/*
+ * Add or take away the entry in the list for monster `m_idx`.
+ */
+static void monlist_count(const struct monlist_seen *seen, int m_idx,
+		int sign)
+{
+	monster_vis *v = &monlist.vis[seen->r_idx];
+	unsigned i;
+
+	/* Races are kept in order as they come and go */
+	if (sign > 0 && !v->count) {
+		for (i = monlist.types; i > 0; i--) {
+			if (!monlist_before(seen->r_idx, monlist.order[i - 1]))
+				break;
+			monlist.order[i] = monlist.order[i - 1];
+		}
+		monlist.order[i] = seen->r_idx;
+		monlist.types++;
+	}
+
+	/* Keep track of the first monster of each race, for its colour */
+	if (sign > 0 && (!v->count || m_idx < v->first))
+		v->first = m_idx;
+
+	v->count += sign;
+	monlist.total += sign;
+	if (seen->los) {
+		v->los += sign;
+		monlist.los += sign;
+		if (seen->asleep) v->los_asleep += sign;
+	} else if (seen->asleep) {
+		v->asleep += sign;
+	}
+
+	if (sign < 0 && !v->count) {
+		for (i = 0; monlist.order[i] != seen->r_idx; i++) ;
+		monlist.types--;
+		memmove(&monlist.order[i], &monlist.order[i + 1],
+				(monlist.types - i) * sizeof(monlist.order[0]));
+	} else if (sign < 0 && m_idx == v->first) {
+		for (i = m_idx + 1; monlist.seen[i].r_idx != seen->r_idx; i++) ;
+		v->first = i;
+	}
+}
+
+/*
+ * Note that monster `m_idx` may have come into or gone out of view, or
+ * changed in some way which shows in the monster list.
+ */
+void monlist_changed(int m_idx)
+{
+	if (!monlist.vis || m_idx <= 0 || m_idx >= z_info->m_max ||
+			monlist.in_queue[m_idx])
+		return;
+
+	monlist.in_queue[m_idx] = TRUE;
+	monlist.queue[monlist.queued++] = m_idx;
+}
+
+/*
+ * Bring the visible monster list up to date.
+ */
+static void monlist_update(void)
+{
+	unsigned n;
+	int i;
+
+	/* Start by looking at every monster */
+	if (!monlist.vis) {
+		monlist.vis = C_ZNEW(z_info->r_max, monster_vis);
+		monlist.order = C_ZNEW(z_info->r_max, u16b);
+		monlist.seen = C_ZNEW(z_info->m_max, struct monlist_seen);
+		monlist.queue = C_ZNEW(z_info->m_max, s16b);
+		monlist.in_queue = C_ZNEW(z_info->m_max, bool);
+
+		for (i = 1; i < cave_monster_max(cave); i++)
+			monlist_changed(i);
+	}
+
+	for (n = 0; n < monlist.queued; n++) {
+		struct monlist_seen now = { 0, FALSE, FALSE };
+		struct monlist_seen *was;
+
+		i = monlist.queue[n];
+		was = &monlist.seen[i];
+		monlist.in_queue[i] = FALSE;
+
+		if (i < cave_monster_max(cave)) {
+			monster_type *m_ptr = cave_monster(cave, i);
+
+			/* Only consider visible, known monsters */
+			if (m_ptr->r_idx && m_ptr->ml && !m_ptr->unaware) {
+				now.r_idx = m_ptr->r_idx;
+				now.asleep = m_ptr->m_timed[MON_TMD_SLEEP] ? TRUE : FALSE;
+
+				/* Check for LOS
+				 * Hack - we should use (m_ptr->mflag & (MFLAG_VIEW)) here,
+				 * but this does not catch monsters detected by ESP which are
+				 * targetable, so we cheat and use projectable() instead 
+				 */
+				now.los = projectable(p_ptr->py, p_ptr->px, m_ptr->fy,
+						m_ptr->fx, PROJECT_NONE);
+			}
+		}
+
+		/* Only changes touch the totals */
+		if (now.r_idx == was->r_idx && now.los == was->los &&
+				now.asleep == was->asleep)
+			continue;
+
+		if (was->r_idx) monlist_count(was, i, -1);
+		*was = now;
+		if (now.r_idx) monlist_count(&now, i, 1);
+	}
+
+	monlist.queued = 0;
+
+	/* Draw each race in the colour of its first monster */
+	for (n = 0; n < monlist.types; n++) {
+		monster_vis *v = &monlist.vis[monlist.order[n]];
+		monster_type *m_ptr = cave_monster(cave, v->first);
+
+		v->attr = m_ptr->attr ? m_ptr->attr : r_info[m_ptr->r_idx].x_attr;
+	}
+}
+
+/*
+ * Free the visible monster list
+ */
+void monlist_free(void)
+{
+	FREE(monlist.vis);
+	FREE(monlist.order);
+	FREE(monlist.seen);
+	FREE(monlist.queue);
+	FREE(monlist.in_queue);
+	memset(&monlist, 0, sizeof(monlist));
+}
+
 /*
  * Display visible monsters in a window
  */
 void display_monlist(void)
 {
-	int ii;
-	size_t i, j, k;
+	size_t i;
 	int max;
 	int line = 1, x = 0;
 	int cur_x;
@@ -312,9 +495,7 @@ void display_monlist(void)
 	char m_name[80];
 	char buf[80];
 
-	monster_type *m_ptr;
 	monster_race *r_ptr;
-	monster_race *r2_ptr;
 
 	monster_vis *list;
 
@@ -343,50 +524,13 @@ void display_monlist(void)
 		max = Term->hgt - 2;
 	}
 
-	/* Allocate the primary array */
-	list = C_ZNEW(z_info->r_max, monster_vis);
-
-	/* Scan the list of monsters on the level */
-	for (ii = 1; ii < cave_monster_max(cave); ii++) {
-		monster_vis *v;
-
-		m_ptr = cave_monster(cave, ii);
-		r_ptr = &r_info[m_ptr->r_idx];
-
-		/* Only consider visible, known monsters */
-		if (!m_ptr->ml || m_ptr->unaware) continue;
-
-		/* Take a pointer to this monster visibility entry */
-		v = &list[m_ptr->r_idx];
-
-		/* Note each monster type and save its display attr (color) */
-		if (!v->count) type_count++;
-		if (!v->attr) v->attr = m_ptr->attr ? m_ptr->attr : r_ptr->x_attr;
-		
-		/* Check for LOS
-		 * Hack - we should use (m_ptr->mflag & (MFLAG_VIEW)) here,
-		 * but this does not catch monsters detected by ESP which are
-		 * targetable, so we cheat and use projectable() instead 
-		 */
-		if (projectable(p_ptr->py, p_ptr->px, m_ptr->fy, m_ptr->fx,
-			PROJECT_NONE))
-		{
-			/* Increment the total number of in-LOS monsters */
-			los_count++;
-
-			/* Increment the LOS count for this monster type */
-			v->los++;
-			
-			/* Check if asleep and increment accordingly */
-			if (m_ptr->m_timed[MON_TMD_SLEEP]) v->los_asleep++;
-		}
-		/* Not in LOS so increment if asleep */
-		else if (m_ptr->m_timed[MON_TMD_SLEEP]) v->asleep++;
-
-		/* Bump the count for this race, and the total count */
-		v->count++;
-		total_count++;
-	}
+	/* Catch up with what's changed since last time */
+	monlist_update();
+	list = monlist.vis;
+	order = monlist.order;
+	type_count = monlist.types;
+	total_count = monlist.total;
+	los_count = monlist.los;
 
 	/* Note no visible monsters at all */
 	if (!total_count)
@@ -396,59 +540,10 @@ void display_monlist(void)
 		if (!in_term)
 		    Term_addstr(-1, TERM_WHITE, "  (Press any key to continue.)");
 
-		/* Free up memory */
-		FREE(list);
-
 		/* Done */
 		return;
 	}
 
-	/* Allocate the secondary array */
-	order = C_ZNEW(type_count, u16b);
-
-	/* Sort, because we cannot rely on monster.txt being ordered */
-
-	/* Populate the ordered array, starting at 1 to ignore @ */
-	for (i = 1; i < z_info->r_max; i++)
-	{
-		/* No monsters of this race are visible */
-		if (!list[i].count) continue;
-
-		/* Get the monster info */
-		r_ptr = &r_info[i];
-
-		/* Fit this monster into the sorted array */
-		for (j = 0; j < type_count; j++)
-		{
-			/* If we get to the end of the list, put this one in */
-			if (!order[j])
-			{
-				order[j] = i;
-				break;
-			}
-
-			/* Get the monster info for comparison */
-			r2_ptr = &r_info[order[j]];
-
-			/* Monsters are sorted by depth */
-			/* Monsters of same depth are sorted by power */
-			if ((r_ptr->level > r2_ptr->level) ||
-				((r_ptr->level == r2_ptr->level) &&
-				(r_ptr->power > r2_ptr->power)))
-			{
-				/* Move weaker monsters down the array */
-				for (k = type_count - 1; k > j; k--)
-				{
-					order[k] = order[k - 1];
-				}
-
-				/* Put current monster in the right place */
-				order[j] = i;
-				break;
-			}
-		}
-	}
-
 	/* Message for monsters in LOS - even if there are none */
 	if (!los_count) prt(format("You can see no monsters."), 0, 0);
 	else prt(format("You can see %d monster%s", los_count, (los_count == 1
@@ -601,10 +696,6 @@ void display_monlist(void)
 
 	if (!in_term)
 		Term_addstr(-1, TERM_WHITE, "  (Press any key to continue.)");
-
-	/* Free the arrays */
-	FREE(list);
-	FREE(order);
 }
 
 
@@ -867,10 +958,14 @@ void update_mon(int m_idx, bool full)
 	/* Seen by vision */
 	bool easy = FALSE;
 
+	/* Seen before */
+	bool old_ml;
+
 	assert(m_idx > 0);
 	m_ptr = cave_monster(cave, m_idx);
 	r_ptr = &r_info[m_ptr->r_idx];
 	l_ptr = &l_list[m_ptr->r_idx];
+	old_ml = m_ptr->ml;
 	
 	fy = m_ptr->fy;
 	fx = m_ptr->fx;
@@ -1074,6 +1169,10 @@ void update_mon(int m_idx, bool full)
 			p_ptr->redraw |= PR_MONLIST;
 		}
 	}
+
+	/* Either the monster or the player may have moved in or out of LOS */
+	if (m_ptr->ml || old_ml)
+		monlist_changed(m_idx);
 }
 
 
@@ -1286,6 +1385,9 @@ static int summon_specific_type = 0;
  */
 static bool summon_specific_okay(int r_idx)
 {
+	static const bitflag scary_flags[FLAG_MASK_MAX] =
+		FLAG_MASK(RF_UNIQUE, RF_FRIEND, RF_FRIENDS, RF_ESCORT, RF_ESCORTS);
+
 	const monster_race *r_ptr;
 	const bitflag *flags;
 	const struct monster_base *base;
@@ -1299,8 +1401,7 @@ static bool summon_specific_okay(int r_idx)
 	base = r_ptr->base;
 	
 	unique = rf_has(flags, RF_UNIQUE);
-	scary = flags_test(flags, RF_SIZE, RF_UNIQUE, RF_FRIEND, RF_FRIENDS,
-			RF_ESCORT, RF_ESCORTS, FLAG_END);
+	scary = rf_is_inter(flags, scary_flags);
 
 	/* Check our requirements */
 	switch (summon_specific_type)
@@ -1481,6 +1582,7 @@ void become_aware(struct monster *m_ptr)
 
 	if (m_ptr->unaware) {
 		m_ptr->unaware = FALSE;
+		monlist_changed(m_ptr->midx);
 
 		/* Learn about mimicry */
 		if (rf_has(r_ptr->flags, RF_UNAWARE))
@@ -51,6 +51,8 @@ monster_base *lookup_monster_base(const char *name);
 bool match_monster_bases(const monster_base *base, ...);
 void plural_aux(char *name, size_t max);
 void display_monlist(void);
+void monlist_changed(int m_idx);
+void monlist_free(void);
 void monster_desc(char *desc, size_t max, const monster_type *m_ptr, int mode);
 void update_mon(int m_idx, bool full);
 void update_monsters(bool full);
@@ -30,6 +30,23 @@
 /** Time last item was wielded */
 s32b object_last_wield;
 
+/*
+ * Serial number of what the player knows about objects.  The map view is
+ * cached against it, so anything which teaches the player something that
+ * changes how objects are shown must move it on.
+ */
+u32b object_knowledge = 1;
+
+/**
+ * Note that the player has learnt something about objects.
+ */
+void object_knowledge_changed(void)
+{
+	/* Never 0, which marks an empty cache */
+	if (!++object_knowledge)
+		object_knowledge = 1;
+}
+
 /*** Knowledge accessor functions ***/
 
 
@@ -397,6 +414,7 @@ static bool object_add_ident_flags(object_type *o_ptr, u32b flags)
 	if ((o_ptr->ident & flags) != flags)
 	{
 		o_ptr->ident |= flags;
+		object_knowledge_changed();
 		return TRUE;
 	}
 
@@ -462,6 +480,7 @@ void object_flavor_aware(object_type *o_ptr)
 
 	if (o_ptr->kind->aware) return;
 	o_ptr->kind->aware = TRUE;
+	object_knowledge_changed();
 
 	/* Fix squelch/autoinscribe */
 	if (kind_is_squelched_unaware(o_ptr->kind)) {
@@ -493,7 +512,9 @@ void object_flavor_tried(object_type *o_ptr)
 	assert(o_ptr);
 	assert(o_ptr->kind);
 
+	if (o_ptr->kind->tried) return;
 	o_ptr->kind->tried = TRUE;
+	object_knowledge_changed();
 }
 
 /**
@@ -505,6 +526,7 @@ void object_know_all_flags(object_type *o_ptr)
 {
 	of_setall(o_ptr->known_flags);
 	of_union(p_ptr->known_runes, o_ptr->flags);
+	object_knowledge_changed();
 }
 
 
@@ -689,6 +711,7 @@ bool object_notice_flag(object_type *o_ptr, int flag, bool present)
 {
 	if (!of_has(o_ptr->known_flags, flag)) {
 		of_on(o_ptr->known_flags, flag);
+		object_knowledge_changed();
 
 		if (present)
 			of_on(p_ptr->known_runes, flag);
@@ -715,6 +738,7 @@ bool object_notice_flags(object_type *o_ptr, bitflag flags[OF_SIZE],
 	if (!of_is_subset(o_ptr->known_flags, flags))
 	{
 		of_union(o_ptr->known_flags, flags);
+		object_knowledge_changed();
 		if (present)
 			of_union(p_ptr->known_runes, flags);
 		/* XXX Eddie don't want infinite recursion if object_check_for_ident sets more flags,
@@ -845,6 +869,7 @@ void object_notice_on_wield(object_type *o_ptr)
 	/* Learn about obvious flags */
 	of_inter(f, obvious_mask);
 	of_union(o_ptr->known_flags, f);
+	object_knowledge_changed();
 
 	/* XXX Eddie should these next NOT call object_check_for_ident due to worries about repairing? */
 
@@ -672,6 +672,145 @@ static size_t obj_desc_aware(const object_type *o_ptr, char *buf, size_t max,
 }
 
 
+/*
+ * Descriptions are remembered in a small table, keyed on the object and the
+ * mode, so that the same few objects can be described again and again (as
+ * the inventory and the object list are) without building the text each
+ * time.  Each set holds the last DESC_MEMO_WAYS descriptions which hashed
+ * to it, most recent first.
+ */
+#define DESC_MEMO_SETS	64
+#define DESC_MEMO_WAYS	4
+
+/*
+ * What a description was worked out from.  Everything that object_desc()
+ * looks at is here, so a description whose key matches can be reused even
+ * if the object has since been deleted and its slot reused.
+ */
+struct desc_key {
+	const object_type *obj;
+	u16b mode;
+	bool flavors;		/* OPT(show_flavors) */
+	bool squelched;
+	bool aware;		/* The kind's flavour is known */
+	bool tried;
+	struct object_kind *kind;
+	struct ego_item *ego;
+	struct ego_item *prefix;
+	struct ego_item *suffix;
+	struct theme *theme;
+	struct artifact *artifact;
+	u16b ident;
+	bitflag flags[OF_SIZE];
+	bitflag known_flags[OF_SIZE];
+	byte number;
+	quark_t note;
+	s16b timeout;
+	s32b extent;
+	s16b ac, to_a, to_finesse, to_prowess;
+	byte dd, ds;
+	s16b pval[MAX_PVALS];
+	byte num_pvals;
+};
+
+struct desc_memo {
+	struct desc_key key;
+	byte len;
+	char text[80];
+};
+
+static struct desc_memo desc_memo[DESC_MEMO_SETS][DESC_MEMO_WAYS];
+
+/*
+ * Work out what `o_ptr`'s description in the given mode depends on.
+ *
+ * What the player knows about the object is in its ident and known flags,
+ * and in whether its flavour is aware or tried; the rest is what can
+ * change on the object itself (stack size, inscription, charges,
+ * enchantment and so on).
+ */
+static void obj_desc_key(struct desc_key *key, const object_type *o_ptr,
+		odesc_detail_t mode)
+{
+	WIPE_KEY(key);
+
+	key->obj = o_ptr;
+	key->mode = mode;
+	key->flavors = OPT(show_flavors);
+	if ((mode & ODESC_EXTRA) && !(mode & ODESC_STORE))
+		key->squelched = squelch_item_ok(o_ptr);
+	key->aware = o_ptr->kind->aware;
+	key->tried = o_ptr->kind->tried;
+	key->kind = o_ptr->kind;
+	key->ego = o_ptr->ego;
+	key->prefix = o_ptr->prefix;
+	key->suffix = o_ptr->suffix;
+	key->theme = o_ptr->theme;
+	key->artifact = o_ptr->artifact;
+	key->ident = o_ptr->ident;
+	of_copy(key->flags, o_ptr->flags);
+	of_copy(key->known_flags, o_ptr->known_flags);
+	key->number = o_ptr->number;
+	key->note = o_ptr->note;
+	key->timeout = o_ptr->timeout;
+	key->extent = o_ptr->extent;
+	key->ac = o_ptr->ac;
+	key->to_a = o_ptr->to_a;
+	key->to_finesse = o_ptr->to_finesse;
+	key->to_prowess = o_ptr->to_prowess;
+	key->dd = o_ptr->dd;
+	key->ds = o_ptr->ds;
+	memcpy(key->pval, o_ptr->pval, sizeof(key->pval));
+	key->num_pvals = o_ptr->num_pvals;
+}
+
+/*
+ * Find the set of remembered descriptions for an object and mode.
+ */
+static struct desc_memo *desc_memo_set(const object_type *o_ptr,
+		odesc_detail_t mode)
+{
+	u32b h = (u32b)((size_t)o_ptr / sizeof(object_type)) * 31 + mode;
+
+	return desc_memo[(h ^ (h >> 6)) % DESC_MEMO_SETS];
+}
+
+/*
+ * Look for a remembered description matching `key`.
+ */
+static const struct desc_memo *desc_memo_find(const struct desc_key *key)
+{
+	struct desc_memo *set = desc_memo_set(key->obj, key->mode);
+	int i;
+
+	for (i = 0; i < DESC_MEMO_WAYS; i++)
+		if (!memcmp(&set[i].key, key, sizeof(*key)))
+			return &set[i];
+
+	return NULL;
+}
+
+/*
+ * Remember a description, in place of any older one of the same object in
+ * the same mode, or else of the least recent one in its set.
+ */
+static void desc_memo_add(const struct desc_key *key, const char *buf,
+		size_t len)
+{
+	struct desc_memo *set = desc_memo_set(key->obj, key->mode);
+	int i;
+
+	for (i = 0; i < DESC_MEMO_WAYS - 1; i++)
+		if (set[i].key.obj == key->obj && set[i].key.mode == key->mode)
+			break;
+
+	memmove(&set[1], &set[0], i * sizeof(set[0]));
+	memcpy(&set[0].key, key, sizeof(*key));
+	memcpy(set[0].text, buf, len + 1);
+	set[0].len = len;
+}
+
+
 /**
  * Describes item `o_ptr` into buffer `buf` of size `max`.
  *
@@ -692,6 +831,9 @@ size_t object_desc(char *buf, size_t max, const object_type *o_ptr,
 	bool spoil = mode & ODESC_SPOIL;
 /*	bool known; */
 
+	const struct desc_memo *memo;
+	struct desc_key key;
+
 	size_t end = 0, i = 0;
 
 	/* FIXME - this is for testing */
@@ -719,6 +861,14 @@ size_t object_desc(char *buf, size_t max, const object_type *o_ptr,
 				o_ptr->extent, o_ptr->kind->name,
 				squelch_item_ok(o_ptr) ? " {squelch}" : "");
 
+	/* Reuse the last description if nothing it depends on has changed */
+	obj_desc_key(&key, o_ptr, mode);
+	memo = desc_memo_find(&key);
+	if (memo && memo->len < max) {
+		memcpy(buf, memo->text, memo->len + 1);
+		return memo->len;
+	}
+
 	/** Construct the name **/
 
 	/* Copy the base name to the buffer */
@@ -750,6 +900,10 @@ size_t object_desc(char *buf, size_t max, const object_type *o_ptr,
 			end = obj_desc_inscrip(o_ptr, buf, max, end);
 	}
 
+	/* Remember it, unless it was cut short */
+	if (end + 1 < max && end < sizeof(memo->text))
+		desc_memo_add(&key, buf, end);
+
 	return end;
 }
 
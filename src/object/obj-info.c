@@ -1161,9 +1161,20 @@ static bool describe_ego(textblock *tb, const struct ego_item *ego)
 
 
 /*
- * Output object information
+ * Text which only goes straight out to a file, as in character dumps and
+ * spoilers, is put together in here, and given back as soon as it's been
+ * written.
  */
-static textblock *object_info_out(const object_type *o_ptr, oinfo_detail_t mode)
+static struct mem_arena *dump_arena;
+
+#define DUMP_ARENA_BLOCK	32768
+
+/*
+ * Output object information, into a textblock made in `a` (or on the heap
+ * if that's NULL)
+ */
+static textblock *object_info_out(const object_type *o_ptr, oinfo_detail_t mode,
+		struct mem_arena *a)
 {
 	bitflag flags[OF_SIZE];
 	bitflag pval_flags[MAX_PVALS][OF_SIZE];
@@ -1175,7 +1186,7 @@ static textblock *object_info_out(const object_type *o_ptr, oinfo_detail_t mode)
 	bool subjective = mode & OINFO_SUBJ;
 	bool ego = mode & OINFO_EGO;
 
-	textblock *tb = textblock_new();
+	textblock *tb = textblock_new_in(a);
 
 	/* Grab the object flags */
 	if (full) {
@@ -1253,7 +1264,7 @@ static textblock *object_info_out(const object_type *o_ptr, oinfo_detail_t mode)
 textblock *object_info(const object_type *o_ptr, oinfo_detail_t mode)
 {
 	mode |= OINFO_SUBJ;
-	return object_info_out(o_ptr, mode);
+	return object_info_out(o_ptr, mode, NULL);
 }
 
 /**
@@ -1279,7 +1290,7 @@ textblock *object_info_ego(struct ego_item *ego)
 	obj.affix[0] = ego;
 	ego_apply_magic(&obj, 0, ego->eidx);
 
-	return object_info_out(&obj, OINFO_FULL | OINFO_EGO | OINFO_DUMMY);
+	return object_info_out(&obj, OINFO_FULL | OINFO_EGO | OINFO_DUMMY, NULL);
 }
 
 /**
@@ -1305,7 +1316,25 @@ textblock *object_info_theme(struct theme *theme)
 	obj.sval = kind->sval;
 	obj_apply_theme(&obj, 0, theme->index);
 
-	return object_info_out(&obj, OINFO_FULL | OINFO_EGO | OINFO_DUMMY);
+	return object_info_out(&obj, OINFO_FULL | OINFO_EGO | OINFO_DUMMY, NULL);
+}
+
+/*
+ * Write information on an item straight out to a file.
+ */
+static void object_info_to_file(ang_file *f, const object_type *o_ptr,
+		oinfo_detail_t mode, int indent, int wrap)
+{
+	struct mem_arena_mark mark;
+	textblock *tb;
+
+	if (!dump_arena) dump_arena = mem_arena_new(DUMP_ARENA_BLOCK);
+	mark = mem_arena_mark(dump_arena);
+
+	tb = object_info_out(o_ptr, mode, dump_arena);
+	textblock_to_file(tb, f, indent, wrap);
+
+	mem_arena_release(dump_arena, mark);
 }
 
 /**
@@ -1313,9 +1342,7 @@ textblock *object_info_theme(struct theme *theme)
  */
 void object_info_chardump(ang_file *f, const object_type *o_ptr, int indent, int wrap)
 {
-	textblock *tb = object_info_out(o_ptr, OINFO_TERSE | OINFO_SUBJ);
-	textblock_to_file(tb, f, indent, wrap);
-	textblock_free(tb);
+	object_info_to_file(f, o_ptr, OINFO_TERSE | OINFO_SUBJ, indent, wrap);
 }
 
 
@@ -1327,7 +1354,14 @@ void object_info_chardump(ang_file *f, const object_type *o_ptr, int indent, int
  */
 void object_info_spoil(ang_file *f, const object_type *o_ptr, int wrap)
 {
-	textblock *tb = object_info_out(o_ptr, OINFO_FULL);
-	textblock_to_file(tb, f, 0, wrap);
-	textblock_free(tb);
+	object_info_to_file(f, o_ptr, OINFO_FULL, 0, wrap);
+}
+
+/**
+ * Free the memory used for writing object information to files.
+ */
+void free_obj_info(void)
+{
+	mem_arena_free(dump_arena);
+	dump_arena = NULL;
 }
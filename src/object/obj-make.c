@@ -18,6 +18,7 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "derived.h"
 #include "object/tvalsval.h"
 #include "object/pval.h"
 #include "object/slays.h"
@@ -843,6 +844,38 @@ static byte *obj_alloc_great;
 /* Don't worry about probabilities for anything past dlev100 */
 #define MAX_O_DEPTH		100
 
+/*
+ * Copy the allocation tables to or from `buf`, laid out as the two totals
+ * tables followed by the two allocation tables, as kept in the derived
+ * table cache.
+ */
+static size_t obj_alloc_copy(byte *buf, bool save)
+{
+	size_t total_len = (MAX_O_DEPTH + 1) * sizeof(u32b);
+	size_t alloc_len = (MAX_O_DEPTH + 1) * z_info->k_max;
+	void *parts[4];
+	size_t lens[4];
+	size_t pos = 0;
+	int i;
+
+	parts[0] = obj_total;
+	parts[1] = obj_total_great;
+	parts[2] = obj_alloc;
+	parts[3] = obj_alloc_great;
+	lens[0] = lens[1] = total_len;
+	lens[2] = lens[3] = alloc_len;
+
+	for (i = 0; i < 4; i++) {
+		if (buf && save)
+			memcpy(buf + pos, parts[i], lens[i]);
+		else if (buf)
+			memcpy(parts[i], buf + pos, lens[i]);
+		pos += lens[i];
+	}
+
+	return pos;
+}
+
 /*
  * Using k_info[], init rarity data for the entire dungeon.
  */
@@ -850,15 +883,28 @@ bool init_obj_alloc(void)
 {
 	int k_max = z_info->k_max;
 	int item, lev;
+	size_t len;
+	byte *buf;
 
 
 	/* Free obj_allocs if allocated */
 	FREE(obj_alloc);
+	FREE(obj_alloc_great);
 
 	/* Allocate and wipe */
 	obj_alloc = C_ZNEW((MAX_O_DEPTH + 1) * k_max, byte);
 	obj_alloc_great = C_ZNEW((MAX_O_DEPTH + 1) * k_max, byte);
 
+	/* Use the cached tables if they're up to date */
+	len = obj_alloc_copy(NULL, FALSE);
+	buf = mem_zalloc(len);
+	if (!(derived_flags & DERIVED_CHECK) &&
+			derived_fetch(DERIVED_OBJ_ALLOC, buf, len)) {
+		obj_alloc_copy(buf, FALSE);
+		mem_free(buf);
+		return TRUE;
+	}
+
 	/* Wipe the totals */
 	C_WIPE(obj_total, MAX_O_DEPTH + 1, u32b);
 	C_WIPE(obj_total_great, MAX_O_DEPTH + 1, u32b);
@@ -892,6 +938,12 @@ bool init_obj_alloc(void)
 		}
 	}
 
+	/* Remember them for next time */
+	obj_alloc_copy(buf, TRUE);
+	derived_check(DERIVED_OBJ_ALLOC, buf, len);
+	derived_store(DERIVED_OBJ_ALLOC, buf, len);
+	mem_free(buf);
+
 	return TRUE;
 }
 
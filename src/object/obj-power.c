@@ -219,20 +219,130 @@ static int bow_multiplier(int sval)
 	return mult;
 }
 
+/**
+ * Cache of object power values.
+ *
+ * Lots of objects come out with the same power-relevant content - the same
+ * kind, plusses, flags and pvals - so the result of object_power() is kept
+ * against all of that.  The cache is direct-mapped: a new entry just takes
+ * over its slot from whatever was there before.
+ */
+#define POWER_CACHE_SIZE	1024
+
+struct power_key {
+	bool known;
+	bool ego;
+	bool effect_known;
+	struct object_kind *kind;
+	u16b effect;
+	s16b weight;
+	s16b ac, to_a, to_finesse, to_prowess;
+	byte dd, ds;
+	bitflag flags[OF_SIZE];
+	byte num_pvals;
+	bool pval_visible[MAX_PVALS];
+	s16b pval[MAX_PVALS];
+	bitflag pval_flags[MAX_PVALS][OF_SIZE];
+};
+
+static struct power_cache_entry {
+	struct power_key key;
+	s32b power;
+	bool used;
+} *power_cache;
+
+static u32b power_cache_hits;
+static u32b power_cache_misses;
+
+/*
+ * Work out what object_power() on `o_ptr` depends on, given the flags it
+ * is going to use.
+ */
+static void power_key(struct power_key *key, const object_type *o_ptr,
+	const bitflag flags[OF_SIZE], bool known)
+{
+	int i;
+
+	WIPE_KEY(key);
+
+	key->known = known;
+	key->ego = o_ptr->ego ? TRUE : FALSE;
+	key->effect_known = known || object_effect_is_known(o_ptr);
+	key->kind = o_ptr->kind;
+
+	/* Artifacts can be rewritten, so note the effect rather than which one */
+	if (o_ptr->artifact && o_ptr->artifact->effect)
+		key->effect = o_ptr->artifact->effect;
+	else
+		key->effect = o_ptr->kind->effect;
+
+	key->weight = o_ptr->weight;
+	key->ac = o_ptr->ac;
+	key->to_a = o_ptr->to_a;
+	key->to_finesse = o_ptr->to_finesse;
+	key->to_prowess = o_ptr->to_prowess;
+	key->dd = o_ptr->dd;
+	key->ds = o_ptr->ds;
+	of_copy(key->flags, flags);
+
+	key->num_pvals = o_ptr->num_pvals;
+	for (i = 0; i < o_ptr->num_pvals && i < MAX_PVALS; i++) {
+		key->pval_visible[i] = known || object_this_pval_is_visible(o_ptr, i);
+		key->pval[i] = o_ptr->pval[i];
+		of_copy(key->pval_flags[i], o_ptr->pval_flags[i]);
+	}
+}
+
+static struct power_cache_entry *power_cache_slot(const struct power_key *key)
+{
+	const byte *b = (const byte *)key;
+	u32b hash = 2166136261UL;
+	size_t i;
+
+	if (!power_cache)
+		power_cache = C_ZNEW(POWER_CACHE_SIZE, struct power_cache_entry);
+
+	for (i = 0; i < sizeof(*key); i++)
+		hash = (hash ^ b[i]) * 16777619UL;
+
+	return &power_cache[hash % POWER_CACHE_SIZE];
+}
+
+/**
+ * Get rid of the power cache, and reset the hit and miss counts.
+ */
+void free_power_cache(void)
+{
+	FREE(power_cache);
+	power_cache_hits = 0;
+	power_cache_misses = 0;
+}
+
+/**
+ * Report how many object_power() calls have been answered from the cache,
+ * and how many had to be worked out.
+ */
+void power_cache_counts(u32b *hits, u32b *misses)
+{
+	if (hits) *hits = power_cache_hits;
+	if (misses) *misses = power_cache_misses;
+}
+
+static s32b object_power_aux(const object_type *o_ptr, int verbose,
+	ang_file *log_file, bool known, bitflag flags[OF_SIZE]);
+
 /*
  * Evaluate the object's overall power level.
+ *
+ * Unless a verbose log has been asked for, the answer comes from the power
+ * cache if this exact combination has been seen before.
  */
 s32b object_power(const object_type* o_ptr, int verbose, ang_file *log_file,
 	bool known)
 {
-	s32b p = 0, q = 0, slay_pwr = 0, dice_pwr = 0;
-	unsigned int i, j;
-	int extra_stat_bonus = 0, mult = 1, num_slays = 0, k = 1;
-	bitflag flags[OF_SIZE], mask[OF_SIZE];
-
-	/* Zero the flag counts */
-	for (i = 0; i < N_ELEMENTS(sets); i++)
-		sets[i].count = 0;
+	bitflag flags[OF_SIZE];
+	struct power_key key;
+	struct power_cache_entry *entry;
 
 	/* Extract the flags */
 	if (known) {
@@ -243,6 +353,41 @@ s32b object_power(const object_type* o_ptr, int verbose, ang_file *log_file,
 		object_flags_known(o_ptr, flags);
 	}
 
+	if (verbose)
+		return object_power_aux(o_ptr, verbose, log_file, known, flags);
+
+	/* Look in the cache to see if we know this one yet */
+	power_key(&key, o_ptr, flags, known);
+	entry = power_cache_slot(&key);
+	if (entry->used && !memcmp(&key, &entry->key, sizeof(key))) {
+		power_cache_hits++;
+		file_putf(log_file, "Power cache hit, power is %d\n", entry->power);
+		return entry->power;
+	}
+
+	power_cache_misses++;
+	entry->key = key;
+	entry->power = object_power_aux(o_ptr, verbose, log_file, known, flags);
+	entry->used = TRUE;
+
+	return entry->power;
+}
+
+/*
+ * Work out an object's power from scratch, from the given flags.
+ */
+static s32b object_power_aux(const object_type *o_ptr, int verbose,
+	ang_file *log_file, bool known, bitflag flags[OF_SIZE])
+{
+	s32b p = 0, q = 0, slay_pwr = 0, dice_pwr = 0;
+	unsigned int i, j;
+	int extra_stat_bonus = 0, mult = 1, num_slays = 0, k = 1;
+	bitflag mask[OF_SIZE];
+
+	/* Zero the flag counts */
+	for (i = 0; i < N_ELEMENTS(sets); i++)
+		sets[i].count = 0;
+
 	/* Log the flags in human-readable form */
 	if (verbose)
 		log_flags(flags, log_file);
@@ -34,6 +34,21 @@
 
 struct object *o_list;
 
+/*
+ * The floor registry.  Every live object lying on the dungeon floor is on
+ * a doubly linked list, threaded through the object list by index.  This
+ * lets anything which wants the objects on the floor go straight to them,
+ * rather than looking at every grid in the dungeon.
+ */
+struct floor_link {
+	bool live;	/* On the list */
+	s16b next;
+	s16b prev;
+};
+
+static struct floor_link *floor_links;
+static s16b floor_head;
+
 /*
  * Hold the titles of scrolls, 6 to 14 characters each, plus quotes.
  */
@@ -266,6 +281,9 @@ void reset_visuals(bool load_prefs)
 		tval_to_attr[i] = TERM_WHITE;
 	}
 
+	/* Everything on the map will look different */
+	map_cache_reset();
+
 	if (!load_prefs)
 		return;
 
@@ -742,6 +760,8 @@ void excise_object_idx(int o_idx)
 
 	s16b prev_o_idx = 0;
 
+	/* No longer on the floor, wherever it was */
+	floor_object_remove(o_idx);
 
 	/* Object */
 	j_ptr = object_byid(o_idx);
@@ -925,6 +945,8 @@ void delete_object(int y, int x)
 		/* Get the next object */
 		next_o_idx = o_ptr->next_o_idx;
 
+		floor_object_remove(this_o_idx);
+
 		/* Preserve unseen artifacts */
 		if (o_ptr->artifact && !object_was_sensed(o_ptr))
 			o_ptr->artifact->created = FALSE;
@@ -966,10 +988,16 @@ static void compact_objects_aux(int i1, int i2)
 
 	object_type *o_ptr;
 
+	bool on_floor;
+
 
 	/* Do nothing */
 	if (i1 == i2) return;
 
+	/* Take it off the floor list while it moves */
+	on_floor = floor_links[i1].live;
+	floor_object_remove(i1);
+
 
 	/* Repair objects */
 	for (i = 1; i < o_max; i++)
@@ -1048,6 +1076,8 @@ static void compact_objects_aux(int i1, int i2)
 
 	/* Hack -- wipe hole */
 	object_wipe(o_ptr);
+
+	if (on_floor) floor_object_add(i2);
 }
 
 
@@ -1261,6 +1291,9 @@ void wipe_o_list(struct cave *c)
 
 	/* Reset "o_cnt" */
 	o_cnt = 0;
+
+	/* Nothing on the floor */
+	floor_objects_reset();
 }
 
 
@@ -1314,6 +1347,69 @@ s16b o_pop(void)
 }
 
 
+/*
+ * Put an object which has just been placed on the floor on the floor list.
+ */
+void floor_object_add(s16b o_idx)
+{
+	struct floor_link *link = &floor_links[o_idx];
+
+	if (link->live) return;
+
+	link->live = TRUE;
+	link->prev = 0;
+	link->next = floor_head;
+	if (floor_head) floor_links[floor_head].prev = o_idx;
+	floor_head = o_idx;
+}
+
+/*
+ * Take an object off the floor list, if it is on it.
+ */
+void floor_object_remove(s16b o_idx)
+{
+	struct floor_link *link = &floor_links[o_idx];
+
+	if (!link->live) return;
+
+	if (link->prev)
+		floor_links[link->prev].next = link->next;
+	else
+		floor_head = link->next;
+
+	if (link->next) floor_links[link->next].prev = link->prev;
+
+	WIPE(link, struct floor_link);
+}
+
+/*
+ * Empty the floor list.
+ */
+void floor_objects_reset(void)
+{
+	C_WIPE(floor_links, z_info->o_max, struct floor_link);
+	floor_head = 0;
+}
+
+/*
+ * Get the index of the first object on the floor, or 0 if there aren't
+ * any.  The objects come in no particular order.
+ */
+s16b floor_object_first(void)
+{
+	return floor_head;
+}
+
+/*
+ * Get the index of the next object on the floor, or 0 if that was the
+ * last.  The object may be taken off the floor once we have the next one.
+ */
+s16b floor_object_next(s16b o_idx)
+{
+	return floor_links[o_idx].next;
+}
+
+
 /*
  * Get the first object at a dungeon location
  * or NULL if there isn't one.
@@ -1725,6 +1821,7 @@ void object_absorb(object_type *o_ptr, const object_type *j_ptr)
 	/* Blend all knowledge */
 	o_ptr->ident |= (j_ptr->ident & ~IDENT_EMPTY);
 	of_union(o_ptr->known_flags, j_ptr->known_flags);
+	object_knowledge_changed();
 
 	/* Merge inscriptions */
 	if (j_ptr->note)
@@ -1953,6 +2050,8 @@ s16b floor_carry(struct cave *c, int y, int x, object_type *j_ptr)
 		/* Link the floor to the object */
 		c->o_idx[y][x] = o_idx;
 
+		floor_object_add(o_idx);
+
 		cave_note_spot(c, y, x);
 		cave_light_spot(c, y, x);
 	}
@@ -3859,6 +3958,14 @@ void display_object_kind_recall(s16b k_idx)
 	display_object_recall(&object);
 }
 
+/*
+ * Sort grid indexes into map order
+ */
+static int cmp_grid(const void *a, const void *b)
+{
+	return *(const int *)a - *(const int *)b;
+}
+
 /*
  * Display visible items, similar to display_monlist
  */
@@ -3866,6 +3973,7 @@ void display_itemlist(void)
 {
 	int max;
 	int mx, my;
+	int *grids, num_grids = 0, g;
 	int line = 1, x = 0;
 	int cur_x;
 	unsigned i, num, disp_count = 0;
@@ -3894,73 +4002,90 @@ void display_itemlist(void)
 		max = Term->hgt - 2;
 	}
 
-	/* Look at each square of the dungeon for items */
-	for (my = 0; my < dungeon_hgt; my++) {
-		for (mx = 0; mx < dungeon_wid; mx++) {
-			
-			num = scan_floor(floor_list, MAX_FLOOR_STACK, my, mx, 0x02);
-
-			/* Iterate over all the items found on this square */
-			for (i = 0; i < num; i++) {
-				object_type *o_ptr = object_byid(floor_list[i]);
-				unsigned j;
-
-				if (!is_unknown(o_ptr) && squelch_item_ok(o_ptr)) continue;
-				if (o_ptr->tval == TV_GOLD) continue;
-
-				/* See if we've already seen a similar item; if so, just add */
-				/* to its count */
-				for (j = 0; j < counter; j++) {
-					if (object_similar(o_ptr, types[j],	OSTACK_LIST) &&
-							!is_unknown(o_ptr)) {
-						if (o_ptr->marked == MARK_SEEN)
-							counts[j] += o_ptr->number;
-						else
-							counts[j] = 1;
-
-						if ((my - p_ptr->py) * (my - p_ptr->py) +
-								(mx - p_ptr->px) * (mx - p_ptr->px) <
-								dy[j] * dy[j] + dx[j] * dx[j]) {
-							dy[j] = my - p_ptr->py;
-							dx[j] = mx - p_ptr->px;
-						}
-						break;
+	/* Find the squares with items on, in map order, from the objects on
+	 * the floor rather than by looking at every square of the dungeon */
+	grids = C_ZNEW(o_max, int);
+	for (i = floor_object_first(); i;
+			i = floor_object_next(i)) {
+		object_type *o_ptr = object_byid(i);
+
+		if (o_ptr->iy >= dungeon_hgt || o_ptr->ix >= dungeon_wid) continue;
+
+		grids[num_grids++] = o_ptr->iy * dungeon_wid + o_ptr->ix;
+	}
+	sort(grids, num_grids, sizeof(grids[0]), cmp_grid);
+
+	for (g = 0; g < num_grids; g++) {
+		/* Each square only once */
+		if (g && grids[g] == grids[g - 1]) continue;
+
+		my = grids[g] / dungeon_wid;
+		mx = grids[g] % dungeon_wid;
+
+		num = scan_floor(floor_list, MAX_FLOOR_STACK, my, mx, 0x02);
+
+		/* Iterate over all the items found on this square */
+		for (i = 0; i < num; i++) {
+			object_type *o_ptr = object_byid(floor_list[i]);
+			unsigned j;
+
+			if (!is_unknown(o_ptr) && squelch_item_ok(o_ptr)) continue;
+			if (o_ptr->tval == TV_GOLD) continue;
+
+			/* See if we've already seen a similar item; if so, just add */
+			/* to its count */
+			for (j = 0; j < counter; j++) {
+				if (object_similar(o_ptr, types[j],	OSTACK_LIST) &&
+						!is_unknown(o_ptr)) {
+					if (o_ptr->marked == MARK_SEEN)
+						counts[j] += o_ptr->number;
+					else
+						counts[j] = 1;
+
+					if ((my - p_ptr->py) * (my - p_ptr->py) +
+							(mx - p_ptr->px) * (mx - p_ptr->px) <
+							dy[j] * dy[j] + dx[j] * dx[j]) {
+						dy[j] = my - p_ptr->py;
+						dx[j] = mx - p_ptr->px;
 					}
+					break;
 				}
+			}
 
-				/* We saw a new item. So insert it at the end of the list and */
-				/* then sort it forward using compare_items(). The types list */
-				/* is always kept sorted. */
-				if (j == counter) {
-					types[counter] = o_ptr;
-					counts[counter] = o_ptr->number;
-					dy[counter] = my - p_ptr->py;
-					dx[counter] = mx - p_ptr->px;					
-
-					while (j > 0 && compare_items(types[j - 1], types[j]) > 0) {
-						object_type *tmp_o = types[j - 1];
-						int tmpcount = counts[j - 1];
-						int tmpdx = dx[j - 1];
-						int tmpdy = dy[j - 1];
-						
-
-						types[j - 1] = types[j];
-						types[j] = tmp_o;
-						dx[j - 1] = dx[j];
-						dx[j] = tmpdx;
-						dy[j - 1] = dy[j];
-						dy[j] = tmpdy;
-						counts[j - 1] = counts[j];
-						counts[j] = tmpcount;
-						
-						j--;
-					}
-					counter++;
+			/* We saw a new item. So insert it at the end of the list and */
+			/* then sort it forward using compare_items(). The types list */
+			/* is always kept sorted. */
+			if (j == counter) {
+				types[counter] = o_ptr;
+				counts[counter] = o_ptr->number;
+				dy[counter] = my - p_ptr->py;
+				dx[counter] = mx - p_ptr->px;					
+
+				while (j > 0 && compare_items(types[j - 1], types[j]) > 0) {
+					object_type *tmp_o = types[j - 1];
+					int tmpcount = counts[j - 1];
+					int tmpdx = dx[j - 1];
+					int tmpdy = dy[j - 1];
+					
+
+					types[j - 1] = types[j];
+					types[j] = tmp_o;
+					dx[j - 1] = dx[j];
+					dx[j] = tmpdx;
+					dy[j - 1] = dy[j];
+					dy[j] = tmpdy;
+					counts[j - 1] = counts[j];
+					counts[j] = tmpcount;
+					
+					j--;
 				}
+				counter++;
 			}
 		}
 	}
 
+	FREE(grids);
+
 	/* Note no visible items */
 	if (!counter) {
 		/* Clear display and print note */
@@ -4502,11 +4627,14 @@ struct object *object_byid(s16b oidx)
 void objects_init(void)
 {
 	o_list = C_ZNEW(z_info->o_max, struct object);
+	floor_links = C_ZNEW(z_info->o_max, struct floor_link);
+	floor_objects_reset();
 }
 
 void objects_destroy(void)
 {
 	mem_free(o_list);
+	mem_free(floor_links);
 }
 
 /* For an affix or theme, return the first T: line which contains this tval */
@@ -559,6 +559,9 @@ struct theme {
 
 /* identify.c */
 extern s32b object_last_wield;
+extern u32b object_knowledge;
+
+void object_knowledge_changed(void);
 
 bool object_is_known(const object_type *o_ptr);
 bool object_is_known_artifact(const object_type *o_ptr);
@@ -620,6 +623,7 @@ textblock *object_info_ego(struct ego_item *ego);
 textblock *object_info_theme(struct theme *theme);
 void object_info_spoil(ang_file *f, const object_type *o_ptr, int wrap);
 void object_info_chardump(ang_file *f, const object_type *o_ptr, int indent, int wrap);
+void free_obj_info(void);
 
 /* obj-make.c */
 void free_obj_alloc(void);
@@ -671,6 +675,11 @@ void delete_object(int y, int x);
 void compact_objects(int size);
 void wipe_o_list(struct cave *c);
 s16b o_pop(void);
+void floor_object_add(s16b o_idx);
+void floor_object_remove(s16b o_idx);
+void floor_objects_reset(void);
+s16b floor_object_first(void);
+s16b floor_object_next(s16b o_idx);
 object_type *get_first_object(int y, int x);
 object_type *get_next_object(const object_type *o_ptr);
 bool is_blessed(const object_type *o_ptr);
@@ -769,6 +778,8 @@ int which_ego_tval(int idx, int tval, bool is_theme);
 
 /* obj-power.c and randart.c */
 s32b object_power(const object_type *o_ptr, int verbose, ang_file *log_file, bool known);
+void free_power_cache(void);
+void power_cache_counts(u32b *hits, u32b *misses);
 char *artifact_gen_name(struct artifact *a, const char ***wordlist);
 
 #endif /* !INCLUDED_OBJECT_H */
@@ -24,9 +24,6 @@
 #include "effects.h"
 #include "randname.h"
 
-#define ART_MIN_NORMAL 16
-/* Both the above two will go in the rewrite - CC 4/10/11 */
-
 #define BUFLEN 1024
 
 #define MIN_NAME_LEN 5
@@ -396,6 +393,9 @@ static void store_base_power (void)
 
 	/* Store the number of different types, for use later */
 	/* ToDo: replace this with full combination tracking */
+	art_melee_total = art_bow_total = art_armor_total = 0;
+	art_shield_total = art_cloak_total = art_headgear_total = 0;
+	art_glove_total = art_boot_total = art_other_total = 0;
 	for (i = 0; i < z_info->a_max; i++)
 	{
 		switch (a_info[i].tval)
@@ -3008,109 +3008,220 @@ static void scramble_artifact(int a_idx)
 	file_putf(log_file, "Number of tries for artifact %d was: %d\n", a_idx, tries);
 }
 
+/*
+ * The kinds of normal artifact there have to be enough of, and how many
+ * there have to be.
+ */
+enum {
+	ART_CAT_SWORD = 0,
+	ART_CAT_POLEARM,
+	ART_CAT_BLUNT,
+	ART_CAT_BOW,
+	ART_CAT_BODY,
+	ART_CAT_SHIELD,
+	ART_CAT_CLOAK,
+	ART_CAT_HAT,
+	ART_CAT_GLOVES,
+	ART_CAT_BOOTS,
+
+	ART_CAT_MAX
+};
+
+static const struct {
+	int min;
+	const char *name;		/* for the log */
+	const char *plural;		/* for the restart message */
+} art_cats[ART_CAT_MAX] = {
+	{ 5, "swords", " swords" },
+	{ 5, "polearms", " polearms" },
+	{ 5, "blunts", " blunts" },
+	{ 4, "bows", " bows" },
+	{ 5, "bodies", " body-armors" },
+	{ 4, "shields", " shields" },
+	{ 4, "cloaks", " cloaks" },
+	{ 4, "hats", " hats" },
+	{ 4, "gloves", " gloves" },
+	{ 4, "boots", " boots" }
+};
+
+/*
+ * Return which kind of artifact `tval` makes, or -1 if it's not one which
+ * is counted.
+ */
+static int art_category(int tval)
+{
+	switch (tval)
+	{
+		case TV_SWORD: return ART_CAT_SWORD;
+		case TV_POLEARM: return ART_CAT_POLEARM;
+		case TV_HAFTED: return ART_CAT_BLUNT;
+		case TV_BOW: return ART_CAT_BOW;
+		case TV_SOFT_ARMOR:
+		case TV_HARD_ARMOR:
+		case TV_DRAG_ARMOR: return ART_CAT_BODY;
+		case TV_SHIELD: return ART_CAT_SHIELD;
+		case TV_CLOAK: return ART_CAT_CLOAK;
+		case TV_HELM:
+		case TV_CROWN: return ART_CAT_HAT;
+		case TV_GLOVES: return ART_CAT_GLOVES;
+		case TV_BOOTS: return ART_CAT_BOOTS;
+		default: return -1;
+	}
+}
+
+/*
+ * Count how many normal artifacts there are of each kind.
+ */
+static void count_categories(int counts[ART_CAT_MAX])
+{
+	int i;
+
+	for (i = 0; i < ART_CAT_MAX; i++)
+		counts[i] = 0;
+
+	for (i = ART_MIN_NORMAL; i < z_info->a_max; i++) {
+		int cat = art_category(a_info[i].tval);
+		if (cat >= 0) counts[cat]++;
+	}
+}
+
 /*
  * Return TRUE if the whole set of random artifacts meets certain
  * criteria.  Return FALSE if we fail to meet those criteria (which will
- * restart the whole process).
+ * redo some of them).
  */
 static bool artifacts_acceptable(void)
 {
-	int swords = 5, polearms = 5, blunts = 5, bows = 4;
-	int bodies = 5, shields = 4, cloaks = 4, hats = 4;
-	int gloves = 4, boots = 4;
+	int counts[ART_CAT_MAX];
+	char types[256] = "";
+	bool ok = TRUE;
 	int i;
 
-	for (i = ART_MIN_NORMAL; i < z_info->a_max; i++)
-	{
-		switch (a_info[i].tval)
-		{
-			case TV_SWORD:
-				swords--; break;
-			case TV_POLEARM:
-				polearms--; break;
-			case TV_HAFTED:
-				blunts--; break;
-			case TV_BOW:
-				bows--; break;
-			case TV_SOFT_ARMOR:
-			case TV_HARD_ARMOR:
-			case TV_DRAG_ARMOR:
-				bodies--; break;
-			case TV_SHIELD:
-				shields--; break;
-			case TV_CLOAK:
-				cloaks--; break;
-			case TV_HELM:
-			case TV_CROWN:
-				hats--; break;
-			case TV_GLOVES:
-				gloves--; break;
-			case TV_BOOTS:
-				boots--; break;
-		}
-	}
-
-	file_putf(log_file, "Deficit amount for swords is %d\n", swords);
-	file_putf(log_file, "Deficit amount for polearms is %d\n", polearms);
-	file_putf(log_file, "Deficit amount for blunts is %d\n", blunts);
-	file_putf(log_file, "Deficit amount for bows is %d\n", bows);
-	file_putf(log_file, "Deficit amount for bodies is %d\n", bodies);
-	file_putf(log_file, "Deficit amount for shields is %d\n", shields);
-	file_putf(log_file, "Deficit amount for cloaks is %d\n", cloaks);
-	file_putf(log_file, "Deficit amount for hats is %d\n", hats);
-	file_putf(log_file, "Deficit amount for gloves is %d\n", gloves);
-	file_putf(log_file, "Deficit amount for boots is %d\n", boots);
-
-	if (swords > 0 || polearms > 0 || blunts > 0 || bows > 0 ||
-	    bodies > 0 || shields > 0 || cloaks > 0 || hats > 0 ||
-	    gloves > 0 || boots > 0)
-	{
-		if (verbose)
-		{
-			char types[256];
-			strnfmt(types, sizeof(types), "%s%s%s%s%s%s%s%s%s%s",
-				swords > 0 ? " swords" : "",
-				polearms > 0 ? " polearms" : "",
-				blunts > 0 ? " blunts" : "",
-				bows > 0 ? " bows" : "",
-				bodies > 0 ? " body-armors" : "",
-				shields > 0 ? " shields" : "",
-				cloaks > 0 ? " cloaks" : "",
-				hats > 0 ? " hats" : "",
-				gloves > 0 ? " gloves" : "",
-				boots > 0 ? " boots" : "");
-
-			file_putf(log_file, "Restarting generation process: not enough%s",
-				types);
+	count_categories(counts);
+
+	for (i = 0; i < ART_CAT_MAX; i++) {
+		int deficit = art_cats[i].min - counts[i];
+
+		file_putf(log_file, "Deficit amount for %s is %d\n",
+			art_cats[i].name, deficit);
+
+		if (deficit > 0) {
+			my_strcat(types, art_cats[i].plural, sizeof(types));
+			ok = FALSE;
 		}
-		return FALSE;
-	}
-	else
-	{
-		return TRUE;
 	}
+
+	if (!ok && verbose)
+		file_putf(log_file, "Restarting generation process: not enough%s",
+			types);
+
+	return ok;
 }
 
 
-static errr scramble(void)
+/*
+ * Seed the simple RNG for scrambling artifact `a_idx` on pass `pass`.
+ *
+ * Each artifact gets its own stream, worked out from the randart seed, so
+ * what it turns into doesn't depend on how much randomness the others have
+ * used up.  That means the set comes out the same for a given seed whatever
+ * order the artifacts are done in, and one can be redone without touching
+ * the rest.
+ */
+static void seed_artifact(u32b seed, int a_idx, int pass)
+{
+	u32b x = seed;
+
+	x ^= (u32b)a_idx * 0x9E3779B9UL;
+	x ^= (u32b)pass * 0x85EBCA6BUL;
+
+	/* Mix well, so that neighbouring artifacts aren't alike */
+	x ^= x >> 16;
+	x *= 0x7FEB352DUL;
+	x ^= x >> 15;
+	x *= 0x846CA68BUL;
+	x ^= x >> 16;
+
+	Rand_value = x;
+}
+
+/*
+ * Scramble artifact `a_idx` from the version it started as.
+ */
+static void rescramble_artifact(const artifact_type *a_orig, u32b seed,
+	int a_idx, int pass)
+{
+	a_info[a_idx] = a_orig[a_idx];
+	seed_artifact(seed, a_idx, pass);
+	scramble_artifact(a_idx);
+}
+
+/*
+ * Make the set the way it was made before RANDART_VERSION, so that older
+ * savefiles keep their artifacts: everything is scrambled in order from the
+ * one stream started by do_randart(), and the whole set is redone until it
+ * is acceptable.
+ */
+static errr scramble_sequential(void)
 {
-	/* If our artifact set fails to meet certain criteria, we start over. */
 	do
 	{
 		int a_idx;
 
-		/* Generate all the artifacts. */
 		for (a_idx = 1; a_idx < z_info->a_max; a_idx++)
-		{
 			scramble_artifact(a_idx);
+	} while (!artifacts_acceptable());
+
+	return (0);
+}
+
+static errr scramble(u32b seed)
+{
+	artifact_type *a_orig;
+	int a_idx, pass = 0;
+
+	if (randart_version < RANDART_VERSION)
+		return scramble_sequential();
+
+	a_orig = C_ZNEW(z_info->a_max, artifact_type);
+
+	/* Everything is scrambled from the original set */
+	memcpy(a_orig, a_info, z_info->a_max * sizeof(*a_orig));
+
+	/* Generate all the artifacts. */
+	for (a_idx = 1; a_idx < z_info->a_max; a_idx++)
+		rescramble_artifact(a_orig, seed, a_idx, pass);
+
+	/*
+	 * If our artifact set fails to meet certain criteria, redo the normal
+	 * artifacts which aren't needed to make up the numbers of their kind,
+	 * until it does.  Special artifacts never count, so they are left be.
+	 */
+	while (!artifacts_acceptable()) {
+		int counts[ART_CAT_MAX];
+
+		pass++;
+		count_categories(counts);
+
+		for (a_idx = ART_MIN_NORMAL; a_idx < z_info->a_max; a_idx++) {
+			int cat = art_category(a_info[a_idx].tval);
+
+			if (cat >= 0) {
+				if (counts[cat] <= art_cats[cat].min) continue;
+				counts[cat]--;
+			}
+
+			rescramble_artifact(a_orig, seed, a_idx, pass);
 		}
-	} while (!artifacts_acceptable());	/* end of all artifacts */
+	}
+
+	mem_free(a_orig);
 
 	/* Success */
 	return (0);
 }
 
-static errr do_randart_aux(bool full)
+static errr do_randart_aux(u32b randart_seed, bool full)
 {
 	errr result;
 
@@ -3120,7 +3231,7 @@ static errr do_randart_aux(bool full)
 	if (full)
 	{
 		/* Randomize the artifacts */
-		if ((result = scramble()) != 0) return (result);
+		if ((result = scramble(randart_seed)) != 0) return (result);
 	}
 
 	/* Success */
@@ -3175,7 +3286,7 @@ errr do_randart(u32b randart_seed, bool full)
 	}
 
 	/* Generate the random artifact (names) */
-	err = do_randart_aux(full);
+	err = do_randart_aux(randart_seed, full);
 
 	/* Only do all the following if full randomization requested */
 	if (full)
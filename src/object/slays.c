@@ -17,6 +17,7 @@
  */
 
 #include "angband.h"
+#include "derived.h"
 #include "object/pval.h"
 
 /**
@@ -36,6 +37,12 @@ const struct slay slay_table[] =
 #define SLAY_CACHE_SIZE	513
 static struct flag_cache **slay_cache;
 
+/*
+ * In the derived table cache, each entry is the multipliers followed by
+ * the value, all as s32b.
+ */
+#define SLAY_ENTRY_LEN	(SL_MAX + 1)
+
 
 /**
  * Get a random slay (or brand).
@@ -269,13 +276,7 @@ u32b check_slay_cache(s16b mult[])
 	}
 }
 
-/**
- * Fill in a value in the slay cache. Return TRUE if a change is made.
- *
- * \param index is the set of slay flags whose value we are adding
- * \param value is the value of the slay flags in index
- */
-void add_slay_cache(s16b mult[], u32b value)
+static void slay_cache_insert(s16b mult[], u32b value)
 {
 	int i;
 	size_t hash;
@@ -294,6 +295,51 @@ void add_slay_cache(s16b mult[], u32b value)
 		(*entry_p)->mults[i] = mult[i];
 }
 
+/*
+ * Look for a combination of slays in the derived table cache, returning 0
+ * if it isn't there.
+ */
+static u32b find_derived_slay(s16b mult[])
+{
+	size_t len, n, i;
+	const s32b *entries = derived_find(DERIVED_SLAYS, &len);
+
+	if (!entries) return 0;
+
+	n = len / (SLAY_ENTRY_LEN * sizeof(s32b));
+	for (i = 0; i < n; i++) {
+		const s32b *entry = entries + i * SLAY_ENTRY_LEN;
+		int j;
+
+		for (j = 0; j < SL_MAX; j++)
+			if (entry[j] != mult[j]) break;
+
+		if (j == SL_MAX) return (u32b)entry[SL_MAX];
+	}
+
+	return 0;
+}
+
+/**
+ * Fill in a value in the slay cache. Return TRUE if a change is made.
+ *
+ * \param index is the set of slay flags whose value we are adding
+ * \param value is the value of the slay flags in index
+ */
+void add_slay_cache(s16b mult[], u32b value)
+{
+	/* Compare against the derived table cache if we're checking it */
+	if (derived_flags & DERIVED_CHECK) {
+		u32b old = find_derived_slay(mult);
+
+		if (old && old != value)
+			plog_fmt("The cached slay value %lu should be %lu.",
+				(unsigned long)old, (unsigned long)value);
+	}
+
+	slay_cache_insert(mult, value);
+}
+
 /**
  * Create a cache ready for slay combinations found on ego items.
  *
@@ -302,23 +348,97 @@ void add_slay_cache(s16b mult[], u32b value)
  * many times for ego items during the game.
  *
  * The cache is a hash table, with linked lists of entries at each hash
- * position, each entry initialised to NULL
+ * position, each entry initialised to NULL, or to the values kept from
+ * earlier runs in the derived table cache.
  */
 errr create_slay_cache(void)
 {
+	size_t len, n, i;
+	const s32b *entries;
+
     /* Allocate slay_cache */
     slay_cache = C_ZNEW(SLAY_CACHE_SIZE, struct flag_cache *);
 
+	/* Work everything out afresh if we're checking the cached values */
+	if (derived_flags & DERIVED_CHECK) return 0;
+
+	entries = derived_find(DERIVED_SLAYS, &len);
+	if (!entries) return 0;
+
+	n = len / (SLAY_ENTRY_LEN * sizeof(s32b));
+	for (i = 0; i < n; i++) {
+		const s32b *entry = entries + i * SLAY_ENTRY_LEN;
+		s16b mult[SL_MAX];
+		int j;
+
+		for (j = 0; j < SL_MAX; j++)
+			mult[j] = (s16b)entry[j];
+
+		slay_cache_insert(mult, (u32b)entry[SL_MAX]);
+	}
+
     /* Success */
     return 0;
 }
 
+/**
+ * Put every entry of the slay cache in the derived table cache, including
+ * ones from earlier runs which weren't needed this time.
+ */
+void store_slay_cache(void)
+{
+	size_t len, n = 0, i;
+	const s32b *old;
+	struct flag_cache *entry;
+	s32b *entries, *p;
+
+	old = derived_find(DERIVED_SLAYS, &len);
+	if (old) {
+		size_t old_n = len / (SLAY_ENTRY_LEN * sizeof(s32b));
+
+		for (i = 0; i < old_n; i++) {
+			const s32b *e = old + i * SLAY_ENTRY_LEN;
+			s16b mult[SL_MAX];
+			int j;
+
+			for (j = 0; j < SL_MAX; j++)
+				mult[j] = (s16b)e[j];
+
+			if (!check_slay_cache(mult))
+				slay_cache_insert(mult, (u32b)e[SL_MAX]);
+		}
+	}
+
+	for (i = 0; i < SLAY_CACHE_SIZE; i++)
+		for (entry = slay_cache[i]; entry; entry = entry->next)
+			n++;
+
+	len = n * SLAY_ENTRY_LEN * sizeof(s32b);
+	entries = mem_zalloc(len ? len : 1);
+	p = entries;
+
+	for (i = 0; i < SLAY_CACHE_SIZE; i++) {
+		for (entry = slay_cache[i]; entry; entry = entry->next) {
+			int j;
+
+			for (j = 0; j < SL_MAX; j++)
+				*p++ = entry->mults[j];
+			*p++ = (s32b)entry->value;
+		}
+	}
+
+	derived_store(DERIVED_SLAYS, entries, len);
+	mem_free(entries);
+}
+
 void free_slay_cache(void)
 {
 	int i;
 	struct flag_cache *entry;
 	struct flag_cache *prev;
 
+	store_slay_cache();
+
 	for (i = 0; i < SLAY_CACHE_SIZE; i++) {
 		entry = slay_cache[i];
 		while (entry) {
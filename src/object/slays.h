@@ -64,6 +64,7 @@ void react_to_slay(bitflag *obj_flags, bitflag *mon_flags);
 u32b check_slay_cache(s16b mult[]);
 void add_slay_cache(s16b mult[], u32b value);
 errr create_slay_cache(void);
+void store_slay_cache(void);
 void free_slay_cache(void);
 bool obj_hurts_mon(bitflag *flags, const monster_type *m_ptr);
 const struct slay *lookup_slay(int flag);
@@ -0,0 +1,257 @@
+/*
+ * File: observe.c
+ * Purpose: Read-only view of the game as the player knows it
+ *
+ * Copyright (c) 2012 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+#include "cave.h"
+#include "game-event.h"
+#include "monster/mon-timed.h"
+#include "monster/mon-util.h"
+#include "observe.h"
+#include "squelch.h"
+
+/*
+ * These functions let automated players (such as the borg) look at the
+ * game without reading it back off the screen.  Everything here is
+ * filtered by what the player knows, in the same way as map_info(), so
+ * nothing is revealed which couldn't be learned by looking at the map,
+ * the monster recall or the message line.
+ *
+ * This covers the map, the monsters in view and the messages.  The borg
+ * still reads the screen to tell which menu or prompt it is looking at,
+ * which is part of the interface rather than the game.
+ */
+
+
+/*** Monsters ***/
+
+/*
+ * Fill in `mon` from a monster the player can see.
+ */
+static void observe_monster(int m_idx, struct observed_monster *mon)
+{
+	monster_type *m_ptr = cave_monster(cave, m_idx);
+
+	mon->y = m_ptr->fy;
+	mon->x = m_ptr->fx;
+	mon->m_idx = m_idx;
+
+	/* Hallucination hides what the monster really is */
+	mon->r_idx = p_ptr->timed[TMD_IMAGE] ? 0 : m_ptr->r_idx;
+
+	mon->asleep = m_ptr->m_timed[MON_TMD_SLEEP] ? TRUE : FALSE;
+	mon->afraid = m_ptr->m_timed[MON_TMD_FEAR] ? TRUE : FALSE;
+}
+
+/*
+ * Whether the player can see the given monster as a monster.
+ */
+static bool monster_is_observable(monster_type *m_ptr)
+{
+	return m_ptr->r_idx && m_ptr->ml && !is_mimicking(m_ptr);
+}
+
+/*
+ * Look for a visible monster at (y, x), filling in `mon` if there is one.
+ */
+bool observe_monster_at(int y, int x, struct observed_monster *mon)
+{
+	int m_idx;
+
+	if (!cave_in_bounds(cave, y, x))
+		return FALSE;
+
+	m_idx = cave->m_idx[y][x];
+	if (m_idx <= 0 || !monster_is_observable(cave_monster(cave, m_idx)))
+		return FALSE;
+
+	observe_monster(m_idx, mon);
+	return TRUE;
+}
+
+/*
+ * List up to `max` of the monsters the player can see, returning how
+ * many were listed.
+ */
+int observe_monsters(struct observed_monster *list, int max)
+{
+	int i, n = 0;
+
+	for (i = 1; i < cave_monster_max(cave) && n < max; i++) {
+		if (!monster_is_observable(cave_monster(cave, i)))
+			continue;
+
+		observe_monster(i, &list[n++]);
+	}
+
+	return n;
+}
+
+
+/*** Objects ***/
+
+/*
+ * Return the kind of the first object the player has seen at (y, x), as
+ * it would be drawn on the map, or NULL if there isn't one.
+ */
+struct object_kind *observe_object_at(int y, int x)
+{
+	object_type *o_ptr;
+
+	if (!cave_in_bounds(cave, y, x))
+		return NULL;
+
+	for (o_ptr = get_first_object(y, x); o_ptr; o_ptr = get_next_object(o_ptr))
+		if (o_ptr->marked == MARK_SEEN && !squelch_item_ok(o_ptr))
+			return o_ptr->kind;
+
+	return NULL;
+}
+
+
+/*** Map ***/
+
+/*
+ * Fill in `grid` with what the player knows about (y, x).  This follows
+ * map_info(), less the parts which are only there for drawing the map,
+ * such as hallucinatory monsters and objects.
+ */
+void observe_grid(int y, int x, struct observed_grid *grid)
+{
+	byte info;
+	int m_idx;
+
+	WIPE(grid, struct observed_grid);
+	grid->feat = FEAT_NONE;
+	grid->lighting = FEAT_LIGHTING_DARK;
+
+	if (!cave_in_bounds(cave, y, x))
+		return;
+
+	info = cave->info[y][x];
+	grid->in_view = (info & CAVE_SEEN) ? TRUE : FALSE;
+
+	if (grid->in_view || (info & CAVE_MARK)) {
+		grid->feat = cave->feat[y][x];
+		if (f_info[grid->feat].mimic)
+			grid->feat = f_info[grid->feat].mimic;
+	}
+
+	if (grid->in_view) {
+		grid->lighting = FEAT_LIGHTING_LIT;
+
+		if (!(info & CAVE_GLOW) && OPT(view_yellow_light))
+			grid->lighting = FEAT_LIGHTING_BRIGHT;
+	}
+
+	m_idx = cave->m_idx[y][x];
+	grid->is_player = (m_idx < 0) ? TRUE : FALSE;
+	if (m_idx > 0 && monster_is_observable(cave_monster(cave, m_idx)))
+		grid->m_idx = m_idx;
+
+	grid->kind = observe_object_at(y, x);
+}
+
+
+/*** Messages ***/
+
+/*
+ * Messages are queued as they are printed, and handed out in order by
+ * observe_message_next().  If nobody collects them, the oldest are lost.
+ */
+#define OBSERVE_MSG_MAX	256
+
+struct observed_message {
+	char *str;
+	u16b type;
+};
+
+static struct observed_message msg_queue[OBSERVE_MSG_MAX];
+static int msg_head = 0;	/* Next slot to write */
+static int msg_num = 0;		/* Number of messages waiting */
+
+static void observe_message_event(game_event_type type, game_event_data *data,
+		void *user)
+{
+	struct observed_message *m = &msg_queue[msg_head];
+
+	/* The message line is also redrawn with no message */
+	if (!data)
+		return;
+
+	/* Drop the oldest message if we're full */
+	if (m->str)
+		string_free(m->str);
+
+	m->str = string_make(data->message.msg);
+	m->type = data->message.type;
+
+	msg_head = (msg_head + 1) % OBSERVE_MSG_MAX;
+	if (msg_num < OBSERVE_MSG_MAX)
+		msg_num++;
+}
+
+/*
+ * Start or stop collecting messages.
+ */
+void observe_messages_watch(bool on)
+{
+	int i;
+
+	event_remove_handler(EVENT_MESSAGE, observe_message_event, NULL);
+
+	for (i = 0; i < OBSERVE_MSG_MAX; i++) {
+		string_free(msg_queue[i].str);
+		msg_queue[i].str = NULL;
+	}
+	msg_head = 0;
+	msg_num = 0;
+
+	if (on)
+		event_add_handler(EVENT_MESSAGE, observe_message_event, NULL);
+}
+
+/*
+ * Take the oldest waiting message, copying it into `buf` and its type into
+ * `type` (if not NULL).  Returns FALSE if there are no messages waiting.
+ */
+bool observe_message_next(char *buf, size_t len, u16b *type)
+{
+	struct observed_message *m;
+
+	if (!msg_num)
+		return FALSE;
+
+	m = &msg_queue[(msg_head - msg_num + OBSERVE_MSG_MAX) % OBSERVE_MSG_MAX];
+	my_strcpy(buf, m->str, len);
+	if (type)
+		*type = m->type;
+
+	string_free(m->str);
+	m->str = NULL;
+	msg_num--;
+
+	return TRUE;
+}
+
+/*
+ * Free any messages still waiting, and stop collecting them.
+ */
+void observe_cleanup(void)
+{
+	observe_messages_watch(FALSE);
+}
@@ -0,0 +1,40 @@
+/* observe.h - read-only view of the game as the player knows it */
+
+#ifndef OBSERVE_H
+#define OBSERVE_H
+
+/*
+ * A monster as the player sees it.
+ */
+struct observed_monster {
+	int y, x;
+	int m_idx;		/* Index in the cave's monster list */
+	int r_idx;		/* Race, or 0 if the player can't tell */
+	bool asleep;
+	bool afraid;
+};
+
+/*
+ * A map grid as the player knows it.
+ */
+struct observed_grid {
+	int feat;		/* Feature, or FEAT_NONE if unknown */
+	int lighting;		/* FEAT_LIGHTING_*, as for map_info() */
+	bool in_view;
+	bool is_player;
+	struct object_kind *kind;	/* First seen object, or NULL */
+	int m_idx;		/* Visible monster, or 0 */
+};
+
+void observe_grid(int y, int x, struct observed_grid *grid);
+
+bool observe_monster_at(int y, int x, struct observed_monster *mon);
+int observe_monsters(struct observed_monster *list, int max);
+struct object_kind *observe_object_at(int y, int x);
+
+void observe_messages_watch(bool on);
+bool observe_message_next(char *buf, size_t len, u16b *type);
+
+void observe_cleanup(void);
+
+#endif /* !OBSERVE_H */
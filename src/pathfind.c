@@ -19,24 +19,60 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "pathfind.h"
 #include "squelch.h"
 
 /****** Pathfinding code ******/
 
-/* Maximum size around the player to consider in the pathfinder */
-#define MAX_PF_RADIUS 50
+/*
+ * findpath() searches the whole level for the shortest route from the
+ * player to the target, treating grids the player hasn't seen as open.  It
+ * is an A* search: every step costs the same, so on an open map the
+ * distance between two grids is the larger of the x and y distances, and
+ * that is the estimate used to decide which grid to look at next.
+ *
+ * The search state lives in static arrays covering the whole level, which
+ * are never cleared; instead each search has a number, and a grid only
+ * counts as visited if it was stamped with the current search's number.
+ *
+ * The resulting path is kept, and if the player asks for a path to the
+ * same place again while still following it (for instance after being
+ * disturbed), the rest of the old path is reused as long as nothing known
+ * now blocks it.
+ */
 
-/* Maximum distance to consider in the pathfinder */
-#define MAX_PF_LENGTH 250
+#define PF_GRIDS	(DUNGEON_HGT * DUNGEON_WID)
+#define PF_GRID(y, x)	((y) * DUNGEON_WID + (x))
 
+/* Maximum distance to consider in the pathfinder */
+#define MAX_PF_LENGTH	PF_GRIDS
 
-static int terrain[MAX_PF_RADIUS][MAX_PF_RADIUS];
 static char pf_result[MAX_PF_LENGTH];
 static int pf_result_index;
 
-static int ox, oy, ex, ey;
 static int dir_search[8] = {2,4,6,8,1,3,7,9};
 
+/* Search state, indexed by grid */
+static u16b pf_dist[PF_GRIDS];		/* Steps from the player */
+static u16b pf_stamp[PF_GRIDS];		/* Search which last reached the grid */
+static int pf_heap_pos[PF_GRIDS];	/* Place in the open heap, or -1 */
+static u16b pf_search;			/* Current search number */
+
+/* Open grids, as a binary heap ordered by pf_key() */
+static int pf_heap[PF_GRIDS];
+static int pf_heap_size;
+
+static int pf_ty, pf_tx;
+
+/* The last path found */
+static struct {
+	bool valid;
+	s32b level;		/* cave->created_at of the level it was found on */
+	int y, x;		/* Target */
+	int sy, sx;		/* Where the player started */
+	int len;		/* Number of steps */
+} pf_cache;
+
 
 static bool is_valid_pf(int y, int x)
 {
@@ -47,97 +83,188 @@ static bool is_valid_pf(int y, int x)
 	return (cave_ispassable(cave, y, x));
 }
 
-static void fill_terrain_info(void)
+/*
+ * Estimated total length of a path through grid `g`.  Ties are broken in
+ * favour of the grid closer to the target, which keeps the search from
+ * spreading sideways across open rooms.
+ */
+static u32b pf_key(int g)
 {
-	int i, j;
+	int h = MAX(ABS(g / DUNGEON_WID - pf_ty), ABS(g % DUNGEON_WID - pf_tx));
 
-	ox = MAX(p_ptr->px - MAX_PF_RADIUS / 2, 0);
-	oy = MAX(p_ptr->py - MAX_PF_RADIUS / 2, 0);
+	return ((u32b)(pf_dist[g] + h) << 16) | h;
+}
 
-	ex = MIN(p_ptr->px + MAX_PF_RADIUS / 2 - 1, DUNGEON_WID);
-	ey = MIN(p_ptr->py + MAX_PF_RADIUS / 2 - 1, DUNGEON_HGT);
+static void pf_heap_up(int i)
+{
+	int g = pf_heap[i];
+	u32b key = pf_key(g);
 
-	for (i = 0; i < MAX_PF_RADIUS * MAX_PF_RADIUS; i++)
-		terrain[0][i] = -1;
+	while (i > 0) {
+		int parent = (i - 1) / 2;
 
-	for (j = oy; j < ey; j++)
-		for (i = ox; i < ex; i++)
-			if (is_valid_pf(j, i))
-				terrain[j - oy][i - ox] = MAX_PF_LENGTH;
+		if (pf_key(pf_heap[parent]) <= key) break;
 
-	terrain[p_ptr->py - oy][p_ptr->px - ox] = 1;
-}
+		pf_heap[i] = pf_heap[parent];
+		pf_heap_pos[pf_heap[i]] = i;
+		i = parent;
+	}
 
-#define MARK_DISTANCE(c,d) if ((c <= MAX_PF_LENGTH) && (c > d)) { c = d; try_again = (TRUE); }
+	pf_heap[i] = g;
+	pf_heap_pos[g] = i;
+}
 
-bool findpath(int y, int x)
+static int pf_heap_pop(void)
 {
-	int i, j, k, dir;
-	bool try_again;
-	int cur_distance;
+	int top = pf_heap[0];
+	int g, i = 0;
+	u32b key;
 
-	fill_terrain_info();
+	pf_heap_pos[top] = -1;
+	if (--pf_heap_size == 0) return top;
 
-	terrain[p_ptr->py - oy][p_ptr->px - ox] = 1;
+	g = pf_heap[pf_heap_size];
+	key = pf_key(g);
 
-	if ((x >= ox) && (x < ex) && (y >= oy) && (y < ey))
-	{
-		if ((cave->m_idx[y][x] > 0) && (cave_monster_at(cave, y, x)->ml))
-		{
-			terrain[y - oy][x - ox] = MAX_PF_LENGTH;
-		}
+	while (1) {
+		int child = 2 * i + 1;
 
-#if 0
-		else if (terrain[y-oy][x-ox] != MAX_PF_LENGTH)
-		{
-		   bell("Target blocked");
-		   return (FALSE);
-		}
-#endif
+		if (child >= pf_heap_size) break;
+		if (child + 1 < pf_heap_size &&
+				pf_key(pf_heap[child + 1]) < pf_key(pf_heap[child]))
+			child++;
+		if (key <= pf_key(pf_heap[child])) break;
 
-		terrain[y - oy][x - ox] = MAX_PF_LENGTH;
+		pf_heap[i] = pf_heap[child];
+		pf_heap_pos[pf_heap[i]] = i;
+		i = child;
 	}
-	else
-	{
-		bell("Target out of range.");
-		return (FALSE);
+
+	pf_heap[i] = g;
+	pf_heap_pos[g] = i;
+
+	return top;
+}
+
+/*
+ * Reach grid `g` in `dist` steps, if that's better than we've managed so
+ * far.
+ */
+static void pf_reach(int g, int dist)
+{
+	if (pf_stamp[g] == pf_search) {
+		/* Already closed, or already open by a route at least as short */
+		if (pf_heap_pos[g] < 0 || pf_dist[g] <= dist) return;
+
+		pf_dist[g] = dist;
+		pf_heap_up(pf_heap_pos[g]);
+		return;
 	}
 
-	/* 
-	 * And now starts the very naive and very 
-	 * inefficient pathfinding algorithm
-	 */
-	do
-	{
-		try_again = FALSE;
+	pf_stamp[g] = pf_search;
+	pf_dist[g] = dist;
+	pf_heap[pf_heap_size] = g;
+	pf_heap_up(pf_heap_size++);
+}
 
-		for (j = oy + 1; j < ey - 1; j++)
-		{
-			for (i = ox + 1; i < ex - 1; i++)
-			{
-				cur_distance = terrain[j - oy][i - ox] + 1;
+/*
+ * Search from the player to (y, x), returning TRUE if the target was
+ * reached.
+ */
+static bool pf_search_path(int y, int x)
+{
+	int target = PF_GRID(y, x);
 
-				if ((cur_distance > 0) && (cur_distance < MAX_PF_LENGTH))
-				{
-					for (dir = 1; dir < 10; dir++)
-					{
-						if (dir == 5)
-							dir++;
+	/* Start a new search, wiping the stamps when the numbers run out */
+	if (++pf_search == 0) {
+		memset(pf_stamp, 0, sizeof(pf_stamp));
+		pf_search = 1;
+	}
 
-						MARK_DISTANCE(terrain[j - oy + ddy[dir]][i - ox + ddx[dir]], cur_distance);
-					}
-				}
+	pf_ty = y;
+	pf_tx = x;
+	pf_heap_size = 0;
+	pf_reach(PF_GRID(p_ptr->py, p_ptr->px), 0);
+
+	while (pf_heap_size) {
+		int g = pf_heap_pop();
+		int gy = g / DUNGEON_WID, gx = g % DUNGEON_WID;
+		int dir;
+
+		if (g == target) return TRUE;
+
+		for (dir = 1; dir < 10; dir++) {
+			int ny = gy + ddy[dir], nx = gx + ddx[dir];
+
+			if (dir == 5) continue;
+
+			/* The target itself is always allowed */
+			if (ny == y && nx == x) {
+				pf_reach(target, pf_dist[g] + 1);
+				continue;
 			}
+
+			if (!cave_in_bounds_fully(cave, ny, nx)) continue;
+			if (!is_valid_pf(ny, nx)) continue;
+
+			pf_reach(PF_GRID(ny, nx), pf_dist[g] + 1);
 		}
+	}
 
-		if (terrain[y - oy][x - ox] < MAX_PF_LENGTH)
-			try_again = (FALSE);
+	return FALSE;
+}
+
+/*
+ * Try to carry on along the last path found, if it was to (y, x) on this
+ * level, the player is still on it and nothing now known blocks the rest.
+ */
+static bool pf_resume_path(int y, int x)
+{
+	int i, j, py, px;
+
+	if (!pf_cache.valid || pf_cache.level != cave->created_at) return FALSE;
+	if (pf_cache.y != y || pf_cache.x != x) return FALSE;
+
+	/* Find the player on the path */
+	py = pf_cache.sy;
+	px = pf_cache.sx;
+	for (i = pf_cache.len - 1; i >= 0; i--) {
+		if (py == p_ptr->py && px == p_ptr->px) break;
+
+		py += ddy[pf_result[i] - '0'];
+		px += ddx[pf_result[i] - '0'];
+	}
+
+	if (i < 0) return FALSE;
+
+	/* Check the rest of the way */
+	for (j = i; j > 0; j--) {
+		py += ddy[pf_result[j] - '0'];
+		px += ddx[pf_result[j] - '0'];
+
+		if (!is_valid_pf(py, px)) return FALSE;
+	}
 
+	pf_result_index = i;
+	return TRUE;
+}
+
+bool findpath(int y, int x)
+{
+	int i, j, k, dir = 10;
+
+	if (!cave_in_bounds(cave, y, x))
+	{
+		bell("Target out of range.");
+		return (FALSE);
 	}
-	while (try_again);
+
+	if (pf_resume_path(y, x)) return (TRUE);
+
+	pf_cache.valid = FALSE;
 
 	/* Failure */
-	if (terrain[y - oy][x - ox] == MAX_PF_LENGTH)
+	if (!pf_search_path(y, x))
 	{
 		bell("Target space unreachable.");
 		return (FALSE);
@@ -151,27 +278,27 @@ bool findpath(int y, int x)
 
 	while ((i != p_ptr->px) || (j != p_ptr->py))
 	{
-		cur_distance = terrain[j - oy][i - ox] - 1;
+		int cur_distance = pf_dist[PF_GRID(j, i)] - 1;
+
 		for (k = 0; k < 8; k++)
 		{
+			int g;
+
 			dir = dir_search[k];
-			if (terrain[j - oy + ddy[dir]][i - ox + ddx[dir]] == cur_distance)
+			g = PF_GRID(j + ddy[dir], i + ddx[dir]);
+
+			if (!cave_in_bounds(cave, j + ddy[dir], i + ddx[dir])) continue;
+			if (pf_stamp[g] == pf_search && pf_dist[g] == cur_distance)
 				break;
 		}
 
-		/* Should never happend */
-		if (dir == 10)
+		/* Should never happen */
+		if (k == 8)
 		{
 			bell("Wtf ?");
 			return (FALSE);
 		}
 
-		else if (dir == 5)
-		{
-			bell("Heyyy !");
-			return (FALSE);
-		}
-
 		pf_result[pf_result_index++] = '0' + (char)(10 - dir);
 		i += ddx[dir];
 		j += ddy[dir];
@@ -179,9 +306,26 @@ bool findpath(int y, int x)
 
 	pf_result_index--;
 
+	/* Remember the path */
+	pf_cache.valid = TRUE;
+	pf_cache.level = cave->created_at;
+	pf_cache.y = y;
+	pf_cache.x = x;
+	pf_cache.sy = p_ptr->py;
+	pf_cache.sx = p_ptr->px;
+	pf_cache.len = pf_result_index + 1;
+
 	return (TRUE);
 }
 
+/*
+ * The number of steps left on the path found by findpath().
+ */
+int pathfind_path_length(void)
+{
+	return pf_result_index + 1;
+}
+
 /* Compute the direction (in the angband 123456789 sense) from a point to a
  * point. We decide to use diagonals if dx and dy are within a factor of two of
  * each other; otherwise we choose a cardinal direction. */
@@ -534,6 +678,185 @@ static void run_init(int dir)
 }
 
 
+/*
+ * What the runner makes of a newly adjacent grid
+ */
+enum run_grid {
+	RUN_GRID_OPEN,		/* Unknown, or known and passable */
+	RUN_GRID_WALL,		/* Known, and blocks the way */
+	RUN_GRID_NOTICE		/* Known, and interesting enough to stop for */
+};
+
+static enum run_grid run_grid_type(int y, int x)
+{
+	/* Unknown grids are open */
+	if (!(cave->info[y][x] & (CAVE_MARK))) return (RUN_GRID_OPEN);
+
+	/* Examine the terrain */
+	switch (cave->feat[y][x])
+	{
+		/* Floors */
+		case FEAT_FLOOR:
+
+		/* Secret doors */
+		case FEAT_SECRET:
+
+		/* Normal veins */
+		case FEAT_MAGMA:
+		case FEAT_QUARTZ:
+
+		/* Hidden treasure */
+		case FEAT_MAGMA_H:
+		case FEAT_QUARTZ_H:
+
+		/* Walls */
+		case FEAT_WALL_EXTRA:
+		case FEAT_WALL_INNER:
+		case FEAT_WALL_OUTER:
+		case FEAT_WALL_SOLID:
+		case FEAT_PERM_EXTRA:
+		case FEAT_PERM_INNER:
+		case FEAT_PERM_OUTER:
+		case FEAT_PERM_SOLID:
+		{
+			/* Ignore */
+			break;
+		}
+
+		/* Interesting feature */
+		default: return (RUN_GRID_NOTICE);
+	}
+
+	return (cave_ispassable(cave, y, x) ? RUN_GRID_OPEN : RUN_GRID_WALL);
+}
+
+
+/*
+ * The corridor graph.
+ *
+ * When running along a hallway, where the run goes next depends only on
+ * the terrain around the player and the direction the run came from.  So
+ * the first time the runner passes through a grid in a given direction we
+ * remember the outcome: either the next pair of directions, or that this
+ * is a junction (or dead end, or door...) where the run stops.  Later runs
+ * over the same ground just follow these links, only checking for the
+ * monsters, objects and traps which can turn up at any time.
+ *
+ * Each grid's links are only trusted while the map within RUN_LINK_REACH
+ * grids, which is as far as run_corridor_link() looks, hasn't changed since
+ * they were made.
+ */
+
+/* A link: run_cur_dir * 16 + run_old_dir, or one of these */
+#define RUN_LINK_UNKNOWN	0
+#define RUN_LINK_STOP		0xFF
+
+#define RUN_LINK_REACH		1
+
+static byte run_graph[DUNGEON_HGT][DUNGEON_WID][8];
+static u32b run_graph_stamp[DUNGEON_HGT][DUNGEON_WID];
+
+/*
+ * Work out where a hallway run at (py, px), having come from `prev_dir`,
+ * goes next.
+ */
+static byte run_corridor_link(int py, int px, int prev_dir)
+{
+	int i, max = (prev_dir & 0x01) + 1;
+	int new_dir, cur_dir, old_dir;
+	int option = 0, option2 = 0;
+
+	/* Look at every newly adjacent square. */
+	for (i = -max; i <= max; i++)
+	{
+		/* New direction */
+		new_dir = cycle[chome[prev_dir] + i];
+
+		switch (run_grid_type(py + ddy[new_dir], px + ddx[new_dir]))
+		{
+			case RUN_GRID_NOTICE: return (RUN_LINK_STOP);
+			case RUN_GRID_WALL: continue;
+			case RUN_GRID_OPEN: break;
+		}
+
+		/* The first new direction. */
+		if (!option)
+		{
+			option = new_dir;
+		}
+
+		/* Three new directions. Stop running. */
+		else if (option2)
+		{
+			return (RUN_LINK_STOP);
+		}
+
+		/* Two non-adjacent new directions.  Stop running. */
+		else if (option != cycle[chome[prev_dir] + i - 1])
+		{
+			return (RUN_LINK_STOP);
+		}
+
+		/* Two new (adjacent) directions (case 1) */
+		else if (new_dir & 0x01)
+		{
+			option2 = new_dir;
+		}
+
+		/* Two new (adjacent) directions (case 2) */
+		else
+		{
+			option2 = option;
+			option = new_dir;
+		}
+	}
+
+	/* No options */
+	if (!option) return (RUN_LINK_STOP);
+
+	/* One option */
+	else if (!option2)
+	{
+		/* Primary option, and no other options */
+		cur_dir = old_dir = option;
+	}
+
+	/* Two options, examining corners */
+	else
+	{
+		/* Primary option, and hack -- allow curving */
+		cur_dir = option;
+		old_dir = option2;
+	}
+
+	/* About to hit a known wall, stop */
+	if (see_wall(cur_dir, py, px)) return (RUN_LINK_STOP);
+
+	return (byte)(cur_dir * 16 + old_dir);
+}
+
+/*
+ * Follow the corridor graph from (py, px), filling it in if need be.
+ */
+static byte run_corridor_next(int py, int px, int prev_dir)
+{
+	byte *link = &run_graph[py][px][chome[prev_dir] - 4];
+	u32b stamp = cave_map_stamp_near(cave, py, px, RUN_LINK_REACH);
+
+	/* Forget everything we knew about this grid */
+	if (run_graph_stamp[py][px] != stamp)
+	{
+		memset(run_graph[py][px], RUN_LINK_UNKNOWN, sizeof(run_graph[py][px]));
+		run_graph_stamp[py][px] = stamp;
+	}
+
+	if (*link == RUN_LINK_UNKNOWN)
+		*link = run_corridor_link(py, px, prev_dir);
+
+	return (*link);
+}
+
+
 /*
  * Update the current "run" path
  *
@@ -548,14 +871,9 @@ static bool run_test(void)
 	int new_dir;
 
 	int row, col;
-	int i, max, inv;
-	int option, option2;
+	int i, max;
 
 
-	/* No options yet */
-	option = 0;
-	option2 = 0;
-
 	/* Where we came from */
 	prev_dir = p_ptr->run_old_dir;
 
@@ -599,101 +917,19 @@ static bool run_test(void)
 			return (TRUE);
 
 
-		/* Assume unknown */
-		inv = TRUE;
+		/* Hallways are handled below */
+		if (!p_ptr->run_open_area) continue;
 
-		/* Check memorized grids */
-		if (cave->info[row][col] & (CAVE_MARK))
+		switch (run_grid_type(row, col))
 		{
-			bool notice = TRUE;
-
-			/* Examine the terrain */
-			switch (cave->feat[row][col])
-			{
-				/* Floors */
-				case FEAT_FLOOR:
-
-				/* Secret doors */
-				case FEAT_SECRET:
-
-				/* Normal veins */
-				case FEAT_MAGMA:
-				case FEAT_QUARTZ:
-
-				/* Hidden treasure */
-				case FEAT_MAGMA_H:
-				case FEAT_QUARTZ_H:
-
-				/* Walls */
-				case FEAT_WALL_EXTRA:
-				case FEAT_WALL_INNER:
-				case FEAT_WALL_OUTER:
-				case FEAT_WALL_SOLID:
-				case FEAT_PERM_EXTRA:
-				case FEAT_PERM_INNER:
-				case FEAT_PERM_OUTER:
-				case FEAT_PERM_SOLID:
-				{
-					/* Ignore */
-					notice = FALSE;
-
-					/* Done */
-					break;
-				}
-			}
-
 			/* Interesting feature */
-			if (notice) return (TRUE);
-
-			/* The grid is "visible" */
-			inv = FALSE;
-		}
-
-		/* Analyze unknown grids and floors */
-		if (inv || cave_ispassable(cave, row, col))
-		{
-			/* Looking for open area */
-			if (p_ptr->run_open_area)
-			{
-				/* Nothing */
-			}
-
-			/* The first new direction. */
-			else if (!option)
-			{
-				option = new_dir;
-			}
-
-			/* Three new directions. Stop running. */
-			else if (option2)
-			{
-				return (TRUE);
-			}
+			case RUN_GRID_NOTICE: return (TRUE);
 
-			/* Two non-adjacent new directions.  Stop running. */
-			else if (option != cycle[chome[prev_dir] + i - 1])
-			{
-				return (TRUE);
-			}
+			/* Nothing */
+			case RUN_GRID_OPEN: break;
 
-			/* Two new (adjacent) directions (case 1) */
-			else if (new_dir & 0x01)
-			{
-				option2 = new_dir;
-			}
-
-			/* Two new (adjacent) directions (case 2) */
-			else
-			{
-				option2 = option;
-				option = new_dir;
-			}
-		}
-
-		/* Obstacle, while looking for open area */
-		else
-		{
-			if (p_ptr->run_open_area)
+			/* Obstacle, while looking for open area */
+			case RUN_GRID_WALL:
 			{
 				if (i < 0)
 				{
@@ -706,6 +942,8 @@ static bool run_test(void)
 					/* Break to the left */
 					p_ptr->run_break_left = TRUE;
 				}
+
+				break;
 			}
 		}
 	}
@@ -806,31 +1044,16 @@ static bool run_test(void)
 	/* Not looking for open area */
 	else
 	{
-		/* No options */
-		if (!option)
-		{
-			return (TRUE);
-		}
+		byte link = run_corridor_next(py, px, prev_dir);
 
-		/* One option */
-		else if (!option2)
-		{
-			/* Primary option */
-			p_ptr->run_cur_dir = option;
+		/* Junction, dead end, or something else worth stopping for */
+		if (link == RUN_LINK_STOP) return (TRUE);
 
-			/* No other options */
-			p_ptr->run_old_dir = option;
-		}
-
-		/* Two options, examining corners */
-		else
-		{
-			/* Primary option */
-			p_ptr->run_cur_dir = option;
+		p_ptr->run_cur_dir = link / 16;
+		p_ptr->run_old_dir = link % 16;
 
-			/* Hack -- allow curving */
-			p_ptr->run_old_dir = option2;
-		}
+		/* Known not to be heading into a wall */
+		return (FALSE);
 	}
 
 
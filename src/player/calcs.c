@@ -1563,61 +1563,76 @@ int weight_remaining(void)
 
 
 /*
- * Calculate the players current "state", taking into account
- * not only race/class intrinsics, but also objects being worn
- * and temporary spell effects.
- *
- * See also calc_mana() and calc_hitpoints().
- *
- * Take note of the new "speed code", in particular, a very strong
- * player will start slowing down as soon as he reaches 150 pounds,
- * but not until he reaches 450 pounds will he be half as fast as
- * a normal kobold.  This both hurts and helps the player, hurts
- * because in the old days a player could just avoid 300 pounds,
- * and helps because now carrying 300 pounds is not very painful.
- *
- * The "weapon" and "bow" do *not* add to the bonuses to hit or to
- * damage, since that would affect non-combat things.  These values
- * are actually added in later, at the appropriate place.
- *
- * If id_only is true, calc_bonuses() will only use the known
- * information of objects; thus it returns what the player _knows_
- * the character state to be.
+ * The equipment-derived part of the player's state.  Every field of
+ * "state" holds only the contribution of the worn items, so that it can
+ * be layered on top of the race/class base by calc_bonuses().
  */
-void calc_bonuses(object_type inventory[], player_state *state, bool id_only)
-{
-	int i, j, hold;
-	int extra_blows = 0, extra_shots = 0, extra_might = 0;
-
-	object_type *o_ptr;
-
-	bitflag f[OF_SIZE], collect_f[OF_SIZE];
-
-	/*** Reset ***/
-	memset(state, 0, sizeof *state);
-
-	/* Set various defaults */
-	state->speed = 110;
-	state->num_blows = 100;
-    state->dam_multiplier = 100;
-
-	/*** Extract race/class info ***/
-
-	/* Base infravision (purely racial) */
-	state->see_infra = p_ptr->race->infra;
+struct equip_bonuses {
+	player_state state;
+	bitflag flags[OF_SIZE];
+	int extra_blows;
+	int extra_shots;
+	int extra_might;
+};
 
-	/* Base skills */
-	for (i = 0; i < SKILL_MAX; i++)
-		state->skills[i] = p_ptr->race->r_skills[i] + p_ptr->class->c_skills[i];
+/*
+ * The parts of a worn object which calc_equip_bonuses() looks at, along
+ * with the awareness of its kind (which affects what the player knows
+ * about it).  Anything else, like the inscription, timeout or the cached
+ * description, can change without affecting the bonuses.
+ */
+struct equip_key {
+	struct object_kind *kind;
+	struct ego_item *ego;
+	byte tval;
+	bool aware;
+	u16b ident;
+	s16b pval[MAX_PVALS];
+	byte num_pvals;
+	bitflag flags[OF_SIZE];
+	bitflag known_flags[OF_SIZE];
+	bitflag pval_flags[MAX_PVALS][OF_SIZE];
+	s16b ac;
+	s16b to_a;
+	s16b to_finesse;
+	s16b to_prowess;
+};
 
+/*
+ * A cached equip_bonuses, along with the keys of the worn objects it was
+ * computed from.
+ */
+struct equip_cache {
+	bool valid;
+	struct equip_key slot[INVEN_TOTAL - INVEN_WIELD];
+	struct equip_bonuses bonuses;
+};
 
-	/*** Analyze player ***/
+/* One cache for the real state, one for the id_only state */
+static struct equip_cache equip_cache[2];
 
-	/* Extract the player flags */
-	player_flags(collect_f);
+/*
+ * Forget the cached equipment bonuses, forcing the next calc_bonuses()
+ * to rescan the equipment.
+ */
+void calc_bonuses_invalidate(void)
+{
+	equip_cache[0].valid = FALSE;
+	equip_cache[1].valid = FALSE;
+}
 
+/*
+ * Scan the equipment and total up its contribution to the player's state.
+ */
+static void calc_equip_bonuses(object_type inventory[],
+		struct equip_bonuses *eb, bool id_only)
+{
+	int i;
+	player_state *state = &eb->state;
+	object_type *o_ptr;
+	bitflag f[OF_SIZE];
 
-	/*** Analyze equipment ***/
+	memset(eb, 0, sizeof *eb);
 
 	/* Scan the equipment */
 	for (i = INVEN_WIELD; i < INVEN_TOTAL; i++)	{
@@ -1632,7 +1647,7 @@ void calc_bonuses(object_type inventory[], player_state *state, bool id_only)
 		else
 			object_flags(o_ptr, f);
 
-		of_union(collect_f, f);
+		of_union(eb->flags, f);
 
 		/* Affect stats */
 		if (of_has(f, OF_STR)) state->stat_add[A_STR] +=
@@ -1673,15 +1688,15 @@ void calc_bonuses(object_type inventory[], player_state *state, bool id_only)
 			o_ptr->pval[which_pval(o_ptr, OF_SPEED)];
 
 		/* Affect blows */
-		if (of_has(f, OF_BLOWS)) extra_blows +=
+		if (of_has(f, OF_BLOWS)) eb->extra_blows +=
 			o_ptr->pval[which_pval(o_ptr, OF_BLOWS)];
 
 		/* Affect shots */
-		if (of_has(f, OF_SHOTS)) extra_shots +=
+		if (of_has(f, OF_SHOTS)) eb->extra_shots +=
 			o_ptr->pval[which_pval(o_ptr, OF_SHOTS)];
 
 		/* Affect Might */
-		if (of_has(f, OF_MIGHT)) extra_might +=
+		if (of_has(f, OF_MIGHT)) eb->extra_might +=
 			o_ptr->pval[which_pval(o_ptr, OF_MIGHT)];
 
 		/* Modify the base armor class */
@@ -1722,6 +1737,156 @@ void calc_bonuses(object_type inventory[], player_state *state, bool id_only)
 			state->dis_to_prowess += o_ptr->to_prowess;
 		}
 	}
+}
+
+/*
+ * Fill in the key for one worn object, or an empty key for an empty slot.
+ */
+static void make_equip_key(const object_type *o_ptr, struct equip_key *key)
+{
+	WIPE_KEY(key);
+
+	if (!o_ptr->kind) return;
+
+	key->kind = o_ptr->kind;
+	key->ego = o_ptr->ego;
+	key->tval = o_ptr->tval;
+	key->aware = o_ptr->kind->aware;
+	key->ident = o_ptr->ident;
+	memcpy(key->pval, o_ptr->pval, sizeof key->pval);
+	key->num_pvals = o_ptr->num_pvals;
+	of_copy(key->flags, o_ptr->flags);
+	of_copy(key->known_flags, o_ptr->known_flags);
+	memcpy(key->pval_flags, o_ptr->pval_flags, sizeof key->pval_flags);
+	key->ac = o_ptr->ac;
+	key->to_a = o_ptr->to_a;
+	key->to_finesse = o_ptr->to_finesse;
+	key->to_prowess = o_ptr->to_prowess;
+}
+
+/*
+ * Find the equipment bonuses for the given inventory, reusing the cached
+ * result when the equipment hasn't changed since it was computed.
+ *
+ * Only the player's own inventory is cached; other inventories (such as
+ * the hypothetical ones built by obj-info.c) are always scanned afresh.
+ */
+static void get_equip_bonuses(object_type inventory[],
+		struct equip_bonuses *eb, bool id_only)
+{
+	struct equip_cache *cache = &equip_cache[id_only ? 1 : 0];
+	bool hit;
+	int i;
+
+	if (inventory != p_ptr->inventory) {
+		calc_equip_bonuses(inventory, eb, id_only);
+		return;
+	}
+
+	/* Compare against the snapshot, refreshing it as we go */
+	hit = cache->valid;
+	for (i = INVEN_WIELD; i < INVEN_TOTAL; i++) {
+		struct equip_key key;
+		struct equip_key *s_ptr = &cache->slot[i - INVEN_WIELD];
+
+		make_equip_key(&inventory[i], &key);
+		if (memcmp(s_ptr, &key, sizeof key)) {
+			memcpy(s_ptr, &key, sizeof key);
+			hit = FALSE;
+		}
+	}
+
+	if (!hit) {
+		calc_equip_bonuses(inventory, &cache->bonuses, id_only);
+		cache->valid = TRUE;
+	}
+
+	memcpy(eb, &cache->bonuses, sizeof *eb);
+}
+
+
+/*
+ * Calculate the players current "state", taking into account
+ * not only race/class intrinsics, but also objects being worn
+ * and temporary spell effects.
+ *
+ * See also calc_mana() and calc_hitpoints().
+ *
+ * Take note of the new "speed code", in particular, a very strong
+ * player will start slowing down as soon as he reaches 150 pounds,
+ * but not until he reaches 450 pounds will he be half as fast as
+ * a normal kobold.  This both hurts and helps the player, hurts
+ * because in the old days a player could just avoid 300 pounds,
+ * and helps because now carrying 300 pounds is not very painful.
+ *
+ * The "weapon" and "bow" do *not* add to the bonuses to hit or to
+ * damage, since that would affect non-combat things.  These values
+ * are actually added in later, at the appropriate place.
+ *
+ * If id_only is true, calc_bonuses() will only use the known
+ * information of objects; thus it returns what the player _knows_
+ * the character state to be.
+ *
+ * The equipment scan is cached (see get_equip_bonuses()), so repeated
+ * calls for timed effects and stat changes only redo the cheap part.
+ */
+void calc_bonuses(object_type inventory[], player_state *state, bool id_only)
+{
+	int i, j, hold;
+
+	object_type *o_ptr;
+
+	bitflag collect_f[OF_SIZE];
+
+	struct equip_bonuses eb;
+
+	/*** Reset ***/
+	memset(state, 0, sizeof *state);
+
+	/* Set various defaults */
+	state->speed = 110;
+	state->num_blows = 100;
+    state->dam_multiplier = 100;
+
+	/*** Extract race/class info ***/
+
+	/* Base infravision (purely racial) */
+	state->see_infra = p_ptr->race->infra;
+
+	/* Base skills */
+	for (i = 0; i < SKILL_MAX; i++)
+		state->skills[i] = p_ptr->race->r_skills[i] + p_ptr->class->c_skills[i];
+
+
+	/*** Analyze player ***/
+
+	/* Extract the player flags */
+	player_flags(collect_f);
+
+
+	/*** Analyze equipment ***/
+
+	get_equip_bonuses(inventory, &eb, id_only);
+
+	of_union(collect_f, eb.flags);
+
+	for (i = 0; i < A_MAX; i++)
+		state->stat_add[i] += eb.state.stat_add[i];
+	for (i = 0; i < SKILL_MAX; i++)
+		state->skills[i] += eb.state.skills[i];
+	for (i = 0; i < SL_MAX; i++)
+		state->slay_mult[i] = eb.state.slay_mult[i];
+
+	state->see_infra += eb.state.see_infra;
+	state->speed += eb.state.speed;
+	state->ac += eb.state.ac;
+	state->dis_ac += eb.state.dis_ac;
+	state->to_a += eb.state.to_a;
+	state->dis_to_a += eb.state.dis_to_a;
+	state->to_finesse += eb.state.to_finesse;
+	state->to_prowess += eb.state.to_prowess;
+	state->dis_to_finesse += eb.state.dis_to_finesse;
+	state->dis_to_prowess += eb.state.dis_to_prowess;
 
 
 	/*** Update all flags ***/
@@ -2067,10 +2232,10 @@ void calc_bonuses(object_type inventory[], player_state *state, bool id_only)
 		if (o_ptr->kind && !state->heavy_shoot)
 		{
 			/* Extra shots */
-			state->num_shots += extra_shots;
+			state->num_shots += eb.extra_shots;
 
 			/* Extra might */
-			state->ammo_mult += extra_might;
+			state->ammo_mult += eb.extra_might;
 
 			/* Hack -- Rangers love Bows */
 			if (player_has(PF_EXTRA_SHOT) &&
@@ -2305,6 +2470,7 @@ void notice_stuff(struct player *p)
 	{
 		p->notice &= ~(PN_SQUELCH);
 		squelch_drop();
+		map_cache_reset();
 	}
 
 	/* Combine the pack */
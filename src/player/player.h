@@ -32,6 +32,7 @@ extern const int blows_table[12][12];
 #endif
 
 void calc_bonuses(object_type inventory[], player_state *state, bool id_only);
+void calc_bonuses_invalidate(void);
 int calc_blows(const object_type *o_ptr, player_state *state);
 int calc_multiplier(const object_type *o_ptr, player_state *state);
 void notice_stuff(struct player *p);
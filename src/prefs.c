@@ -18,6 +18,7 @@
  *    are included in all such copies.  Other copyrights may also apply.
  */
 #include "angband.h"
+#include "cave.h"
 #include "keymap.h"
 #include "prefs.h"
 #include "squelch.h"
@@ -1062,6 +1063,9 @@ errr process_pref_file_command(const char *s)
 	errr e = parser_parse(p, s);
 	mem_free(parser_priv(p));
 	parser_destroy(p);
+
+	/* Visuals may have changed */
+	map_cache_reset();
 	return e;
 }
 
@@ -1126,6 +1130,9 @@ bool process_pref_file(const char *name, bool quiet, bool user)
 		file_close(f);
 		mem_free(parser_priv(p));
 		parser_destroy(p);
+
+		/* Visuals may have changed */
+		map_cache_reset();
 	}
 
 	/* Result */
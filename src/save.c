@@ -509,8 +509,8 @@ void wr_squelch(void)
 void wr_misc(void)
 {
 
-	/* XXX Old random artifact version, remove after 3.3 */
-	wr_u32b(63);
+	/* Random artifact version */
+	wr_u32b(randart_version);
 
 	/* Random artifact seed */
 	wr_u32b(seed_randart);
@@ -18,6 +18,7 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "game-event.h"
 #include "generate.h"
 #include "object/tvalsval.h"
 #include "object/object.h"
@@ -1144,7 +1145,7 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 				}
 
 				/* Forget the trap */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_forget(cave, y, x);
 
 				/* Destroy the trap */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
@@ -1194,7 +1195,7 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 				}
 
 				/* Forget the door */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_forget(cave, y, x);
 
 				/* Destroy the feature */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
@@ -1223,7 +1224,7 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 				}
 
 				/* Forget the wall */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_forget(cave, y, x);
 
 				/* Destroy the wall */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
@@ -1241,7 +1242,7 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 				}
 
 				/* Forget the wall */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_forget(cave, y, x);
 
 				/* Destroy the wall */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
@@ -1261,7 +1262,7 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 				}
 
 				/* Forget the wall */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_forget(cave, y, x);
 
 				/* Destroy the wall */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
@@ -1278,7 +1279,7 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 				}
 
 				/* Forget the wall */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_forget(cave, y, x);
 
 				/* Destroy the rubble */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
@@ -1305,7 +1306,7 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 				}
 
 				/* Forget the wall */
-				cave->info[y][x] &= ~(CAVE_MARK);
+				cave_forget(cave, y, x);
 
 				/* Destroy the feature */
 				cave_set_feat(cave, y, x, FEAT_FLOOR);
@@ -1390,7 +1391,7 @@ static bool project_f(int who, int r, int y, int x, int dam, int typ, bool obvio
 
 				/* Hack -- Forget "boring" grids */
 				if (cave->feat[y][x] <= FEAT_FLOOR)
-					cave->info[y][x] &= ~(CAVE_MARK);
+					cave_forget(cave, y, x);
 			}
 
 			/* Grid is in line of sight */
@@ -3238,6 +3239,7 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg)
 
 				cave_light_spot(cave, y, x);
 
+				event_flush();
 				Term_fresh();
 				if (p_ptr->redraw) redraw_stuff(p_ptr);
 
@@ -3377,6 +3379,8 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg)
 				}
 			}
 
+			event_flush();
+
 			/* Hack -- center the cursor */
 			move_cursor_relative(y2, x2);
 
@@ -505,7 +505,7 @@ void map_area(void)
 				if (cave->feat[y][x] > FEAT_FLOOR)
 				{
 					/* Memorize the object */
-					cave->info[y][x] |= (CAVE_MARK);
+					cave_memorize(cave, y, x);
 					cave_light_spot(cave, y, x);
 				}
 
@@ -519,7 +519,7 @@ void map_area(void)
 					if (cave->feat[yy][xx] >= FEAT_SECRET)
 					{
 						/* Memorize the walls */
-						cave->info[yy][xx] |= (CAVE_MARK);
+						cave_memorize(cave, yy, xx);
 						cave_light_spot(cave, yy, xx);
 					}
 				}
@@ -568,7 +568,7 @@ bool detect_traps(bool aware)
 			if (cave_isknowntrap(cave, y, x))
 			{
 				/* Hack -- Memorize */
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_memorize(cave, y, x);
 
 				/* We found something to detect */
 				detect = TRUE;
@@ -655,7 +655,7 @@ bool detect_doorstairs(bool aware)
 			     (cave->feat[y][x] == FEAT_BROKEN)))
 			{
 				/* Hack -- Memorize */
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_memorize(cave, y, x);
 
 				/* Redraw */
 				cave_light_spot(cave, y, x);
@@ -669,7 +669,7 @@ bool detect_doorstairs(bool aware)
 			    (cave->feat[y][x] == FEAT_MORE))
 			{
 				/* Hack -- Memorize */
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_memorize(cave, y, x);
 
 				/* Redraw */
 				cave_light_spot(cave, y, x);
@@ -730,7 +730,7 @@ bool detect_treasure(bool aware, bool full)
 			if ((cave->feat[y][x] == FEAT_MAGMA_K) ||
 			    (cave->feat[y][x] == FEAT_QUARTZ_K)) {
 				/* Hack -- Memorize */
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_memorize(cave, y, x);
 
 				/* Redraw */
 				cave_light_spot(cave, y, x);
@@ -741,16 +741,11 @@ bool detect_treasure(bool aware, bool full)
 		}
 	}
 
-	/* Scan objects */
-	for (i = 1; i < o_max; i++)	{
+	/* Scan the objects on the floor */
+	for (i = floor_object_first(); i;
+			i = floor_object_next(i)) {
 		object_type *o_ptr = object_byid(i);
 
-		/* Skip dead objects */
-		if (!o_ptr->kind) continue;
-
-		/* Skip held objects */
-		if (o_ptr->held_m_idx) continue;
-
 		/* Location */
 		y = o_ptr->iy;
 		x = o_ptr->ix;
@@ -824,7 +819,7 @@ bool detect_close_buried_treasure(void)
 			    (cave->feat[y][x] == FEAT_QUARTZ_K))
 			{
 				/* Hack -- Memorize */
-				cave->info[y][x] |= (CAVE_MARK);
+				cave_memorize(cave, y, x);
 
 				/* Redraw */
 				cave_light_spot(cave, y, x);
@@ -1981,7 +1976,7 @@ void destroy_area(int y1, int x1, int r, bool full)
 			if (cave_isstairs(cave, y, x)) continue;	
 			
 			/* Lose knowledge (keeping knowledge of stairs) */
-			cave->info[y][x] &= ~(CAVE_MARK);
+			cave_forget(cave, y, x);
 
 			/* Destroy any grid that isn't a permament wall */
 			if (!cave_isperm(cave, y, x))
@@ -2117,7 +2112,8 @@ void earthquake(int cy, int cx, int r)
 			cave->info[yy][xx] &= ~(CAVE_ROOM | CAVE_ICKY);
 
 			/* Lose light and knowledge */
-			cave->info[yy][xx] &= ~(CAVE_GLOW | CAVE_MARK);
+			cave->info[yy][xx] &= ~(CAVE_GLOW);
+			cave_forget(cave, yy, xx);
 			
 			/* Skip the epicenter */
 			if (!dx && !dy) continue;
@@ -2505,7 +2501,7 @@ static void cave_unlight(struct point_set *ps)
 		if (cave->feat[y][x] <= FEAT_FLOOR)
 		{
 			/* Forget the grid */
-			cave->info[y][x] &= ~(CAVE_MARK);
+			cave_forget(cave, y, x);
 		}
 	}
 
@@ -102,12 +102,91 @@ byte squelch_level[TYPE_MAX];
 const size_t squelch_size = TYPE_MAX;
 
 
+/*
+ * Compiled squelch rules.
+ *
+ * Which quality squelch group an object falls into depends only on its
+ * kind, so it is worked out once per kind by squelch_init().
+ *
+ * For objects in one of those groups, the rest of the verdict depends on
+ * what the player knows about the object and is slow to work out.  It is
+ * remembered in a small table, keyed on the object and everything the
+ * verdict depended on, and only worked out again once one of those changes.
+ * The affix and theme settings aren't copied into the key; instead, changing
+ * any of them moves on squelch_rules, which makes every memo stale.
+ */
+static byte *kind_squelch_type;
+static u32b squelch_rules = 1;
+
+/* Verdicts kept in the memo */
+#define SQUELCH_BY_QUALITY	0x01	/* By quality squelch level */
+#define SQUELCH_BY_AFFIX	0x02	/* By affix and theme settings */
+
+/*
+ * The memo table works like the one for object descriptions: each set holds
+ * the last SQUELCH_MEMO_WAYS verdicts which hashed to it, most recent first.
+ * It is larger, as every object on the level is checked on each floor scan.
+ */
+#define SQUELCH_MEMO_SETS	256
+#define SQUELCH_MEMO_WAYS	4
 
 /*
- * Initialise the squelch package (currently just asserts).
+ * What a verdict was worked out from.  The object's own identity (kind,
+ * artifact, affixes and so on) is here as well as what the player knows, so
+ * a verdict whose key matches can be reused even if the object has since
+ * been deleted and its slot reused.
+ */
+struct squelch_key {
+	const object_type *obj;
+	u32b rules;			/* squelch_rules, or 0 if unset */
+	byte level;			/* Quality squelch level for the object's type */
+	bool aware;			/* Whether the flavour was known */
+	struct object_kind *kind;
+	struct artifact *artifact;
+	struct ego_item *affix[MAX_AFFIXES];
+	struct theme *theme;
+	u16b ident;
+	bitflag flags[OF_SIZE];
+	bitflag known_flags[OF_SIZE];
+	bitflag pval_flags[MAX_PVALS][OF_SIZE];
+	s16b to_a, to_finesse, to_prowess;
+	s16b pval[MAX_PVALS];
+	byte num_pvals;
+};
+
+struct squelch_memo {
+	struct squelch_key key;
+	byte verdict;
+};
+
+static struct squelch_memo squelch_memo[SQUELCH_MEMO_SETS][SQUELCH_MEMO_WAYS];
+
+static squelch_type_t squelch_type_of_kind(const object_kind *kind);
+
+static void squelch_rules_changed(void)
+{
+	/* Never 0, which marks an empty memo */
+	if (++squelch_rules == 0) squelch_rules = 1;
+
+	p_ptr->notice |= PN_SQUELCH;
+}
+
+
+/*
+ * Initialise the squelch package.
  */
 void squelch_init(void)
 {
+	size_t i;
+
+	kind_squelch_type = C_ZNEW(z_info->k_max, byte);
+	for (i = 0; i < z_info->k_max; i++)
+		kind_squelch_type[i] = squelch_type_of_kind(&k_info[i]);
+}
+
+void squelch_cleanup(void)
+{
+	FREE(kind_squelch_type);
 }
 
 
@@ -136,6 +215,7 @@ void squelch_birth_init(void)
 		for (j = 0; j < EGO_TVALS_MAX; j++)
 			themes[i].squelch[j] = FALSE;
 
+	squelch_rules_changed();
 }
 
 
@@ -249,24 +329,32 @@ void object_squelch_flavor_of(const object_type *o_ptr)
 
 
 /*
- * Find the squelch type of the object, or TYPE_MAX if none
+ * Find the squelch type of an object kind, or TYPE_MAX if none
  */
-squelch_type_t squelch_type_of(const object_type *o_ptr)
+static squelch_type_t squelch_type_of_kind(const object_kind *kind)
 {
 	size_t i;
 
 	/* Find the appropriate squelch group */
 	for (i = 0; i < N_ELEMENTS(quality_mapping); i++)
 	{
-		if ((quality_mapping[i].tval == o_ptr->tval) &&
-			(quality_mapping[i].min_sval <= o_ptr->sval) &&
-			(quality_mapping[i].max_sval >= o_ptr->sval))
+		if ((quality_mapping[i].tval == kind->tval) &&
+			(quality_mapping[i].min_sval <= kind->sval) &&
+			(quality_mapping[i].max_sval >= kind->sval))
 			return quality_mapping[i].squelch_type;
 	}
 
 	return TYPE_MAX;
 }
 
+/*
+ * Find the squelch type of the object, or TYPE_MAX if none
+ */
+squelch_type_t squelch_type_of(const object_type *o_ptr)
+{
+	return kind_squelch_type[o_ptr->kind->kidx];
+}
+
 /**
  * Small helper function to see how an object trait compares to the one
  * in its base type.
@@ -489,7 +577,7 @@ void affix_set_squelch(ego_item_type *affix, int tval, bool state)
 		if (affix->tval[i] == tval)
 			affix->squelch[i] = state;
 
-	p_ptr->notice |= PN_SQUELCH;
+	squelch_rules_changed();
 }
 
 void theme_set_squelch(struct theme *theme, int tval, bool state)
@@ -500,7 +588,7 @@ void theme_set_squelch(struct theme *theme, int tval, bool state)
 		if (theme->tval[i] == tval)
 			theme->squelch[i] = state;
 
-	p_ptr->notice |= PN_SQUELCH;
+	squelch_rules_changed();
 }
 
 void affix_setall_squelch(ego_item_type *affix, bool state)
@@ -510,7 +598,7 @@ void affix_setall_squelch(ego_item_type *affix, bool state)
 	for (i = 0; i < EGO_TVALS_MAX; i++)
 		affix->squelch[i] = state;
 
-	p_ptr->notice |= PN_SQUELCH;
+	squelch_rules_changed();
 }
 
 void theme_setall_squelch(struct theme *theme, bool state)
@@ -520,9 +608,133 @@ void theme_setall_squelch(struct theme *theme, bool state)
 	for (i = 0; i < EGO_TVALS_MAX; i++)
 		theme->squelch[i] = state;
 
-	p_ptr->notice |= PN_SQUELCH;
+	squelch_rules_changed();
+}
+
+
+/*
+ * Work out what the verdict on `o_ptr` depends on, for quality squelch level
+ * `level`.
+ */
+static void squelch_key(struct squelch_key *key, const object_type *o_ptr,
+		byte level)
+{
+	WIPE_KEY(key);
+
+	key->obj = o_ptr;
+	key->rules = squelch_rules;
+	key->level = level;
+	key->aware = o_ptr->kind->aware;
+	key->kind = o_ptr->kind;
+	key->artifact = o_ptr->artifact;
+	memcpy(key->affix, o_ptr->affix, sizeof(key->affix));
+	key->theme = o_ptr->theme;
+	key->ident = o_ptr->ident;
+	of_copy(key->flags, o_ptr->flags);
+	of_copy(key->known_flags, o_ptr->known_flags);
+	memcpy(key->pval_flags, o_ptr->pval_flags, sizeof(key->pval_flags));
+	key->to_a = o_ptr->to_a;
+	key->to_finesse = o_ptr->to_finesse;
+	key->to_prowess = o_ptr->to_prowess;
+	memcpy(key->pval, o_ptr->pval, sizeof(key->pval));
+	key->num_pvals = o_ptr->num_pvals;
+}
+
+/*
+ * Find the set of remembered verdicts for an object.
+ */
+static struct squelch_memo *squelch_memo_set(const object_type *o_ptr)
+{
+	u32b h = (u32b)((size_t)o_ptr / sizeof(object_type));
+
+	return squelch_memo[(h ^ (h >> 8)) % SQUELCH_MEMO_SETS];
 }
 
+/*
+ * Look for a remembered verdict matching `key`.
+ */
+static const struct squelch_memo *squelch_memo_find(
+		const struct squelch_key *key)
+{
+	struct squelch_memo *set = squelch_memo_set(key->obj);
+	int i;
+
+	for (i = 0; i < SQUELCH_MEMO_WAYS; i++)
+		if (!memcmp(&set[i].key, key, sizeof(*key)))
+			return &set[i];
+
+	return NULL;
+}
+
+/*
+ * Remember a verdict, in place of any older one on the same object, or else
+ * of the least recent one in its set.
+ */
+static void squelch_memo_add(const struct squelch_key *key, byte verdict)
+{
+	struct squelch_memo *set = squelch_memo_set(key->obj);
+	int i;
+
+	for (i = 0; i < SQUELCH_MEMO_WAYS - 1; i++)
+		if (set[i].key.obj == key->obj)
+			break;
+
+	memmove(&set[1], &set[0], i * sizeof(set[0]));
+	memcpy(&set[0].key, key, sizeof(*key));
+	set[0].verdict = verdict;
+}
+
+/*
+ * Work out the parts of the squelch verdict on an object which depend on
+ * what the player knows about it, for an object of squelch type `type`.
+ */
+static byte squelch_verdict(const object_type *o_ptr, squelch_type_t type)
+{
+	const struct squelch_memo *memo;
+	struct squelch_key key;
+	byte verdict = 0;
+	bool squelch_by_affix = FALSE;
+	size_t i;
+
+	squelch_key(&key, o_ptr, squelch_level[type]);
+	memo = squelch_memo_find(&key);
+	if (memo)
+		return memo->verdict;
+
+	/* Squelch items known not to be special */
+	if (object_is_known_not_artifact(o_ptr) &&
+			squelch_level[type] == SQUELCH_ALL) {
+		verdict = SQUELCH_BY_QUALITY;
+	} else {
+		/* Squelch an item if all its affixes, and its theme if any, are
+		 * set to squelched */
+		for (i = 0; i < MAX_AFFIXES && o_ptr->affix[i] ; i++)
+			if (object_affix_is_known(o_ptr, o_ptr->affix[i]->eidx) &&
+					affix_is_squelched(o_ptr->affix[i], o_ptr->tval))
+				squelch_by_affix = TRUE;
+			else {
+				squelch_by_affix = FALSE;
+				break;
+			}
+
+		if (o_ptr->theme) {
+			/* Themed items *must* have affixes */
+			if (squelch_by_affix && object_theme_is_known(o_ptr) &&
+					theme_is_squelched(o_ptr->theme, o_ptr->tval))
+				verdict |= SQUELCH_BY_AFFIX;
+		} else if (squelch_by_affix)
+			verdict |= SQUELCH_BY_AFFIX;
+
+		/* Get result based on pseudo and the quality squelch level */
+		if (squelch_level_of(o_ptr) <= squelch_level[type])
+			verdict |= SQUELCH_BY_QUALITY;
+	}
+
+	/* Remember it */
+	squelch_memo_add(&key, verdict);
+
+	return verdict;
+}
 
 /*
  * Determines if an object is eligible for squelching.
@@ -530,8 +742,6 @@ void theme_setall_squelch(struct theme *theme, bool state)
 bool squelch_item_ok(const object_type *o_ptr)
 {
 	byte type;
-	size_t i;
-	bool squelch_by_affix = FALSE;
 
 	if (p_ptr->unignoring)
 		return FALSE;
@@ -555,40 +765,13 @@ bool squelch_item_ok(const object_type *o_ptr)
 	if (type == TYPE_MAX)
 		return FALSE;
 
-	/* Squelch items known not to be special */
-	if (object_is_known_not_artifact(o_ptr) &&
-			squelch_level[type] == SQUELCH_ALL)
-		return TRUE;
-
-	/* Squelch an item if all its affixes, and its theme if any, are
-	 * set to squelched */
-	for (i = 0; i < MAX_AFFIXES && o_ptr->affix[i] ; i++)
-		if (object_affix_is_known(o_ptr, o_ptr->affix[i]->eidx) &&
-				affix_is_squelched(o_ptr->affix[i], o_ptr->tval))
-			squelch_by_affix = TRUE;
-		else {
-			squelch_by_affix = FALSE;
-			break;
-		}
-
-	if (o_ptr->theme) {
-		/* Themed items *must* have affixes */
-		if (squelch_by_affix && object_theme_is_known(o_ptr) &&
-				theme_is_squelched(o_ptr->theme, o_ptr->tval))
-			return TRUE;
-	} else if (squelch_by_affix)
-		return TRUE;
-
-	/* Get result based on pseudo and the quality squelch level */
-	if (squelch_level_of(o_ptr) <= squelch_level[type])
-		return TRUE;
-	else
-		return FALSE;
+	/* Squelch by quality, affixes and theme */
+	return squelch_verdict(o_ptr, type) ? TRUE : FALSE;
 }
 
 /*
  * Determines if an object is already squelched. Same as squelch_item_ok above,
- * without the first (p_ptr->unignoring) test.
+ * without the first (p_ptr->unignoring) test or squelching by affix.
  */
 bool object_is_squelched(const object_type *o_ptr)
 {
@@ -613,15 +796,8 @@ bool object_is_squelched(const object_type *o_ptr)
 	if (type == TYPE_MAX)
 		return FALSE;
 
-	/* Squelch items known not to be special */
-	if (object_is_known_not_artifact(o_ptr) && squelch_level[type] == SQUELCH_ALL)
-		return TRUE;
-
-	/* Get result based on the feeling and the squelch_level */
-	if (squelch_level_of(o_ptr) <= squelch_level[type])
-		return TRUE;
-	else
-		return FALSE;
+	/* Squelch by quality */
+	return (squelch_verdict(o_ptr, type) & SQUELCH_BY_QUALITY) ? TRUE : FALSE;
 }
 
 /*
@@ -79,6 +79,36 @@ bool stats_db_open(void) {
 	return true;	
 }
 
+/**
+ * Open an existing database file instead, e.g. to finish off the counts
+ * from a run which didn't complete. Returns true on success, false on
+ * failure.
+ */
+bool stats_db_reopen(const char *filename) {
+	int result;
+
+	if (!file_exists(filename)) {
+		return false;
+	}
+
+	db_filename = string_make(filename);
+
+	result = sqlite3_open(db_filename, &db);
+	if (result) {
+		sqlite3_close(db);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Return the name of the open database file.
+ */
+const char *stats_db_filename(void) {
+	return db_filename;
+}
+
 /**
  * Call stats_close_db to close the database connection and free 
  * module variables.
@@ -40,7 +40,9 @@
 	if (err) return err;
 
 extern bool stats_db_open(void);
+extern bool stats_db_reopen(const char *filename);
 extern bool stats_db_close(void);
+extern const char *stats_db_filename(void);
 extern int stats_db_exec(char *sql_str);
 extern int stats_db_stmt_prep(sqlite3_stmt **sql_stmt, char *sql_str);
 extern int stats_db_bind_ints(sqlite3_stmt *sql_stmt, int num_cols, 
@@ -0,0 +1,262 @@
+/*
+ * File: stats/hist.c
+ * Purpose: sparse counters for the stats frontend
+ *
+ * Copyright (c) 2012 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational,
+ *    research,
+ *    and not for profit purposes provided that this copyright and
+ *    statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "z-virt.h"
+#include "stats/hist.h"
+
+/*
+ * Counters are kept in an open-addressed hash table of keys and counts,
+ * so only counters which have actually been touched take up any room.
+ * A slot with a zero count is empty; the table doubles when it gets 70%
+ * full.
+ *
+ * The table can be given a limit on the memory it takes up.  Once it has
+ * grown as far as that allows, it fills up past 70% instead of growing, and
+ * stats_hist_full() tells the owner to move the counters somewhere else
+ * (e.g. a checkpoint file) and clear them.  Counters are never thrown away;
+ * if the owner doesn't make room, the table grows anyway when it has no
+ * empty slots left.
+ */
+struct stats_hist {
+	size_t size;	/* Number of slots, always a power of two */
+	size_t used;	/* Number of slots in use */
+	size_t limit;	/* Most slots to grow to, or 0 for no limit */
+	u64b *keys;
+	u32b *counts;
+};
+
+#define HIST_MIN_SIZE	64
+
+/*
+ * Mix up the bits of a key, so that keys which differ only in their low
+ * fields don't all land next to each other.
+ */
+static size_t hist_hash(u64b key)
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ULL;
+	key ^= key >> 33;
+	return (size_t)key;
+}
+
+/*
+ * Find the slot holding `key`, or the empty slot where it would go.
+ */
+static size_t hist_slot(const struct stats_hist *h, u64b key)
+{
+	size_t mask = h->size - 1;
+	size_t i = hist_hash(key) & mask;
+
+	while (h->counts[i] && h->keys[i] != key)
+		i = (i + 1) & mask;
+
+	return i;
+}
+
+static void hist_alloc(struct stats_hist *h, size_t size)
+{
+	h->size = size;
+	h->used = 0;
+	h->keys = mem_zalloc(size * sizeof(*h->keys));
+	h->counts = mem_zalloc(size * sizeof(*h->counts));
+}
+
+static void hist_grow(struct stats_hist *h)
+{
+	size_t old_size = h->size, i;
+	u64b *old_keys = h->keys;
+	u32b *old_counts = h->counts;
+
+	hist_alloc(h, old_size * 2);
+
+	for (i = 0; i < old_size; i++) {
+		size_t j;
+
+		if (!old_counts[i]) continue;
+
+		j = hist_slot(h, old_keys[i]);
+		h->keys[j] = old_keys[i];
+		h->counts[j] = old_counts[i];
+		h->used++;
+	}
+
+	mem_free(old_keys);
+	mem_free(old_counts);
+}
+
+/**
+ * Make a new, empty set of counters, with room for about `hint` of them
+ * before it needs to grow.
+ */
+struct stats_hist *stats_hist_new(size_t hint)
+{
+	struct stats_hist *h = mem_zalloc(sizeof(*h));
+	size_t size = HIST_MIN_SIZE;
+
+	while (size * 7 / 10 < hint)
+		size *= 2;
+
+	hist_alloc(h, size);
+	return h;
+}
+
+void stats_hist_free(struct stats_hist *h)
+{
+	if (!h) return;
+
+	mem_free(h->keys);
+	mem_free(h->counts);
+	mem_free(h);
+}
+
+/**
+ * Limit the counters to about `bytes` bytes, or lift the limit if `bytes`
+ * is 0.  The limit is never less than the smallest table.
+ */
+void stats_hist_set_limit(struct stats_hist *h, size_t bytes)
+{
+	size_t slot = sizeof(*h->keys) + sizeof(*h->counts);
+
+	h->limit = 0;
+	if (!bytes) return;
+
+	h->limit = HIST_MIN_SIZE;
+	while (h->limit * 2 * slot <= bytes)
+		h->limit *= 2;
+}
+
+/**
+ * Return TRUE if the counters have reached their limit, so that adding new
+ * ones will fill the table up past the usual load or make it grow anyway.
+ */
+bool stats_hist_full(const struct stats_hist *h)
+{
+	return h->limit && h->size >= h->limit &&
+		(h->used + 1) * 10 > h->size * 7;
+}
+
+/**
+ * Set every counter back to 0, keeping the room that's been made for them
+ * unless that's more than the limit allows.
+ */
+void stats_hist_clear(struct stats_hist *h)
+{
+	if (h->limit && h->size > h->limit) {
+		mem_free(h->keys);
+		mem_free(h->counts);
+		hist_alloc(h, h->limit);
+		return;
+	}
+
+	memset(h->counts, 0, h->size * sizeof(*h->counts));
+	h->used = 0;
+}
+
+/**
+ * Add `n` to the counter for `key`.
+ */
+void stats_hist_add(struct stats_hist *h, u64b key, u32b n)
+{
+	size_t i;
+
+	if (!n) return;
+
+	i = hist_slot(h, key);
+	if (h->counts[i]) {
+		/* Stick at the top rather than wrapping round to "empty" */
+		if (h->counts[i] + n < n)
+			h->counts[i] = 0xFFFFFFFFUL;
+		else
+			h->counts[i] += n;
+		return;
+	}
+
+	/* A new counter; make room first if we're getting full and may grow */
+	if (((h->used + 1) * 10 > h->size * 7 && !stats_hist_full(h)) ||
+			h->used + 1 >= h->size) {
+		hist_grow(h);
+		i = hist_slot(h, key);
+	}
+
+	h->keys[i] = key;
+	h->counts[i] = n;
+	h->used++;
+}
+
+/**
+ * Return the counter for `key`, which is 0 if it has never been added to.
+ */
+u32b stats_hist_get(const struct stats_hist *h, u64b key)
+{
+	return h->counts[hist_slot(h, key)];
+}
+
+/**
+ * Add every counter in `from` to `into`, e.g. to combine the results of
+ * separate runs.
+ */
+void stats_hist_merge(struct stats_hist *into, const struct stats_hist *from)
+{
+	size_t i;
+
+	for (i = 0; i < from->size; i++)
+		if (from->counts[i])
+			stats_hist_add(into, from->keys[i], from->counts[i]);
+}
+
+/**
+ * Return the number of distinct counters.
+ */
+size_t stats_hist_count(const struct stats_hist *h)
+{
+	return h->used;
+}
+
+/**
+ * Return the number of bytes the counters take up.
+ */
+size_t stats_hist_size(const struct stats_hist *h)
+{
+	return sizeof(*h) + h->size * (sizeof(*h->keys) + sizeof(*h->counts));
+}
+
+/**
+ * Step through the counters in no particular order.  Set `*iter` to 0 to
+ * start; each call fills in the next key and count and returns TRUE, or
+ * returns FALSE when there are none left.  The counters mustn't be added
+ * to while stepping through them.
+ */
+bool stats_hist_next(const struct stats_hist *h, size_t *iter, u64b *key,
+	u32b *count)
+{
+	while (*iter < h->size) {
+		size_t i = (*iter)++;
+
+		if (!h->counts[i]) continue;
+
+		*key = h->keys[i];
+		*count = h->counts[i];
+		return TRUE;
+	}
+
+	return FALSE;
+}
@@ -0,0 +1,69 @@
+/*
+ * File: stats/hist.h
+ * Purpose: sparse counters for the stats frontend
+ *
+ * Copyright (c) 2012 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational,
+ *    research,
+ *    and not for profit purposes provided that this copyright and
+ *    statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef STATS_HIST_H
+#define STATS_HIST_H
+
+#include "h-basic.h"
+
+/*
+ * A histogram key packs everything which picks out one counter into 64 bits:
+ *
+ *   table (8 bits)  - which count table the counter belongs to
+ *   level (8 bits)  - dungeon level
+ *   origin (8 bits) - object origin, or 0
+ *   idx (16 bits)   - kind, race, artifact, vault or pit index
+ *   a, b (12 bits)  - the value(s) being counted, e.g. dice and sides
+ */
+#define STATS_KEY(table, level, origin, idx, a, b) \
+	(((u64b)((table) & 0xFF) << 56) | \
+	 ((u64b)((level) & 0xFF) << 48) | \
+	 ((u64b)((origin) & 0xFF) << 40) | \
+	 ((u64b)((idx) & 0xFFFF) << 24) | \
+	 ((u64b)((a) & 0xFFF) << 12) | \
+	 ((u64b)((b) & 0xFFF)))
+
+#define STATS_KEY_TABLE(k)	((int)(((k) >> 56) & 0xFF))
+#define STATS_KEY_LEVEL(k)	((int)(((k) >> 48) & 0xFF))
+#define STATS_KEY_ORIGIN(k)	((int)(((k) >> 40) & 0xFF))
+#define STATS_KEY_IDX(k)	((int)(((k) >> 24) & 0xFFFF))
+#define STATS_KEY_A(k)		((int)(((k) >> 12) & 0xFFF))
+#define STATS_KEY_B(k)		((int)((k) & 0xFFF))
+
+/* Largest value which fits in the a and b fields */
+#define STATS_KEY_VAL_MAX	0xFFF
+
+struct stats_hist;
+
+extern struct stats_hist *stats_hist_new(size_t hint);
+extern void stats_hist_free(struct stats_hist *h);
+extern void stats_hist_set_limit(struct stats_hist *h, size_t bytes);
+extern bool stats_hist_full(const struct stats_hist *h);
+extern void stats_hist_clear(struct stats_hist *h);
+extern void stats_hist_add(struct stats_hist *h, u64b key, u32b n);
+extern u32b stats_hist_get(const struct stats_hist *h, u64b key);
+extern void stats_hist_merge(struct stats_hist *into,
+	const struct stats_hist *from);
+extern size_t stats_hist_count(const struct stats_hist *h);
+extern size_t stats_hist_size(const struct stats_hist *h);
+extern bool stats_hist_next(const struct stats_hist *h, size_t *iter,
+	u64b *key, u32b *count);
+
+#endif /* STATS_HIST_H */
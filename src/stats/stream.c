@@ -0,0 +1,305 @@
+/*
+ * File: stats/stream.c
+ * Purpose: append-only checkpoint files for the stats frontend
+ *
+ * Copyright (c) 2012 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational,
+ *    research,
+ *    and not for profit purposes provided that this copyright and
+ *    statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "z-file.h"
+#include "z-form.h"
+#include "z-virt.h"
+#include "stats/stream.h"
+
+/*
+ * A checkpoint file is a series of records, one per checkpoint, each
+ * holding the counts added since the one before.  Nothing is ever
+ * rewritten, so a checkpoint costs as much as the counts that changed,
+ * and a crash can only spoil the record being written at the time.
+ *
+ * Each record is, in little-endian order:
+ *
+ *   "STCK"             - magic
+ *   u32b runs          - number of runs finished at this checkpoint
+ *   u32b n             - number of entries
+ *   n * (u64b key, u64b value)
+ *   u32b check         - FNV-1a hash of everything above
+ *
+ * A record which is cut short or doesn't check out ends the file, and is
+ * cut off by stats_stream_open() before any more records are added.
+ */
+#define STREAM_MAGIC	"STCK"
+#define STREAM_HEAD	12
+#define STREAM_ENTRY	16
+#define STREAM_MAX	(1L << 24)	/* Entries in one record, for sanity */
+
+struct stats_stream {
+	byte *buf;
+	size_t len;	/* Bytes used, including room for the header */
+	size_t size;	/* Bytes allocated */
+};
+
+static void put_u32b(byte *p, u32b v)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+		p[i] = (byte)(v >> (8 * i));
+}
+
+static void put_u64b(byte *p, u64b v)
+{
+	int i;
+
+	for (i = 0; i < 8; i++)
+		p[i] = (byte)(v >> (8 * i));
+}
+
+static u32b get_u32b(const byte *p)
+{
+	u32b v = 0;
+	int i;
+
+	for (i = 0; i < 4; i++)
+		v |= (u32b)p[i] << (8 * i);
+
+	return v;
+}
+
+static u64b get_u64b(const byte *p)
+{
+	u64b v = 0;
+	int i;
+
+	for (i = 0; i < 8; i++)
+		v |= (u64b)p[i] << (8 * i);
+
+	return v;
+}
+
+static u32b stream_check(const byte *p, size_t len)
+{
+	u32b h = 2166136261UL;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		h ^= p[i];
+		h *= 16777619UL;
+	}
+
+	return h;
+}
+
+/**
+ * Make a new, empty checkpoint to fill in with stats_stream_put().
+ */
+struct stats_stream *stats_stream_new(void)
+{
+	struct stats_stream *s = mem_zalloc(sizeof(*s));
+
+	s->size = 4096;
+	s->buf = mem_alloc(s->size);
+	s->len = STREAM_HEAD;
+
+	return s;
+}
+
+void stats_stream_free(struct stats_stream *s)
+{
+	if (!s) return;
+
+	mem_free(s->buf);
+	mem_free(s);
+}
+
+/**
+ * Add an entry to the checkpoint.
+ */
+void stats_stream_put(struct stats_stream *s, u64b key, u64b value)
+{
+	if (s->len + STREAM_ENTRY + 4 > s->size) {
+		s->size *= 2;
+		s->buf = mem_realloc(s->buf, s->size);
+	}
+
+	put_u64b(s->buf + s->len, key);
+	put_u64b(s->buf + s->len + 8, value);
+	s->len += STREAM_ENTRY;
+}
+
+/**
+ * Return the number of entries in the checkpoint so far.
+ */
+size_t stats_stream_count(const struct stats_stream *s)
+{
+	return (s->len - STREAM_HEAD) / STREAM_ENTRY;
+}
+
+/**
+ * Add the checkpoint to the end of the file at `path`, recording that
+ * `runs` runs have finished, and empty it ready for the next one.  The
+ * file is closed again afterwards, so that the record is on disk even if
+ * we crash later.
+ */
+bool stats_stream_append(struct stats_stream *s, const char *path, u32b runs)
+{
+	ang_file *f;
+	bool ok;
+
+	memcpy(s->buf, STREAM_MAGIC, 4);
+	put_u32b(s->buf + 4, runs);
+	put_u32b(s->buf + 8, (u32b)stats_stream_count(s));
+	put_u32b(s->buf + s->len, stream_check(s->buf, s->len));
+
+	f = file_open(path, MODE_APPEND, FTYPE_RAW);
+	if (!f) return FALSE;
+
+	ok = file_write(f, (const char *)s->buf, s->len + 4);
+	if (!file_close(f)) ok = FALSE;
+
+	s->len = STREAM_HEAD;
+	return ok;
+}
+
+/*
+ * Read records from `f` until the end or the first which is cut short or
+ * doesn't check out, calling `fn` (if there is one) for every entry in
+ * every complete record.  The number of runs from the last complete record
+ * goes in `runs`, the bytes those records take up in `good`, and whether
+ * anything was left over after them in `torn`.  Returns the number of
+ * complete records.
+ */
+static int stream_read(ang_file *f, stats_stream_fn fn, void *data,
+	u32b *runs, size_t *good, bool *torn)
+{
+	byte head[STREAM_HEAD];
+	byte *buf = NULL;
+	size_t size = 0;
+	int records = 0;
+	int n;
+
+	*runs = 0;
+	*good = 0;
+	*torn = FALSE;
+
+	while ((n = file_read(f, (char *)head, STREAM_HEAD)) != 0) {
+		u32b count = get_u32b(head + 8);
+		size_t len, i;
+
+		*torn = TRUE;
+		if (n != STREAM_HEAD) break;
+		if (memcmp(head, STREAM_MAGIC, 4) || count > STREAM_MAX) break;
+
+		/* Read the entries and check together */
+		len = STREAM_HEAD + (size_t)count * STREAM_ENTRY;
+		if (len + 4 > size) {
+			size = len + 4;
+			buf = mem_realloc(buf, size);
+		}
+		memcpy(buf, head, STREAM_HEAD);
+		if (file_read(f, (char *)buf + STREAM_HEAD, len + 4 - STREAM_HEAD)
+				!= (int)(len + 4 - STREAM_HEAD))
+			break;
+		if (get_u32b(buf + len) != stream_check(buf, len))
+			break;
+
+		if (fn)
+			for (i = STREAM_HEAD; i < len; i += STREAM_ENTRY)
+				fn(get_u64b(buf + i), get_u64b(buf + i + 8), data);
+
+		*runs = get_u32b(head + 4);
+		*good += len + 4;
+		*torn = FALSE;
+		records++;
+	}
+
+	mem_free(buf);
+
+	return records;
+}
+
+/**
+ * Get the checkpoint file at `path` ready to be added to, if there is one.
+ * Anything after the last complete record, left by a crash in the middle
+ * of a checkpoint, is cut off, since a replay would stop there and never
+ * reach the records added after it.  Returns FALSE if the file couldn't be
+ * put right.
+ */
+bool stats_stream_open(const char *path)
+{
+	char temp[1024];
+	char buf[4096];
+	ang_file *f, *out;
+	size_t good, left;
+	bool torn;
+	bool ok;
+	u32b runs;
+
+	f = file_open(path, MODE_READ, FTYPE_RAW);
+	if (!f) return TRUE;
+
+	stream_read(f, NULL, NULL, &runs, &good, &torn);
+	if (!torn) {
+		file_close(f);
+		return TRUE;
+	}
+
+	/* Copy the complete records to another file, and move that into place */
+	strnfmt(temp, sizeof(temp), "%s.new", path);
+	out = file_open(temp, MODE_WRITE, FTYPE_RAW);
+	ok = out && file_seek(f, 0);
+
+	for (left = good; ok && left; ) {
+		size_t n = MIN(left, sizeof(buf));
+
+		ok = file_read(f, buf, n) == (int)n && file_write(out, buf, n);
+		left -= n;
+	}
+
+	file_close(f);
+	if (out && !file_close(out)) ok = FALSE;
+
+	/* Some systems won't move a file on top of another */
+	if (ok && !file_move(temp, path)) {
+		file_delete(path);
+		ok = file_move(temp, path);
+	}
+
+	if (!ok && out) file_delete(temp);
+
+	return ok;
+}
+
+/**
+ * Read back the checkpoint file at `path`, calling `fn` for every entry in
+ * every complete record, in order.  The number of runs from the last
+ * complete record goes in `runs`.  Returns the number of records read, or
+ * -1 if the file can't be opened.
+ */
+int stats_stream_replay(const char *path, stats_stream_fn fn, void *data,
+	u32b *runs)
+{
+	ang_file *f = file_open(path, MODE_READ, FTYPE_RAW);
+	size_t good;
+	bool torn;
+	int records;
+
+	if (!f) return -1;
+
+	records = stream_read(f, fn, data, runs, &good, &torn);
+	file_close(f);
+
+	return records;
+}
@@ -0,0 +1,40 @@
+/*
+ * File: stats/stream.h
+ * Purpose: append-only checkpoint files for the stats frontend
+ *
+ * Copyright (c) 2012 Angband contributors
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational,
+ *    research,
+ *    and not for profit purposes provided that this copyright and
+ *    statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef STATS_STREAM_H
+#define STATS_STREAM_H
+
+#include "h-basic.h"
+
+struct stats_stream;
+
+typedef void (*stats_stream_fn)(u64b key, u64b value, void *data);
+
+extern struct stats_stream *stats_stream_new(void);
+extern void stats_stream_free(struct stats_stream *s);
+extern void stats_stream_put(struct stats_stream *s, u64b key, u64b value);
+extern size_t stats_stream_count(const struct stats_stream *s);
+extern bool stats_stream_open(const char *path);
+extern bool stats_stream_append(struct stats_stream *s, const char *path,
+	u32b runs);
+extern int stats_stream_replay(const char *path, stats_stream_fn fn,
+	void *data, u32b *runs);
+
+#endif /* STATS_STREAM_H */
@@ -1686,6 +1686,23 @@ void store_reset(void) {
 	}
 }
 
+/*
+ * Throw away a store's whole inventory.
+ */
+void store_clear(struct store *store)
+{
+	int i;
+
+	for (i = 0; i < store->stock_num; i++)
+		if (store->stock[i].artifact)
+			history_lose_artifact(store->stock[i].artifact);
+
+	for (i = 0; i < store->stock_size; i++)
+		object_wipe(&store->stock[i]);
+
+	store->stock_num = 0;
+}
+
 /*
  * Shuffle one of the stores.
  */
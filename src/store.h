@@ -10,6 +10,7 @@
 #define STORE_SHUFFLE		25    /* 1/Chance (per day) of an owner changing */
 #define STORE_MIN_KEEP  6       /* Min slots to "always" keep full (>0) */
 #define STORE_MAX_KEEP  18      /* Max slots to "always" keep full (<STORE_INVEN_MAX) */
+#define STORE_MIXING_DAYS	50    /* Days after which none of the old stock is likely to be left */
 
 /* List of store indices */
 enum
@@ -51,6 +52,7 @@ struct store {
 void store_init(void);
 void free_stores(void);
 void store_reset(void);
+void store_clear(struct store *store);
 void store_shuffle(struct store *store);
 void store_maint(struct store *store);
 s32b price_item(const object_type *o_ptr, bool store_buying, int qty);
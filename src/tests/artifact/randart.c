@@ -0,0 +1,111 @@
+/* artifact/randart */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "angband.h"
+#include "object/tvalsval.h"
+
+static artifact_type *a_start;
+
+int setup_tests(void **state) {
+	read_edit_files();
+	quarks_init();
+	p_ptr->race = races;
+	p_ptr->class = classes;
+	a_start = mem_alloc(z_info->a_max * sizeof(*a_start));
+	memcpy(a_start, a_info, z_info->a_max * sizeof(*a_start));
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	mem_free(a_start);
+	return 0;
+}
+
+/* Sum up what a set of randarts made with a given version came out as */
+static u32b randart_hash_version(u32b seed, u32b version) {
+	u32b hash = 2166136261UL;
+	int i;
+
+	memcpy(a_info, a_start, z_info->a_max * sizeof(*a_info));
+	randart_version = version;
+	do_randart(seed, TRUE);
+	randart_version = RANDART_VERSION;
+
+	for (i = 0; i < z_info->a_max; i++) {
+		const artifact_type *a_ptr = &a_info[i];
+		int v[8];
+		size_t j;
+
+		v[0] = a_ptr->tval;
+		v[1] = a_ptr->sval;
+		v[2] = a_ptr->to_a;
+		v[3] = a_ptr->to_finesse;
+		v[4] = a_ptr->to_prowess;
+		v[5] = a_ptr->alloc_prob[0];
+		v[6] = a_ptr->alloc_min[0];
+		v[7] = a_ptr->effect;
+
+		for (j = 0; j < N_ELEMENTS(v); j++)
+			hash = (hash ^ (u32b)v[j]) * 16777619UL;
+		for (j = 0; j < OF_SIZE; j++)
+			hash = (hash ^ a_ptr->flags[j]) * 16777619UL;
+	}
+
+	return hash;
+}
+
+static u32b randart_hash(u32b seed) {
+	return randart_hash_version(seed, RANDART_VERSION);
+}
+
+/* The same seed always gives the same set, whatever came before */
+int test_stable(void *state) {
+	u32b first = randart_hash(1234);
+
+	require(randart_hash(5678) != first);
+	eq(randart_hash(1234), first);
+	ok;
+}
+
+/*
+ * Fixed seeds give known sets.  The sequential ones are what the game made
+ * before RANDART_VERSION, so savefiles from then must still get them.  The
+ * values have to be worked out again if artifact.txt changes.
+ */
+int test_golden(void *state) {
+	eq(randart_hash(1234), 0x1FB9374AUL);
+	eq(randart_hash_version(1234, RANDART_VERSION_SEQUENTIAL), 0xB8D83877UL);
+	eq(randart_hash_version(5678, RANDART_VERSION_SEQUENTIAL), 0x8B24DCE8UL);
+	ok;
+}
+
+/* Every set has enough of each kind of normal artifact */
+int test_acceptable(void *state) {
+	int seed;
+
+	for (seed = 1; seed <= 5; seed++) {
+		int swords = 0, bows = 0, boots = 0, i;
+
+		randart_hash(seed);
+		for (i = ART_MIN_NORMAL; i < z_info->a_max; i++) {
+			if (a_info[i].tval == TV_SWORD) swords++;
+			if (a_info[i].tval == TV_BOW) bows++;
+			if (a_info[i].tval == TV_BOOTS) boots++;
+		}
+
+		require(swords >= 5);
+		require(bows >= 4);
+		require(boots >= 4);
+	}
+	ok;
+}
+
+const char *suite_name = "artifact/randart";
+struct test tests[] = {
+	{ "stable", test_stable },
+	{ "acceptable", test_acceptable },
+	{ "golden", test_golden },
+	{ NULL, NULL }
+};
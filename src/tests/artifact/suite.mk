@@ -1 +1 @@
-TESTPROGS += artifact/randname
+TESTPROGS += artifact/randname artifact/randart
@@ -0,0 +1,152 @@
+/* dist-field/bench
+ *
+ * Rough timings of the distance field against a plain queue-based search,
+ * over the whole level and out to monster flow depth.  Run with -v to see
+ * the numbers.
+ */
+
+#include "unit-test.h"
+#include "angband.h"
+#include "dist-field.h"
+#include "monster/constants.h"
+
+#define ROUNDS 200
+
+int setup_tests(void **state) {
+	*state = mem_zalloc(sizeof(struct dist_field));
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	mem_free(state);
+	return 0;
+}
+
+#define HGT DUNGEON_HGT
+#define WID DUNGEON_WID
+
+static bool open_grid[HGT][WID];
+static int queue_dist[HGT][WID];
+
+static bool grid_pass(struct cave *c, int y, int x) {
+	return open_grid[y][x];
+}
+
+/* A cavern: mostly open, with scattered walls and a solid edge */
+static void make_cavern(void) {
+	int y, x;
+
+	Rand_value = 42;
+	Rand_quick = TRUE;
+
+	for (y = 0; y < HGT; y++)
+		for (x = 0; x < WID; x++)
+			open_grid[y][x] = y > 0 && x > 0 && y < HGT - 1 &&
+				x < WID - 1 && !one_in_(4);
+
+	Rand_quick = FALSE;
+
+	open_grid[HGT / 2][WID / 2] = TRUE;
+}
+
+/* The way the searches used to be done */
+static int queue_search(int sy, int sx, int max) {
+	static int qy[HGT * WID], qx[HGT * WID];
+	int head = 0, tail = 0;
+	int y, x, i;
+
+	for (y = 0; y < HGT; y++)
+		for (x = 0; x < WID; x++)
+			queue_dist[y][x] = -1;
+
+	queue_dist[sy][sx] = 0;
+	qy[tail] = sy;
+	qx[tail++] = sx;
+
+	while (head < tail) {
+		int ty = qy[head], tx = qx[head++];
+		int d = queue_dist[ty][tx];
+
+		if (max && d == max) continue;
+
+		for (i = 0; i < 8; i++) {
+			y = ty + ddy_ddd[i];
+			x = tx + ddx_ddd[i];
+
+			if (!open_grid[y][x] || queue_dist[y][x] >= 0) continue;
+
+			queue_dist[y][x] = d + 1;
+			qy[tail] = y;
+			qx[tail++] = x;
+		}
+	}
+
+	return tail;
+}
+
+static int field_search(struct dist_field *f, int sy, int sx, int max) {
+	dist_field_init(f, HGT, WID, TRUE);
+	if (max)
+		dist_field_fill_near(f, NULL, grid_pass, sy, sx, max);
+	else
+		dist_field_fill(f, NULL, grid_pass);
+	dist_field_add_source(f, sy, sx);
+	dist_field_run(f, max);
+
+	return f->count;
+}
+
+static void report(const char *what, int grids, clock_t start) {
+	double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	if (verbose)
+		printf("\n    %-16s %5d grids: %8.1f us/search", what, grids,
+				secs * 1e6 / ROUNDS);
+}
+
+static void bench(struct dist_field *f, const char *what, int max) {
+	char name[40];
+	clock_t start;
+	int i, n = 0;
+
+	start = clock();
+	for (i = 0; i < ROUNDS; i++)
+		n = queue_search(HGT / 2, WID / 2, max);
+	strnfmt(name, sizeof(name), "queue, %s", what);
+	report(name, n, start);
+
+	start = clock();
+	for (i = 0; i < ROUNDS; i++)
+		n = field_search(f, HGT / 2, WID / 2, max);
+	strnfmt(name, sizeof(name), "field, %s", what);
+	report(name, n, start);
+}
+
+int test_level(void *state) {
+	struct dist_field *f = state;
+
+	make_cavern();
+	bench(f, "level", 0);
+	eq(field_search(f, HGT / 2, WID / 2, 0), queue_search(HGT / 2, WID / 2, 0));
+	if (verbose) printf("\n");
+	ok;
+}
+
+int test_flow(void *state) {
+	struct dist_field *f = state;
+	int max = MONSTER_FLOW_DEPTH - 1;
+
+	make_cavern();
+	bench(f, "flow", max);
+	eq(field_search(f, HGT / 2, WID / 2, max),
+			queue_search(HGT / 2, WID / 2, max));
+	if (verbose) printf("\n");
+	ok;
+}
+
+const char *suite_name = "dist-field/bench";
+struct test tests[] = {
+	{ "level", test_level },
+	{ "flow", test_flow },
+	{ NULL, NULL },
+};
@@ -0,0 +1,239 @@
+/* dist-field/field */
+
+#include "unit-test.h"
+#include "angband.h"
+#include "dist-field.h"
+
+int setup_tests(void **state) {
+	*state = mem_zalloc(sizeof(struct dist_field));
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	mem_free(state);
+	return 0;
+}
+
+#define HGT DUNGEON_HGT
+#define WID DUNGEON_WID
+
+static bool open_grid[HGT][WID];
+static int ref_dist[HGT][WID];
+
+static bool grid_pass(struct cave *c, int y, int x) {
+	return open_grid[y][x];
+}
+
+/* Scatter walls about, a third of the grids, with a solid edge */
+static void make_grid(u32b seed) {
+	int y, x;
+
+	Rand_value = seed;
+	Rand_quick = TRUE;
+
+	for (y = 0; y < HGT; y++)
+		for (x = 0; x < WID; x++)
+			open_grid[y][x] = y > 0 && x > 0 && y < HGT - 1 &&
+				x < WID - 1 && !one_in_(3);
+
+	Rand_quick = FALSE;
+}
+
+/* A plain queue-based search to check against */
+static void ref_search(const int *ys, const int *xs, int n, bool diagonal,
+		int max) {
+	static int qy[HGT * WID], qx[HGT * WID];
+	int head = 0, tail = 0;
+	int y, x, i;
+
+	for (y = 0; y < HGT; y++)
+		for (x = 0; x < WID; x++)
+			ref_dist[y][x] = -1;
+
+	for (i = 0; i < n; i++) {
+		if (ref_dist[ys[i]][xs[i]] == 0) continue;
+		ref_dist[ys[i]][xs[i]] = 0;
+		qy[tail] = ys[i];
+		qx[tail++] = xs[i];
+	}
+
+	while (head < tail) {
+		int ty = qy[head], tx = qx[head++];
+		int d = ref_dist[ty][tx];
+
+		if (max && d == max) continue;
+
+		for (i = 0; i < (diagonal ? 8 : 4); i++) {
+			y = ty + ddy_ddd[i];
+			x = tx + ddx_ddd[i];
+
+			if (y < 0 || x < 0 || y >= HGT || x >= WID) continue;
+			if (!open_grid[y][x] || ref_dist[y][x] >= 0) continue;
+
+			ref_dist[y][x] = d + 1;
+			qy[tail] = y;
+			qx[tail++] = x;
+		}
+	}
+}
+
+/* Count the grids which don't match */
+static int compare(struct dist_field *f) {
+	int y, x, bad = 0;
+
+	for (y = 0; y < HGT; y++)
+		for (x = 0; x < WID; x++)
+			if (dist_field_get(f, y, x) != ref_dist[y][x]) bad++;
+
+	return bad;
+}
+
+static int run_search(struct dist_field *f, const int *ys, const int *xs,
+		int n, bool diagonal, int max) {
+	int i;
+
+	dist_field_init(f, HGT, WID, diagonal);
+	dist_field_fill(f, NULL, grid_pass);
+	for (i = 0; i < n; i++)
+		dist_field_add_source(f, ys[i], xs[i]);
+	dist_field_run(f, max);
+
+	ref_search(ys, xs, n, diagonal, max);
+	return compare(f);
+}
+
+int test_single(void *state) {
+	struct dist_field *f = state;
+	int ys[] = { HGT / 2 }, xs[] = { WID / 2 };
+
+	make_grid(1);
+	open_grid[ys[0]][xs[0]] = TRUE;
+
+	eq(run_search(f, ys, xs, 1, TRUE, 0), 0);
+	eq(run_search(f, ys, xs, 1, FALSE, 0), 0);
+	eq(dist_field_get(f, ys[0], xs[0]), 0);
+	eq(dist_field_get(f, 0, 0), -1);
+	ok;
+}
+
+int test_multi(void *state) {
+	struct dist_field *f = state;
+	int ys[] = { 1, HGT - 2, 10, 40 }, xs[] = { 1, WID - 2, 100, 63 };
+	int i;
+
+	make_grid(2);
+	for (i = 0; i < 4; i++)
+		open_grid[ys[i]][xs[i]] = TRUE;
+
+	eq(run_search(f, ys, xs, 4, TRUE, 0), 0);
+	eq(run_search(f, ys, xs, 4, FALSE, 0), 0);
+	ok;
+}
+
+int test_max(void *state) {
+	struct dist_field *f = state;
+	int ys[] = { HGT / 2 }, xs[] = { 64 };
+	int y, x, far = 0;
+
+	make_grid(3);
+	open_grid[ys[0]][xs[0]] = TRUE;
+
+	eq(run_search(f, ys, xs, 1, TRUE, 7), 0);
+	eq(f->depth, 7);
+
+	for (y = 0; y < HGT; y++)
+		for (x = 0; x < WID; x++)
+			if (dist_field_get(f, y, x) > 7) far++;
+	eq(far, 0);
+	ok;
+}
+
+/* A source in a wall still gets out */
+int test_wall_source(void *state) {
+	struct dist_field *f = state;
+	int ys[] = { 20 }, xs[] = { 20 };
+
+	make_grid(4);
+	open_grid[20][20] = FALSE;
+	open_grid[20][21] = TRUE;
+
+	eq(run_search(f, ys, xs, 1, TRUE, 0), 0);
+	eq(dist_field_get(f, 20, 21), 1);
+	ok;
+}
+
+/* Stepping through the grids reached and the front */
+int test_next(void *state) {
+	struct dist_field *f = state;
+	int y, x, pos = 0, n = 0;
+
+	memset(open_grid, 0, sizeof(open_grid));
+	for (x = 60; x < 70; x++)
+		open_grid[5][x] = TRUE;
+
+	dist_field_init(f, HGT, WID, TRUE);
+	dist_field_fill(f, NULL, grid_pass);
+	dist_field_add_source(f, 5, 60);
+
+	require(dist_field_step(f));
+	require(dist_field_next_front(f, &pos, &y, &x));
+	eq(y, 5);
+	eq(x, 61);
+	require(!dist_field_next_front(f, &pos, &y, &x));
+
+	eq(dist_field_run(f, 0), 9);
+	eq(f->count, 10);
+
+	pos = 0;
+	while (dist_field_next(f, &pos, &y, &x)) {
+		eq(y, 5);
+		eq(x, 60 + n);
+		eq(dist_field_get(f, y, x), n);
+		n++;
+	}
+	eq(n, 10);
+	ok;
+}
+
+/* New sources after a search has finished pick out separate regions */
+int test_regions(void *state) {
+	struct dist_field *f = state;
+	int y, x, pos = 0, n = 0;
+
+	memset(open_grid, 0, sizeof(open_grid));
+	for (y = 1; y < 4; y++)
+		for (x = 1; x < 4; x++)
+			open_grid[y][x] = open_grid[y + 10][x + 100] = TRUE;
+
+	dist_field_init(f, HGT, WID, TRUE);
+	dist_field_fill(f, NULL, grid_pass);
+	dist_field_add_source(f, 1, 1);
+	eq(dist_field_run(f, 0), 2);
+	eq(f->count, 9);
+
+	dist_field_add_source(f, 13, 103);
+	eq(f->depth, 0);
+	eq(dist_field_run(f, 0), 2);
+	eq(f->count, 18);
+	eq(dist_field_get(f, 11, 101), 2);
+	eq(dist_field_get(f, 3, 3), 2);
+
+	dist_field_reset(f);
+	dist_field_add_source(f, 13, 103);
+	dist_field_run(f, 0);
+	while (dist_field_next(f, &pos, &y, &x)) n++;
+	eq(n, 9);
+	eq(dist_field_get(f, 3, 3), -1);
+	ok;
+}
+
+const char *suite_name = "dist-field/field";
+struct test tests[] = {
+	{ "single", test_single },
+	{ "multi", test_multi },
+	{ "max", test_max },
+	{ "wall-source", test_wall_source },
+	{ "next", test_next },
+	{ "regions", test_regions },
+	{ NULL, NULL },
+};
@@ -0,0 +1 @@
+TESTPROGS += dist-field/field dist-field/bench
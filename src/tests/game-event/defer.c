@@ -0,0 +1,152 @@
+/* game-event/defer.c */
+
+#include "unit-test.h"
+#include "game-event.h"
+
+/* What the handler has been sent, in order */
+static struct {
+	game_event_type type;
+	int x, y;
+	bool flag;
+} seen[64];
+static int n_seen;
+
+static void record(game_event_type type, game_event_data *data, void *user)
+{
+	seen[n_seen].type = type;
+	if (type == EVENT_MAP) {
+		seen[n_seen].x = data->point.x;
+		seen[n_seen].y = data->point.y;
+	} else if (data && type != EVENT_MESSAGE) {
+		seen[n_seen].flag = data->flag;
+	}
+	n_seen++;
+}
+
+static game_event_type watched[] = {
+	EVENT_MAP, EVENT_HP, EVENT_STATE, EVENT_MESSAGE, EVENT_END
+};
+
+int setup_tests(void **state) {
+	event_add_handler_set(watched, N_ELEMENTS(watched), record, NULL);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	event_remove_all_handlers();
+	return 0;
+}
+
+int test_immediate(void *state) {
+	n_seen = 0;
+	require(!event_is_deferred());
+
+	event_signal_point(EVENT_MAP, 3, 4);
+	eq(n_seen, 1);
+	eq(seen[0].x, 3);
+	eq(seen[0].y, 4);
+	ok;
+}
+
+int test_points(void *state) {
+	n_seen = 0;
+	event_set_deferred(TRUE);
+
+	event_signal_point(EVENT_MAP, 3, 4);
+	event_signal_point(EVENT_MAP, 5, 6);
+	event_signal_point(EVENT_MAP, 3, 4);
+	eq(n_seen, 0);
+
+	event_flush();
+	eq(n_seen, 2);
+	eq(seen[0].x, 3);
+	eq(seen[0].y, 4);
+	eq(seen[1].x, 5);
+	eq(seen[1].y, 6);
+
+	/* Sent points can be dirtied again */
+	event_signal_point(EVENT_MAP, 3, 4);
+	event_flush();
+	eq(n_seen, 3);
+
+	event_set_deferred(FALSE);
+	ok;
+}
+
+int test_whole_map(void *state) {
+	n_seen = 0;
+	event_set_deferred(TRUE);
+
+	event_signal_point(EVENT_MAP, 1, 1);
+	event_signal_point(EVENT_MAP, -1, -1);
+	event_signal_point(EVENT_MAP, 2, 2);
+	event_flush();
+
+	eq(n_seen, 1);
+	eq(seen[0].x, -1);
+	eq(seen[0].y, -1);
+
+	/* Nothing left over for next time */
+	event_signal_point(EVENT_MAP, 1, 1);
+	event_flush();
+	eq(n_seen, 2);
+	eq(seen[1].x, 1);
+
+	event_set_deferred(FALSE);
+	ok;
+}
+
+int test_order(void *state) {
+	n_seen = 0;
+	event_set_deferred(TRUE);
+
+	event_signal(EVENT_HP);
+	event_signal(EVENT_END);
+	event_signal_point(EVENT_MAP, 1, 1);
+	event_signal(EVENT_HP);
+	event_signal_flag(EVENT_STATE, TRUE);
+	event_signal_flag(EVENT_STATE, FALSE);
+	event_signal(EVENT_END);
+	eq(n_seen, 0);
+
+	/* Each once, in first-signalled order, with EVENT_END last */
+	event_flush();
+	eq(n_seen, 4);
+	eq(seen[0].type, EVENT_HP);
+	eq(seen[1].type, EVENT_MAP);
+	eq(seen[2].type, EVENT_STATE);
+	eq(seen[2].flag, FALSE);
+	eq(seen[3].type, EVENT_END);
+
+	event_set_deferred(FALSE);
+	ok;
+}
+
+int test_message(void *state) {
+	n_seen = 0;
+	event_set_deferred(TRUE);
+
+	/* A message sends everything queued before it */
+	event_signal(EVENT_HP);
+	event_signal_message(EVENT_MESSAGE, 0, "hello");
+	eq(n_seen, 2);
+	eq(seen[0].type, EVENT_HP);
+	eq(seen[1].type, EVENT_MESSAGE);
+
+	/* Turning deferral off sends the rest */
+	event_signal(EVENT_END);
+	event_set_deferred(FALSE);
+	eq(n_seen, 3);
+	eq(seen[2].type, EVENT_END);
+	ok;
+}
+
+const char *suite_name = "game-event/defer";
+struct test tests[] = {
+	{ "immediate", test_immediate },
+	{ "points", test_points },
+	{ "whole_map", test_whole_map },
+	{ "order", test_order },
+	{ "message", test_message },
+	{ NULL, NULL }
+};
@@ -0,0 +1,89 @@
+/* object/desc */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "angband.h"
+#include "object/tvalsval.h"
+
+int setup_tests(void **state) {
+	read_edit_files();
+	quarks_init();
+	p_ptr->race = races;
+	p_ptr->class = classes;
+	*state = 0;
+	return 0;
+}
+
+NOTEARDOWN
+
+static struct object_kind *first_kind(int tval) {
+	size_t i;
+
+	for (i = 0; i < z_info->k_max; i++)
+		if (k_info[i].tval == tval && k_info[i].name)
+			return &k_info[i];
+
+	return NULL;
+}
+
+/* Cached descriptions follow the stack size, inscription and knowledge */
+int test_cache(void *state) {
+	struct object obj;
+	struct object_kind *kind = first_kind(TV_SCROLL);
+	char buf[80], first[80];
+	size_t len;
+
+	require(kind);
+	kind->aware = FALSE;
+	kind->tried = FALSE;
+	object_prep(&obj, kind, 1, AVERAGE);
+	obj.number = 1;
+
+	len = object_desc(first, sizeof(first), &obj, ODESC_ARTICLE | ODESC_FULL);
+	require(len == strlen(first));
+
+	/* Same again comes from the memo */
+	eq(object_desc(buf, sizeof(buf), &obj, ODESC_ARTICLE | ODESC_FULL), len);
+	require(streq(buf, first));
+
+	obj.number = 3;
+	object_desc(buf, sizeof(buf), &obj, ODESC_ARTICLE | ODESC_FULL);
+	require(!strncmp(buf, "3 ", 2));
+
+	obj.note = quark_add("foo");
+	object_desc(buf, sizeof(buf), &obj, ODESC_ARTICLE | ODESC_FULL);
+	require(strstr(buf, "{foo"));
+
+	object_flavor_tried(&obj);
+	object_desc(buf, sizeof(buf), &obj, ODESC_ARTICLE | ODESC_FULL);
+	require(strstr(buf, "tried"));
+
+	object_flavor_aware(&obj);
+	object_desc(buf, sizeof(buf), &obj, ODESC_ARTICLE | ODESC_FULL);
+	require(strstr(buf, kind->name));
+	require(!strstr(buf, "tried"));
+
+	/* Each mode is remembered separately */
+	object_desc(first, sizeof(first), &obj, ODESC_BASE);
+	require(strstr(first, kind->name));
+	require(!strstr(first, "{"));
+	object_desc(first, sizeof(first), &obj, ODESC_ARTICLE | ODESC_FULL);
+	require(streq(buf, first));
+
+	/* Copies are described the same */
+	{
+		struct object copy;
+
+		object_copy(&copy, &obj);
+		object_desc(first, sizeof(first), &copy, ODESC_ARTICLE | ODESC_FULL);
+		require(streq(buf, first));
+	}
+
+	ok;
+}
+
+const char *suite_name = "object/desc";
+struct test tests[] = {
+	{ "cache", test_cache },
+	{ NULL, NULL }
+};
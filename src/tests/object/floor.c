@@ -0,0 +1,86 @@
+/* object/floor */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "angband.h"
+#include "cave.h"
+#include "object/tvalsval.h"
+
+int setup_tests(void **state) {
+	read_edit_files();
+	cave = cave_new();
+	cave->height = DUNGEON_HGT;
+	cave->width = DUNGEON_WID;
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	wipe_o_list(cave);
+	cave_free(cave);
+	return 0;
+}
+
+static struct object_kind *first_kind(int tval) {
+	size_t i;
+
+	for (i = 0; i < z_info->k_max; i++)
+		if (k_info[i].tval == tval && k_info[i].name)
+			return &k_info[i];
+
+	return NULL;
+}
+
+static s16b place(int y, int x, int tval, byte origin) {
+	object_type obj;
+
+	object_prep(&obj, first_kind(tval), 1, AVERAGE);
+	obj.origin = origin;
+	return floor_carry(cave, y, x, &obj);
+}
+
+static int count(void) {
+	int n = 0;
+	s16b i;
+
+	for (i = floor_object_first(); i; i = floor_object_next(i)) {
+		/* Everything on the list is a live object on the floor */
+		if (!object_byid(i)->kind || object_byid(i)->held_m_idx)
+			return -1;
+		n++;
+	}
+
+	return n;
+}
+
+int test_list(void *state) {
+	s16b a = place(5, 5, TV_POTION, ORIGIN_FLOOR);
+	s16b b = place(5, 6, TV_POTION, ORIGIN_VAULT);
+	s16b c = place(6, 6, TV_SWORD, ORIGIN_FLOOR);
+
+	require(a && b && c);
+	eq(count(), 3);
+
+	/* Deleting an object takes it off */
+	delete_object_idx(a);
+	eq(count(), 2);
+
+	/* Moving objects about in the object list keeps them on */
+	compact_objects(0);
+	eq(count(), 2);
+
+	/* So does clearing a grid */
+	delete_object(6, 6);
+	eq(count(), 1);
+
+	/* And leaving the level empties it */
+	wipe_o_list(cave);
+	eq(count(), 0);
+	ok;
+}
+
+const char *suite_name = "object/floor";
+struct test tests[] = {
+	{ "list", test_list },
+	{ NULL, NULL }
+};
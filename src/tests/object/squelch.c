@@ -0,0 +1,94 @@
+/* object/squelch */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "angband.h"
+#include "object/tvalsval.h"
+#include "squelch.h"
+
+int setup_tests(void **state) {
+	read_edit_files();
+	squelch_birth_init();
+	*state = 0;
+	return 0;
+}
+
+NOTEARDOWN
+
+static struct object_kind *first_kind(int tval) {
+	size_t i;
+
+	for (i = 0; i < z_info->k_max; i++)
+		if (k_info[i].tval == tval && k_info[i].name)
+			return &k_info[i];
+
+	return NULL;
+}
+
+/* The cached verdict follows the settings and what the player knows */
+int test_quality(void *state) {
+	struct object obj;
+	struct object_kind *kind = first_kind(TV_SWORD);
+
+	require(kind);
+	object_prep(&obj, kind, 1, AVERAGE);
+	eq(squelch_type_of(&obj), TYPE_WEAPON_POINTY);
+
+	squelch_level[TYPE_WEAPON_POINTY] = SQUELCH_ALL;
+	eq(squelch_item_ok(&obj), FALSE);
+
+	obj.ident |= IDENT_NOTART;
+	eq(squelch_item_ok(&obj), TRUE);
+	eq(object_is_squelched(&obj), TRUE);
+
+	squelch_level[TYPE_WEAPON_POINTY] = SQUELCH_NONE;
+	eq(squelch_item_ok(&obj), FALSE);
+
+	squelch_level[TYPE_WEAPON_POINTY] = SQUELCH_ALL;
+	eq(squelch_item_ok(&obj), TRUE);
+
+	/* Copies get the same verdict, and their own once they differ */
+	{
+		struct object copy;
+
+		object_copy(&copy, &obj);
+		eq(squelch_item_ok(&copy), TRUE);
+		copy.ident &= ~IDENT_NOTART;
+		eq(squelch_item_ok(&copy), FALSE);
+	}
+
+	p_ptr->unignoring = TRUE;
+	eq(squelch_item_ok(&obj), FALSE);
+	p_ptr->unignoring = FALSE;
+
+	squelch_level[TYPE_WEAPON_POINTY] = SQUELCH_NONE;
+	ok;
+}
+
+/* Kinds without a quality group only go by flavour */
+int test_kind(void *state) {
+	struct object obj;
+	struct object_kind *kind = first_kind(TV_FLASK);
+
+	require(kind);
+	object_prep(&obj, kind, 1, AVERAGE);
+	eq(squelch_type_of(&obj), TYPE_MAX);
+	eq(squelch_item_ok(&obj), FALSE);
+
+	if (kind->aware)
+		kind_squelch_when_aware(kind);
+	else
+		kind_squelch_when_unaware(kind);
+	eq(squelch_item_ok(&obj), TRUE);
+
+	kind_squelch_clear(kind);
+	eq(squelch_item_ok(&obj), FALSE);
+	ok;
+}
+
+const char *suite_name = "object/squelch";
+struct test tests[] = {
+	{ "quality", test_quality },
+	{ "kind", test_kind },
+	{ NULL, NULL }
+};
@@ -1 +1 @@
-TESTPROGS += object/attack object/util
+TESTPROGS += object/attack object/util object/squelch object/desc object/floor
@@ -0,0 +1,84 @@
+/* observe/message.c */
+
+#include "unit-test.h"
+#include "game-event.h"
+#include "observe.h"
+#include "z-form.h"
+
+int setup_tests(void **state) {
+	observe_messages_watch(TRUE);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	observe_messages_watch(FALSE);
+	return 0;
+}
+
+int test_order(void *state) {
+	char buf[80];
+	u16b type;
+
+	event_signal_message(EVENT_MESSAGE, 3, "first");
+	event_signal_message(EVENT_MESSAGE, 5, "second");
+
+	require(observe_message_next(buf, sizeof(buf), &type));
+	require(!strcmp(buf, "first"));
+	eq(type, 3);
+	require(observe_message_next(buf, sizeof(buf), &type));
+	require(!strcmp(buf, "second"));
+	eq(type, 5);
+	require(!observe_message_next(buf, sizeof(buf), &type));
+	ok;
+}
+
+int test_overflow(void *state) {
+	char buf[80];
+	int i;
+
+	/* Only the most recent 256 are kept */
+	for (i = 0; i < 300; i++) {
+		strnfmt(buf, sizeof(buf), "%d", i);
+		event_signal_message(EVENT_MESSAGE, 0, buf);
+	}
+
+	require(observe_message_next(buf, sizeof(buf), NULL));
+	require(!strcmp(buf, "44"));
+	for (i = 45; i < 300; i++)
+		require(observe_message_next(buf, sizeof(buf), NULL));
+	require(!strcmp(buf, "299"));
+	require(!observe_message_next(buf, sizeof(buf), NULL));
+	ok;
+}
+
+int test_stop(void *state) {
+	char buf[80];
+
+	observe_messages_watch(FALSE);
+	event_signal_message(EVENT_MESSAGE, 0, "ignored");
+	require(!observe_message_next(buf, sizeof(buf), NULL));
+
+	observe_messages_watch(TRUE);
+	event_signal_message(EVENT_MESSAGE, 0, "seen");
+	require(observe_message_next(buf, sizeof(buf), NULL));
+	require(!strcmp(buf, "seen"));
+	ok;
+}
+
+/* Redrawing the message line isn't a message */
+int test_redraw(void *state) {
+	char buf[80];
+
+	event_signal(EVENT_MESSAGE);
+	require(!observe_message_next(buf, sizeof(buf), NULL));
+	ok;
+}
+
+const char *suite_name = "observe/message";
+struct test tests[] = {
+	{ "order", test_order },
+	{ "overflow", test_overflow },
+	{ "stop", test_stop },
+	{ "redraw", test_redraw },
+	{ NULL, NULL }
+};
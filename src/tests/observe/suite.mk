@@ -0,0 +1 @@
+TESTPROGS += observe/message
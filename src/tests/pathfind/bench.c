@@ -0,0 +1,130 @@
+/* pathfind/bench
+ *
+ * Rough timings of findpath() over long routes through caverns.
+ * Run with -v to see the numbers.
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "angband.h"
+#include "cave.h"
+#include "pathfind.h"
+
+#define ROUNDS 50
+
+int setup_tests(void **state) {
+	read_edit_files();
+	cave = cave_new();
+	cave->height = DUNGEON_HGT;
+	cave->width = DUNGEON_WID;
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cave_free(cave);
+	return 0;
+}
+
+/*
+ * A known cavern: mostly open, with scattered walls, and a long wall down
+ * the middle with a single gap at the bottom so the route has to double
+ * back.
+ */
+static void build_cavern(void) {
+	int y, x;
+
+	Rand_value = 42;
+	Rand_quick = TRUE;
+
+	for (y = 0; y < DUNGEON_HGT; y++) {
+		for (x = 0; x < DUNGEON_WID; x++) {
+			bool wall = !cave_in_bounds_fully(cave, y, x) || one_in_(3);
+
+			if (x == DUNGEON_WID / 2 && y < DUNGEON_HGT - 3) wall = TRUE;
+			if (x == DUNGEON_WID / 2 && y == DUNGEON_HGT - 2) wall = FALSE;
+
+			cave->feat[y][x] = wall ? FEAT_WALL_EXTRA : FEAT_FLOOR;
+			cave->info[y][x] = CAVE_MARK;
+		}
+	}
+
+	Rand_quick = FALSE;
+
+	/* Clear the ends */
+	cave->feat[1][1] = FEAT_FLOOR;
+	cave->feat[1][DUNGEON_WID - 2] = FEAT_FLOOR;
+}
+
+/* The same, but the player hasn't seen the half with the target in */
+static void forget_far_side(void) {
+	int y, x;
+
+	for (y = 0; y < DUNGEON_HGT; y++)
+		for (x = DUNGEON_WID / 2 + 1; x < DUNGEON_WID; x++)
+			cave->info[y][x] = 0;
+}
+
+static void bench(const char *what) {
+	clock_t start = clock();
+	double secs;
+	int i, len = 0;
+
+	for (i = 0; i < ROUNDS; i++) {
+		/* Make sure nothing is reused */
+		cave->created_at++;
+
+		if (findpath(1, DUNGEON_WID - 2))
+			len = pathfind_path_length();
+	}
+
+	secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+	if (verbose)
+		printf("\n    %-16s %4d steps: %8.1f us/path", what, len,
+				secs * 1e6 / ROUNDS);
+}
+
+int test_cavern(void *state) {
+	build_cavern();
+	p_ptr->py = 1;
+	p_ptr->px = 1;
+
+	bench("known cavern");
+	require(findpath(1, DUNGEON_WID - 2));
+	require(pathfind_path_length() > DUNGEON_WID);
+
+	forget_far_side();
+	bench("half explored");
+	require(findpath(1, DUNGEON_WID - 2));
+
+	if (verbose) printf("\n");
+	ok;
+}
+
+/* Following a path shouldn't mean searching again */
+int test_follow(void *state) {
+	clock_t start;
+	int i;
+
+	build_cavern();
+	p_ptr->py = 1;
+	p_ptr->px = 1;
+	require(findpath(1, DUNGEON_WID - 2));
+
+	start = clock();
+	for (i = 0; i < ROUNDS * 100; i++)
+		require(findpath(1, DUNGEON_WID - 2));
+
+	if (verbose)
+		printf("\n    %-16s %8.1f us/path\n", "cached",
+				(double)(clock() - start) / CLOCKS_PER_SEC * 1e6 /
+				(ROUNDS * 100));
+	ok;
+}
+
+const char *suite_name = "pathfind/bench";
+struct test tests[] = {
+	{ "cavern", test_cavern },
+	{ "follow", test_follow },
+	{ NULL, NULL },
+};
@@ -0,0 +1,178 @@
+/* pathfind/findpath
+ *
+ * Tests for findpath() on hand-built levels.
+ */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "angband.h"
+#include "cave.h"
+#include "pathfind.h"
+
+int setup_tests(void **state) {
+	read_edit_files();
+	cave = cave_new();
+	cave->height = DUNGEON_HGT;
+	cave->width = DUNGEON_WID;
+	*state = 0;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cave_free(cave);
+	return 0;
+}
+
+/* Fill the level with walls the player knows about */
+static void fill_known_walls(void) {
+	int y, x;
+
+	for (y = 0; y < DUNGEON_HGT; y++) {
+		for (x = 0; x < DUNGEON_WID; x++) {
+			cave->feat[y][x] = FEAT_WALL_EXTRA;
+			cave->info[y][x] = CAVE_MARK;
+		}
+	}
+}
+
+static void carve(int y, int x) {
+	cave->feat[y][x] = FEAT_FLOOR;
+}
+
+/*
+ * One long corridor zig-zagging down the whole level: along every other
+ * row, joined alternately at the right and left ends.
+ */
+static void build_zigzag(void) {
+	int y, x;
+
+	fill_known_walls();
+	for (y = 1; y < DUNGEON_HGT - 1; y += 2) {
+		for (x = 1; x < DUNGEON_WID - 1; x++)
+			carve(y, x);
+
+		if (y + 2 < DUNGEON_HGT - 1)
+			carve(y + 1, (y / 2) % 2 ? 1 : DUNGEON_WID - 2);
+	}
+}
+
+/* Shortest route by breadth-first search, or -1 if there isn't one */
+static int reference_length(int ty, int tx) {
+	static s16b dist[DUNGEON_HGT][DUNGEON_WID];
+	static int queue[DUNGEON_HGT * DUNGEON_WID];
+	int head = 0, tail = 0;
+	int y, x;
+
+	for (y = 0; y < DUNGEON_HGT; y++)
+		for (x = 0; x < DUNGEON_WID; x++)
+			dist[y][x] = -1;
+
+	dist[p_ptr->py][p_ptr->px] = 0;
+	queue[tail++] = p_ptr->py * DUNGEON_WID + p_ptr->px;
+
+	while (head < tail) {
+		int g = queue[head++], dir;
+
+		y = g / DUNGEON_WID;
+		x = g % DUNGEON_WID;
+		if (y == ty && x == tx) return dist[y][x];
+
+		for (dir = 1; dir < 10; dir++) {
+			int ny = y + ddy[dir], nx = x + ddx[dir];
+
+			if (dir == 5 || !cave_in_bounds_fully(cave, ny, nx)) continue;
+			if (dist[ny][nx] >= 0) continue;
+			if ((cave->info[ny][nx] & CAVE_MARK) &&
+					!cave_ispassable(cave, ny, nx))
+				continue;
+
+			dist[ny][nx] = dist[y][x] + 1;
+			queue[tail++] = ny * DUNGEON_WID + nx;
+		}
+	}
+
+	return -1;
+}
+
+/* Unknown grids count as open, so an unexplored level is one big room */
+int test_unknown(void *state) {
+	int y, x;
+
+	for (y = 0; y < DUNGEON_HGT; y++) {
+		for (x = 0; x < DUNGEON_WID; x++) {
+			cave->feat[y][x] = FEAT_WALL_EXTRA;
+			cave->info[y][x] = 0;
+		}
+	}
+
+	p_ptr->py = 1;
+	p_ptr->px = 1;
+	require(findpath(DUNGEON_HGT - 2, DUNGEON_WID - 2));
+	eq(pathfind_path_length(), DUNGEON_WID - 3);
+
+	require(findpath(20, 3));
+	eq(pathfind_path_length(), 19);
+
+	/* Going nowhere */
+	require(findpath(1, 1));
+	eq(pathfind_path_length(), 0);
+	ok;
+}
+
+/* Routes far longer than the old search window */
+int test_long_route(void *state) {
+	int len;
+
+	build_zigzag();
+	cave->created_at++;
+
+	p_ptr->py = 1;
+	p_ptr->px = 1;
+	require(findpath(DUNGEON_HGT - 3, 1));
+	len = reference_length(DUNGEON_HGT - 3, 1);
+	require(len > 250);
+	eq(pathfind_path_length(), len);
+
+	/* The target can be a wall */
+	require(findpath(2, 5));
+	eq(pathfind_path_length(), 4);
+	ok;
+}
+
+/* Asking again while following the path picks up where we left off */
+int test_cache(void *state) {
+	int len;
+
+	build_zigzag();
+	cave->created_at++;
+
+	p_ptr->py = 1;
+	p_ptr->px = 1;
+	require(findpath(DUNGEON_HGT - 3, 1));
+	len = pathfind_path_length();
+
+	/* Walk along the first corridor */
+	p_ptr->px = 50;
+	require(findpath(DUNGEON_HGT - 3, 1));
+	eq(pathfind_path_length(), len - 49);
+
+	/* Forgetting a wall doesn't block the old path, so it is kept */
+	cave->info[2][60] = 0;
+	require(findpath(DUNGEON_HGT - 3, 1));
+	eq(pathfind_path_length(), len - 49);
+
+	/* A new search would have used the gap */
+	cave->created_at++;
+	require(findpath(DUNGEON_HGT - 3, 1));
+	eq(pathfind_path_length(), reference_length(DUNGEON_HGT - 3, 1));
+	require(pathfind_path_length() < len - 49);
+	ok;
+}
+
+const char *suite_name = "pathfind/findpath";
+struct test tests[] = {
+	{ "unknown", test_unknown },
+	{ "long-route", test_long_route },
+	{ "cache", test_cache },
+	{ NULL, NULL },
+};
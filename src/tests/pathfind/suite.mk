@@ -1 +1 @@
-TESTPROGS += pathfind/pathfind
+TESTPROGS += pathfind/pathfind pathfind/findpath pathfind/bench
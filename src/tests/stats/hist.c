@@ -0,0 +1,136 @@
+/* stats/hist */
+
+#include "unit-test.h"
+#include "stats/hist.h"
+
+int setup_tests(void **state) {
+	*state = stats_hist_new(0);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	stats_hist_free(state);
+	return 0;
+}
+
+int test_key(void *state) {
+	u64b key = STATS_KEY(5, 100, 13, 600, 145, 4095);
+
+	eq(STATS_KEY_TABLE(key), 5);
+	eq(STATS_KEY_LEVEL(key), 100);
+	eq(STATS_KEY_ORIGIN(key), 13);
+	eq(STATS_KEY_IDX(key), 600);
+	eq(STATS_KEY_A(key), 145);
+	eq(STATS_KEY_B(key), 4095);
+	ok;
+}
+
+int test_add(void *state) {
+	struct stats_hist *h = state;
+	u64b key = STATS_KEY(1, 2, 3, 4, 5, 6);
+
+	eq(stats_hist_get(h, key), 0);
+	stats_hist_add(h, key, 1);
+	stats_hist_add(h, key, 2);
+	stats_hist_add(h, STATS_KEY(1, 2, 3, 4, 5, 7), 0);
+	eq(stats_hist_get(h, key), 3);
+	eq(stats_hist_count(h), 1);
+
+	/* Counts stick at the top rather than wrapping */
+	stats_hist_add(h, key, 0xFFFFFFFFUL);
+	eq(stats_hist_get(h, key), 0xFFFFFFFFUL);
+	ok;
+}
+
+int test_grow(void *state) {
+	struct stats_hist *h = stats_hist_new(0);
+	size_t small = stats_hist_size(h), iter = 0;
+	u64b key;
+	u32b count, total = 0;
+	int i;
+
+	for (i = 0; i < 5000; i++)
+		stats_hist_add(h, STATS_KEY(1, i % 100, 0, i, 0, 0), i + 1);
+
+	require(stats_hist_size(h) > small);
+	eq(stats_hist_count(h), 5000);
+	for (i = 0; i < 5000; i++)
+		eq(stats_hist_get(h, STATS_KEY(1, i % 100, 0, i, 0, 0)), i + 1);
+
+	/* Stepping through sees every counter once */
+	i = 0;
+	while (stats_hist_next(h, &iter, &key, &count)) {
+		eq(count, STATS_KEY_IDX(key) + 1);
+		total += count;
+		i++;
+	}
+	eq(i, 5000);
+	eq(total, 5000 * 5001 / 2);
+
+	stats_hist_free(h);
+	ok;
+}
+
+/* A limited table stops growing, but keeps every counter */
+int test_limit(void *state) {
+	struct stats_hist *h = stats_hist_new(0);
+	size_t full_size;
+	int i, added = 0;
+
+	stats_hist_set_limit(h, 4096);
+	while (!stats_hist_full(h))
+		stats_hist_add(h, STATS_KEY(1, 0, 0, added++, 0, 0), 1);
+	full_size = stats_hist_size(h);
+	require(full_size <= 4096);
+
+	/* Past the limit it fills up, then grows rather than lose anything */
+	for (i = 0; i < 1000; i++)
+		stats_hist_add(h, STATS_KEY(1, 0, 0, added++, 0, 0), 1);
+	eq(stats_hist_count(h), added);
+	for (i = 0; i < added; i++)
+		eq(stats_hist_get(h, STATS_KEY(1, 0, 0, i, 0, 0)), 1);
+
+	/* Clearing goes back down to the limit */
+	require(stats_hist_size(h) > full_size);
+	stats_hist_clear(h);
+	eq(stats_hist_size(h), full_size);
+	eq(stats_hist_count(h), 0);
+	require(!stats_hist_full(h));
+
+	stats_hist_free(h);
+	ok;
+}
+
+int test_merge(void *state) {
+	struct stats_hist *a = stats_hist_new(0);
+	struct stats_hist *b = stats_hist_new(0);
+
+	stats_hist_add(a, 1, 10);
+	stats_hist_add(a, 2, 20);
+	stats_hist_add(b, 2, 5);
+	stats_hist_add(b, 3, 7);
+
+	stats_hist_merge(a, b);
+	eq(stats_hist_get(a, 1), 10);
+	eq(stats_hist_get(a, 2), 25);
+	eq(stats_hist_get(a, 3), 7);
+	eq(stats_hist_count(a), 3);
+
+	/* The source is left alone */
+	eq(stats_hist_get(b, 2), 5);
+	eq(stats_hist_count(b), 2);
+
+	stats_hist_free(a);
+	stats_hist_free(b);
+	ok;
+}
+
+const char *suite_name = "stats/hist";
+struct test tests[] = {
+	{ "key", test_key },
+	{ "add", test_add },
+	{ "grow", test_grow },
+	{ "limit", test_limit },
+	{ "merge", test_merge },
+	{ NULL, NULL }
+};
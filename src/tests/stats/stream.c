@@ -0,0 +1,89 @@
+/* stats/stream */
+
+#include "unit-test.h"
+#include "stats/stream.h"
+#include "z-file.h"
+
+struct replay_sum {
+	int entries;
+	u64b total;
+};
+
+static void add_entry(u64b key, u64b value, void *data)
+{
+	struct replay_sum *sum = data;
+
+	sum->entries++;
+	sum->total += key * value;
+}
+
+int setup_tests(void **state) {
+	*state = stats_stream_new();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	stats_stream_free(state);
+	return 0;
+}
+
+int test_replay(void *state) {
+	struct stats_stream *s = state;
+	char path[] = "/tmp/ckpt.XXXXXX";
+	int fd = mkstemp(path);
+	struct replay_sum sum = { 0, 0 };
+	u32b runs;
+	ang_file *f;
+	int i;
+
+	require(fd >= 0);
+	close(fd);
+
+	/* Two checkpoints, the second big enough to need more room */
+	stats_stream_put(s, 3, 4);
+	stats_stream_put(s, 5, 0x100000000ULL);
+	eq(stats_stream_count(s), 2);
+	require(stats_stream_append(s, path, 10));
+	eq(stats_stream_count(s), 0);
+
+	for (i = 0; i < 1000; i++)
+		stats_stream_put(s, 1, 1);
+	require(stats_stream_append(s, path, 20));
+
+	eq(stats_stream_replay(path, add_entry, &sum, &runs), 2);
+	eq(runs, 20);
+	eq(sum.entries, 1002);
+	require(sum.total == 12 + 5 * 0x100000000ULL + 1000);
+
+	/* A record cut short is ignored, along with anything after it */
+	f = file_open(path, MODE_APPEND, FTYPE_RAW);
+	require(f);
+	file_write(f, "STCK\x1e\0\0\0\x01\0\0\0abc", 15);
+	file_close(f);
+
+	sum.entries = 0;
+	eq(stats_stream_replay(path, add_entry, &sum, &runs), 2);
+	eq(runs, 20);
+	eq(sum.entries, 1002);
+
+	/* Opening the file again cuts it off, so new records can be read */
+	require(stats_stream_open(path));
+	stats_stream_put(s, 7, 1);
+	require(stats_stream_append(s, path, 30));
+
+	sum.entries = 0;
+	eq(stats_stream_replay(path, add_entry, &sum, &runs), 3);
+	eq(runs, 30);
+	eq(sum.entries, 1003);
+
+	file_delete(path);
+	require(stats_stream_open(path));
+	eq(stats_stream_replay(path, add_entry, &sum, &runs), -1);
+	ok;
+}
+
+const char *suite_name = "stats/stream";
+struct test tests[] = {
+	{ "replay", test_replay },
+	{ NULL, NULL }
+};
@@ -0,0 +1 @@
+TESTPROGS += stats/hist stats/stream
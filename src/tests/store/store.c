@@ -79,6 +79,26 @@ int test_enough_magic(void *state) {
 	ok;
 }
 
+/*
+ * Coming back to town after a long time away should leave the shops
+ * stocked as normal.
+ */
+int test_long_absence(void *state) {
+	int n;
+
+	store_reset();
+	daycount = 5000;
+	dungeon_change_level(0);
+	eq(daycount, 0);
+
+	for (n = 0; n < MAX_STORES; n++) {
+		if (n == STORE_HOME) continue;
+		require(stores[n].stock_num > 0);
+		require(stores[n].stock_num <= STORE_INVEN_MAX);
+	}
+	ok;
+}
+
 const char *suite_name = "store/store";
 struct test tests[] = {
 	{ "Enough items in Armoury", test_enough_armor },
@@ -86,5 +106,6 @@ struct test tests[] = {
 	{ "Enough items in Temple", test_enough_temple },
 	{ "Enough items in Alchemists", test_enough_alchemy },
 	{ "Enough items in Magicians", test_enough_magic },
+	{ "Long absence", test_long_absence },
 	{ NULL, NULL }
 };
@@ -0,0 +1,117 @@
+/* z-bitflag/bench.c
+ *
+ * Rough timings of the flag set operations, at the sizes the game uses.
+ * Run with -v to see the numbers; the tests themselves always pass.
+ */
+
+#include "unit-test.h"
+#include "angband.h"
+
+NOSETUP
+NOTEARDOWN
+
+#define ROUNDS 2000000
+
+/* Stop the compiler throwing the work away */
+static volatile int sink;
+
+static bitflag a[FLAG_MASK_MAX], b[FLAG_MASK_MAX], c[FLAG_MASK_MAX];
+
+static void report(const char *what, size_t size, clock_t start)
+{
+	double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	if (verbose)
+		printf("\n    %-16s %2d bytes: %6.1f ns/call", what, (int)size,
+				secs * 1e9 / ROUNDS);
+}
+
+static void bench_size(size_t size)
+{
+	static const bitflag mask[FLAG_MASK_MAX] =
+		FLAG_MASK(RF_PASS_WALL, RF_KILL_WALL);
+	clock_t start;
+	int i, n = 0;
+
+	for (i = 0; i < FLAG_MASK_MAX; i++) {
+		a[i] = (bitflag) (i * 37);
+		b[i] = (bitflag) (i * 101);
+	}
+
+	/* Make sure the predicates have to look at everything */
+	flag_wipe(c, size);
+
+	start = clock();
+	for (i = 0; i < ROUNDS; i++) n += flag_is_inter(a, c, size);
+	report("flag_is_inter", size, start);
+
+	start = clock();
+	for (i = 0; i < ROUNDS; i++) n += flag_is_subset(a, c, size);
+	report("flag_is_subset", size, start);
+
+	start = clock();
+	for (i = 0; i < ROUNDS; i++) n += flag_is_empty(c, size);
+	report("flag_is_empty", size, start);
+
+	start = clock();
+	for (i = 0; i < ROUNDS; i++) n += flag_union(c, a, size);
+	report("flag_union", size, start);
+
+	start = clock();
+	for (i = 0; i < ROUNDS; i++) n += flag_inter(c, b, size);
+	report("flag_inter", size, start);
+
+	start = clock();
+	for (i = 0; i < ROUNDS; i++) n += flag_diff(c, b, size);
+	report("flag_diff", size, start);
+
+	start = clock();
+	for (i = 0; i < ROUNDS; i++) flag_negate(c, size);
+	report("flag_negate", size, start);
+
+	start = clock();
+	for (i = 0; i < ROUNDS; i++) n += flag_next(a, size, FLAG_START + i % 8);
+	report("flag_next", size, start);
+
+	start = clock();
+	for (i = 0; i < ROUNDS; i++)
+		n += flags_test(c, size, RF_PASS_WALL, RF_KILL_WALL, FLAG_END);
+	report("flags_test", size, start);
+
+	start = clock();
+	for (i = 0; i < ROUNDS; i++) n += flag_is_inter(c, mask, size);
+	report("FLAG_MASK", size, start);
+
+	start = clock();
+	for (i = 0; i < ROUNDS; i++)
+		n += flags_set(c, size, RF_PASS_WALL, RF_KILL_WALL, FLAG_END);
+	report("flags_set", size, start);
+
+	sink = n;
+}
+
+int test_object_flags(void *state) {
+	bench_size(OF_SIZE);
+	if (verbose) printf("\n  %-16s  ", "");
+	ok;
+}
+
+int test_monster_flags(void *state) {
+	bench_size(RF_SIZE);
+	if (verbose) printf("\n  %-16s  ", "");
+	ok;
+}
+
+int test_spell_flags(void *state) {
+	bench_size(RSF_SIZE);
+	if (verbose) printf("\n  %-16s  ", "");
+	ok;
+}
+
+const char *suite_name = "z-bitflag/bench";
+struct test tests[] = {
+	{ "object-flags", test_object_flags },
+	{ "monster-flags", test_monster_flags },
+	{ "spell-flags", test_spell_flags },
+	{ NULL, NULL }
+};
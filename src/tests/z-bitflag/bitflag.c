@@ -0,0 +1,226 @@
+/* z-bitflag/bitflag.c */
+
+#include "unit-test.h"
+#include "z-bitflag.h"
+
+NOSETUP
+NOTEARDOWN
+
+/* Big enough for a couple of words plus odd bytes at either end */
+#define MAX_SIZE 40
+
+static u32b seed = 1;
+
+static bitflag next_byte(bool sparse)
+{
+	seed = seed * 1103515245 + 12345;
+
+	/* Mostly empty bytes, to exercise the skipping in flag_next() */
+	if (sparse && (seed >> 16) % 4) return 0;
+
+	return (bitflag) (seed >> 16);
+}
+
+static void fill(bitflag *f, size_t size, bool sparse)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++)
+		f[i] = next_byte(sparse);
+}
+
+/* Whether flag `i` is on, the slow way */
+static bool bit(const bitflag *f, int i)
+{
+	i -= FLAG_START;
+	return (f[i / 8] >> (i % 8)) & 1;
+}
+
+int test_predicates(void *state) {
+	bitflag a[MAX_SIZE], b[MAX_SIZE];
+	size_t size;
+	int n;
+
+	for (size = 1; size <= MAX_SIZE; size++) {
+		for (n = 0; n < 50; n++) {
+			bool inter = FALSE, subset = TRUE, empty = TRUE, full = TRUE;
+			int i;
+
+			fill(a, size, n % 2);
+			fill(b, size, n % 3 == 0);
+
+			/* Sometimes make b a subset of a */
+			if (n % 5 == 0) {
+				size_t j;
+				for (j = 0; j < size; j++) b[j] &= a[j];
+			}
+
+			for (i = FLAG_START; i < FLAG_MAX(size); i++) {
+				if (bit(a, i) && bit(b, i)) inter = TRUE;
+				if (!bit(a, i) && bit(b, i)) subset = FALSE;
+				if (bit(a, i)) empty = FALSE;
+				else full = FALSE;
+			}
+
+			eq(flag_is_inter(a, b, size), inter);
+			eq(flag_is_subset(a, b, size), subset);
+			eq(flag_is_empty(a, size), empty);
+			eq(flag_is_full(a, size), full);
+		}
+
+		flag_wipe(a, size);
+		require(flag_is_empty(a, size));
+		flag_setall(a, size);
+		require(flag_is_full(a, size));
+		a[size - 1] = 0x7f;
+		require(!flag_is_full(a, size));
+	}
+
+	ok;
+}
+
+int test_operations(void *state) {
+	bitflag a[MAX_SIZE], b[MAX_SIZE], c[MAX_SIZE];
+	size_t size;
+	int n;
+
+	for (size = 1; size <= MAX_SIZE; size++) {
+		for (n = 0; n < 50; n++) {
+			bool changed;
+			int i;
+
+			fill(a, size, n % 2);
+			fill(b, size, n % 3 == 0);
+
+			flag_copy(c, a, size);
+			changed = flag_union(c, b, size);
+			eq(changed, !flag_is_subset(a, b, size));
+			for (i = FLAG_START; i < FLAG_MAX(size); i++)
+				eq(bit(c, i), bit(a, i) || bit(b, i));
+
+			flag_copy(c, a, size);
+			changed = flag_inter(c, b, size);
+			eq(changed, !flag_is_equal(a, b, size));
+			for (i = FLAG_START; i < FLAG_MAX(size); i++)
+				eq(bit(c, i), bit(a, i) && bit(b, i));
+
+			flag_copy(c, a, size);
+			changed = flag_diff(c, b, size);
+			eq(changed, flag_is_inter(a, b, size));
+			for (i = FLAG_START; i < FLAG_MAX(size); i++)
+				eq(bit(c, i), bit(a, i) && !bit(b, i));
+
+			flag_copy(c, a, size);
+			flag_negate(b, size);
+			changed = flag_comp_union(c, b, size);
+			flag_negate(b, size);
+			eq(changed, !flag_is_subset(a, b, size));
+			for (i = FLAG_START; i < FLAG_MAX(size); i++)
+				eq(bit(c, i), bit(a, i) || bit(b, i));
+
+			flag_copy(c, a, size);
+			flag_negate(c, size);
+			for (i = FLAG_START; i < FLAG_MAX(size); i++)
+				eq(bit(c, i), !bit(a, i));
+		}
+	}
+
+	ok;
+}
+
+int test_next(void *state) {
+	bitflag a[MAX_SIZE];
+	size_t size;
+	int n;
+
+	for (size = 1; size <= MAX_SIZE; size++) {
+		for (n = 0; n < 50; n++) {
+			int i, f = FLAG_START;
+
+			fill(a, size, n % 2);
+
+			/* Walk the set, checking nothing is skipped */
+			for (i = FLAG_START; i < FLAG_MAX(size); i++) {
+				if (!bit(a, i)) continue;
+				eq(flag_next(a, size, f), i);
+				f = i + 1;
+			}
+			eq(flag_next(a, size, f), FLAG_END);
+
+			/* Starting part way through a byte */
+			for (i = FLAG_START; i < FLAG_MAX(size); i++) {
+				int j = flag_next(a, size, i);
+				if (j == FLAG_END) j = FLAG_MAX(size);
+				for (f = i; f < j; f++) require(!bit(a, f));
+				if (j < FLAG_MAX(size)) require(bit(a, j));
+			}
+		}
+	}
+
+	ok;
+}
+
+/* A stand-in flag enum with the usual dummy first entry */
+enum {
+	TF_NONE,
+	TF_A, TF_B, TF_C, TF_D, TF_E, TF_F, TF_G, TF_H, TF_I, TF_J,
+	TF_MAX = 100
+};
+#define TF_SIZE FLAG_SIZE(TF_MAX)
+FLAG_MASK_FITS(tf, TF_SIZE);
+
+int test_mask(void *state) {
+	static const bitflag none[FLAG_MASK_MAX] = FLAG_MASK(FLAG_END);
+	static const bitflag one[FLAG_MASK_MAX] = FLAG_MASK(TF_C);
+	static const bitflag some[FLAG_MASK_MAX] = FLAG_MASK(TF_A, TF_J, TF_MAX - 1);
+	static const bitflag eight[FLAG_MASK_MAX] =
+		FLAG_MASK(TF_A, TF_B, TF_C, TF_D, TF_E, TF_F, TF_G, TF_H);
+	bitflag f[TF_SIZE];
+
+	require(flag_is_empty(none, TF_SIZE));
+
+	flags_init(f, TF_SIZE, TF_C, FLAG_END);
+	require(flag_is_equal(f, one, TF_SIZE));
+
+	flags_init(f, TF_SIZE, TF_A, TF_J, TF_MAX - 1, FLAG_END);
+	require(flag_is_equal(f, some, TF_SIZE));
+
+	flags_init(f, TF_SIZE, TF_A, TF_B, TF_C, TF_D, TF_E, TF_F, TF_G, TF_H,
+			FLAG_END);
+	require(flag_is_equal(f, eight, TF_SIZE));
+
+	/* The masks do the same job as flags_test() and flags_test_all() */
+	flags_init(f, TF_SIZE, TF_B, TF_J, FLAG_END);
+	eq(flag_is_inter(f, some, TF_SIZE),
+			flags_test(f, TF_SIZE, TF_A, TF_J, TF_MAX - 1, FLAG_END));
+	eq(flag_is_subset(f, some, TF_SIZE),
+			flags_test_all(f, TF_SIZE, TF_A, TF_J, TF_MAX - 1, FLAG_END));
+	flag_on(f, TF_SIZE, TF_A);
+	flag_on(f, TF_SIZE, TF_MAX - 1);
+	require(flag_is_subset(f, some, TF_SIZE));
+
+	ok;
+}
+
+int test_flags_mask(void *state) {
+	bitflag f[TF_SIZE];
+
+	flags_init(f, TF_SIZE, TF_A, TF_B, TF_MAX - 1, FLAG_END);
+	require(flags_mask(f, TF_SIZE, TF_B, TF_C, FLAG_END));
+	require(flag_has(f, TF_SIZE, TF_B));
+	require(!flag_has(f, TF_SIZE, TF_A));
+	require(!flag_has(f, TF_SIZE, TF_MAX - 1));
+	require(!flags_mask(f, TF_SIZE, TF_B, FLAG_END));
+
+	ok;
+}
+
+const char *suite_name = "z-bitflag/bitflag";
+struct test tests[] = {
+	{ "predicates", test_predicates },
+	{ "operations", test_operations },
+	{ "next", test_next },
+	{ "mask", test_mask },
+	{ "flags-mask", test_flags_mask },
+	{ NULL, NULL }
+};
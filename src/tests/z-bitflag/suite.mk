@@ -0,0 +1 @@
+TESTPROGS += z-bitflag/bitflag z-bitflag/bench
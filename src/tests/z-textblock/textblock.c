@@ -3,6 +3,7 @@
 #include "unit-test.h"
 #include "z-textblock.h"
 #include "z-term.h"
+#include "z-virt.h"
 
 int setup_tests(void **state) {
 	ok;
@@ -75,11 +76,69 @@ int test_length(void *state) {
 	ok;
 }
 
+int test_lines(void *state) {
+	textblock *tb = textblock_new();
+	const size_t *starts, *lengths, *starts2, *lengths2;
+	size_t n;
+
+	textblock_append(tb, "one two three\n");
+
+	n = textblock_lines(tb, &starts, &lengths, 10);
+	eq(n, 2);
+	eq(starts[0], 0);
+	eq(lengths[0], 7);
+	eq(starts[1], 8);
+	eq(lengths[1], 5);
+
+	/* Asking again at the same width gives back the same lines */
+	eq(textblock_lines(tb, &starts2, &lengths2, 10), 2);
+	require(starts2 == starts);
+	require(lengths2 == lengths);
+
+	/* Appending means working them out again */
+	textblock_append(tb, "four five\n");
+	eq(textblock_lines(tb, &starts, &lengths, 10), 3);
+	eq(starts[2], 14);
+	eq(lengths[2], 9);
+
+	/* As does a different width */
+	eq(textblock_lines(tb, &starts, &lengths, 80), 2);
+	eq(lengths[0], 13);
+
+	textblock_free(tb);
+	ok;
+}
+
+int test_arena(void *state) {
+	struct mem_arena *a = mem_arena_new(256);
+	textblock *tb = textblock_new_in(a);
+	const size_t *starts, *lengths;
+	int i;
+
+	/* Enough to make it grow out of its first allocation a few times */
+	for (i = 0; i < 100; i++)
+		textblock_append_c(tb, TERM_L_GREEN, "%d%s", i % 10,
+				i % 10 == 9 ? "\n" : " ");
+
+	eq(wcslen(textblock_text(tb)), 200);
+	require(!wmemcmp(textblock_text(tb), L"0 1 2 ", 6));
+	require(!wmemcmp(textblock_text(tb) + 194, L"7 8 9\n", 6));
+	eq(textblock_attrs(tb)[199], TERM_L_GREEN);
+
+	eq(textblock_lines(tb, &starts, &lengths, 20), 10);
+
+	textblock_free(tb);
+	mem_arena_free(a);
+	ok;
+}
+
 const char *suite_name = "z-textblock/textblock";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "append", test_append },
 	{ "colour", test_colour },
 	{ "length", test_length },
+	{ "lines", test_lines },
+	{ "arena", test_arena },
 	{ NULL, NULL }
 };
@@ -0,0 +1,77 @@
+/* z-virt/arena */
+
+#include "unit-test.h"
+#include "z-virt.h"
+
+int setup_tests(void **state) {
+	*state = mem_arena_new(64);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	mem_arena_free(state);
+	return 0;
+}
+
+int test_alloc(void *state) {
+	struct mem_arena *a = state;
+	char *p1 = mem_arena_alloc(a, 10);
+	char *p2 = mem_arena_alloc(a, 10);
+	char *big = mem_arena_alloc(a, 1000);
+	int i;
+
+	require(p1 && p2 && big);
+	require(p1 != p2);
+	require(((size_t)p2 % sizeof(size_t)) == 0);
+	require(!mem_arena_alloc(a, 0));
+
+	/* Everything comes back zeroed */
+	for (i = 0; i < 1000; i++)
+		require(!big[i]);
+
+	memset(p1, 0x1, 10);
+	memset(p2, 0x2, 10);
+	memset(big, 0x3, 1000);
+	require(p1[9] == 0x1);
+	require(p2[0] == 0x2);
+
+	mem_arena_reset(a);
+	ok;
+}
+
+int test_mark(void *state) {
+	struct mem_arena *a = state;
+	char *keep = mem_arena_alloc(a, 16);
+	struct mem_arena_mark mark = mem_arena_mark(a);
+	char *p1, *p2;
+	int i;
+
+	memset(keep, 0x5, 16);
+
+	/* Go well past the first block, then take it all back */
+	p1 = mem_arena_alloc(a, 40);
+	for (i = 0; i < 20; i++)
+		memset(mem_arena_alloc(a, 50), 0x6, 50);
+	mem_arena_release(a, mark);
+
+	/* The same memory is handed out again, zeroed */
+	p2 = mem_arena_alloc(a, 40);
+	require(p2 == p1);
+	for (i = 0; i < 40; i++)
+		require(!p2[i]);
+	for (i = 0; i < 16; i++)
+		require(keep[i] == 0x5);
+
+	/* After a reset, the first block is reused */
+	mem_arena_reset(a);
+	require(mem_arena_alloc(a, 16) == keep);
+	mem_arena_reset(a);
+	ok;
+}
+
+const char *suite_name = "z-virt/arena";
+struct test tests[] = {
+	{ "alloc", test_alloc },
+	{ "mark", test_mark },
+	{ NULL, NULL }
+};
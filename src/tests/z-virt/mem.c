@@ -1,6 +1,7 @@
 /* z-virt/mem */
 
 #include "unit-test.h"
+#include "z-util.h"
 #include "z-virt.h"
 
 NOSETUP
@@ -25,9 +26,56 @@ int test_realloc(void *state) {
 	return 0;
 }
 
+int test_profile(void *state) {
+	char path[] = "/tmp/memprof.XXXXXX";
+	int fd = mkstemp(path);
+	char *p1 = mem_alloc_at(24, "profile.c", 1);
+	char *p2 = mem_realloc_at(mem_alloc_at(8, "profile.c", 2), 100,
+			"profile.c", 3);
+	bool written;
+
+	require(fd >= 0);
+	close(fd);
+
+	memset(p1, 0x4, 24);
+	memset(p2, 0x5, 100);
+	mem_free(p1);
+
+	written = mem_profile_dump(path);
+
+#ifdef MEM_PROFILE
+	{
+		char line[256];
+		bool seen1 = FALSE, seen3 = FALSE;
+		FILE *fp = fopen(path, "r");
+
+		require(written);
+		require(fp);
+		while (fgets(line, sizeof(line), fp)) {
+			/* One block of 24 bytes, since freed */
+			if (prefix(line, "profile.c,1,1,1,0,24,24,0,0,1,"))
+				seen1 = TRUE;
+			/* One block resized to 100 bytes, still live */
+			if (prefix(line, "profile.c,3,1,0,100,100,100,0,0,0,0,1,"))
+				seen3 = TRUE;
+		}
+		fclose(fp);
+		require(seen1);
+		require(seen3);
+	}
+#else
+	require(!written);
+#endif
+
+	mem_free(p2);
+	remove(path);
+	return 0;
+}
+
 const char *suite_name = "z-virt/mem";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "realloc", test_realloc },
+	{ "profile", test_profile },
 	{ NULL, NULL }
 };
@@ -0,0 +1,76 @@
+/* z-virt/profile
+ *
+ * The allocator in a MEM_PROFILE build.  This is built from its own copy
+ * of z-virt.c, compiled with MEM_PROFILE, rather than against the game.
+ */
+
+#include "unit-test.h"
+#include "z-util.h"
+#include "z-virt.h"
+
+NOSETUP
+NOTEARDOWN
+
+/* Look for a line starting with `start` in the dump at `path` */
+static bool dump_has(const char *path, const char *start)
+{
+	char line[256];
+	bool seen = FALSE;
+	FILE *fp = fopen(path, "r");
+
+	if (!fp) return FALSE;
+	while (fgets(line, sizeof(line), fp))
+		if (prefix(line, start))
+			seen = TRUE;
+	fclose(fp);
+
+	return seen;
+}
+
+int test_dump(void *state) {
+	char path[] = "/tmp/memprof.XXXXXX";
+	int fd = mkstemp(path);
+	char *p1 = mem_alloc_at(24, "dump.c", 1);
+	char *p2 = mem_realloc_at(mem_alloc_at(8, "dump.c", 2), 100,
+			"dump.c", 3);
+
+	require(fd >= 0);
+	close(fd);
+
+	mem_free(p1);
+	require(mem_profile_dump(path));
+
+	/* One block of 24 bytes, since freed */
+	require(dump_has(path, "dump.c,1,1,1,0,24,24,0,0,1,"));
+	/* One block resized to 100 bytes, still live */
+	require(dump_has(path, "dump.c,3,1,0,100,100,100,0,0,0,0,1,"));
+
+	mem_free(p2);
+	remove(path);
+	ok;
+}
+
+/* The same file name at two addresses is still one site */
+int test_same_name(void *state) {
+	char path[] = "/tmp/memprof.XXXXXX";
+	int fd = mkstemp(path);
+	char name1[] = "name.c", name2[] = "name.c";
+
+	require(fd >= 0);
+	close(fd);
+
+	mem_free(mem_alloc_at(16, name1, 7));
+	mem_free(mem_alloc_at(16, name2, 7));
+	require(mem_profile_dump(path));
+	require(dump_has(path, "name.c,7,2,2,0,16,32,"));
+
+	remove(path);
+	ok;
+}
+
+const char *suite_name = "z-virt/profile";
+struct test tests[] = {
+	{ "dump", test_dump },
+	{ "same-name", test_same_name },
+	{ NULL, NULL }
+};
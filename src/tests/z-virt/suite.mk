@@ -1 +1,10 @@
-TESTPROGS += z-virt/mem z-virt/string
+TESTPROGS += z-virt/mem z-virt/string z-virt/arena z-virt/profile
+
+# z-virt/profile is linked against its own MEM_PROFILE build of the allocator
+z-virt/profile.o : z-virt/profile.c
+	@$(CC) $(CFLAGS) -DMEM_PROFILE -c -o $@ $^
+
+bin/z-virt/profile : z-virt/profile.o ../z-virt.c ../z-util.c unit-test.o
+	@mkdir -p bin/z-virt
+	@$(CC) $(CFLAGS) -DMEM_PROFILE -o $@ $^ $(LDFLAGS)
+	@echo "  CC $@"
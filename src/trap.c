@@ -240,6 +240,9 @@ void wipe_trap_list(struct cave *c) {
 	for (t_idx = cave->trap_max - 1; t_idx >= 1; t_idx--) {
 		trap_type *t_ptr = cave_trap(cave, t_idx);
 
+		/* Trap is gone */
+		if (t_ptr->kind) c->trap[t_ptr->y][t_ptr->x] = 0;
+
 		(void)WIPE(t_ptr, trap_type);
 	}
 
@@ -116,6 +116,8 @@ typedef struct vault {
 
 	byte hgt;			/* Vault height */
 	byte wid;			/* Vault width */
+
+	struct tile_program *prog;	/* The text, worked out for building */
 } vault_type;
 
 
@@ -136,6 +138,8 @@ typedef struct room_template {
 	byte wid;			/* Room width */
 	byte dor;           /* Random door options */
 	byte tval;			/* tval for objects in this room */
+
+	struct tile_program *prog;	/* The text, worked out for building */
 } room_template_type;
 
 
@@ -697,6 +697,9 @@ static void display_knowledge(const char *title, int *obj_list, int o_count,
 	FREE(g_offset);
 	FREE(g_list);
 
+	/* Visuals may have been changed */
+	map_cache_reset();
+
 	screen_load();
 }
 
@@ -1270,7 +1273,7 @@ static void mon_lore(int oid)
 	l_ptr = &l_list[r_idx];
 	roff_top(r_ptr);
 	Term_gotoxy(0, 2);
-	describe_monster(r_ptr, l_ptr, FALSE);
+	describe_monster_to_screen(r_ptr, l_ptr);
 
 	text_out_c(TERM_L_BLUE, "\n[Press any key to continue]\n");
 	(void)anykey();
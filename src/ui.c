@@ -75,7 +75,7 @@ bool region_inside(const region *loc, const ui_event *key)
 /*** Text display ***/
 
 static void display_area(const wchar_t *text, const byte *attrs,
-		size_t *line_starts, size_t *line_lengths,
+		const size_t *line_starts, const size_t *line_lengths,
 		size_t n_lines,
 		region area, size_t line_from)
 {
@@ -98,11 +98,10 @@ void textui_textblock_place(textblock *tb, region orig_area, const char *header)
 	/* xxx on resize this should be recalculated */
 	region area = region_calculate(orig_area);
 
-	size_t *line_starts = NULL, *line_lengths = NULL;
+	const size_t *line_starts = NULL, *line_lengths = NULL;
 	size_t n_lines;
 
-	n_lines = textblock_calculate_lines(tb,
-			&line_starts, &line_lengths, area.width);
+	n_lines = textblock_lines(tb, &line_starts, &line_lengths, area.width);
 
 	area.page_rows--;
 
@@ -114,9 +113,6 @@ void textui_textblock_place(textblock *tb, region orig_area, const char *header)
 
 	display_area(textblock_text(tb), textblock_attrs(tb), line_starts,
 	             line_lengths, n_lines, area, 0);
-
-	mem_free(line_starts);
-	mem_free(line_lengths);
 }
 
 void textui_textblock_show(textblock *tb, region orig_area, const char *header)
@@ -124,11 +120,10 @@ void textui_textblock_show(textblock *tb, region orig_area, const char *header)
 	/* xxx on resize this should be recalculated */
 	region area = region_calculate(orig_area);
 
-	size_t *line_starts = NULL, *line_lengths = NULL;
+	const size_t *line_starts = NULL, *line_lengths = NULL;
 	size_t n_lines;
 
-	n_lines = textblock_calculate_lines(tb,
-			&line_starts, &line_lengths, area.width);
+	n_lines = textblock_lines(tb, &line_starts, &line_lengths, area.width);
 
 	screen_save();
 
@@ -177,9 +172,6 @@ void textui_textblock_show(textblock *tb, region orig_area, const char *header)
 		inkey();
 	}
 
-	mem_free(line_starts);
-	mem_free(line_lengths);
-
 	screen_load();
 
 	return;
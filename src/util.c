@@ -319,6 +319,9 @@ ui_event inkey_ex(void)
 
 	term *old = Term;
 
+	/* Bring the screen up to date before asking for anything */
+	event_flush();
+
 	/* Delayed flush */
 	if (inkey_xtra) {
 		Term_flush();
@@ -752,7 +755,7 @@ static void msg_print_aux(u16b type, const char *msg)
 	message_column += n + 1;
 
 	/* Send refresh event */
-	event_signal(EVENT_MESSAGE);
+	event_signal_message(EVENT_MESSAGE, type, msg);
 }
 
 /*
@@ -823,6 +826,9 @@ void screen_save(void)
 	/* Hack -- Flush messages */
 	message_flush();
 
+	/* Draw anything still pending onto the screen being saved */
+	event_flush();
+
 	/* Save the screen (if legal) */
 	Term_save();
 
@@ -902,20 +908,10 @@ void prt(const char *str, int row, int col)
 
 
 /*
- * Print some (colored) text to the screen at the current cursor position,
- * automatically "wrapping" existing text (at spaces) when necessary to
- * avoid placing any text into the last column, and clearing every line
- * before placing any text in that line.  Also, allow "newline" to force
- * a "wrap" to the next line.  Advance the cursor as needed so sequential
- * calls to this function will work correctly.
- *
- * Once this function has been called, the cursor should not be moved
- * until all the related "text_out()" calls to the window are complete.
- *
- * This function will correctly handle any width up to the maximum legal
- * value of 256, though it works best for a standard 80 character width.
+ * Write the first `len` wide characters of `str` to the screen; see
+ * text_out_to_screen().
  */
-void text_out_to_screen(byte a, const char *str)
+static void text_out_wide_to_screen(byte a, const wchar_t *str, size_t len)
 {
 	int x, y;
 
@@ -924,7 +920,6 @@ void text_out_to_screen(byte a, const char *str)
 	int wrap;
 
 	const wchar_t *s;
-	wchar_t buf[1024];
 
 	/* Obtain the size */
 	(void)Term_get_size(&wid, &h);
@@ -932,9 +927,6 @@ void text_out_to_screen(byte a, const char *str)
 	/* Obtain the cursor */
 	(void)Term_locate(&x, &y);
 
-	/* Copy to a rewriteable string */
-	Term_mbstowcs(buf, str, 1024);
-	
 	/* Use special wrapping boundary? */
 	if ((text_out_wrap > 0) && (text_out_wrap < wid))
 		wrap = text_out_wrap;
@@ -942,7 +934,7 @@ void text_out_to_screen(byte a, const char *str)
 		wrap = wid;
 
 	/* Process the string */
-	for (s = buf; *s; s++)
+	for (s = str; s < str + len; s++)
 	{
 		wchar_t ch;
 
@@ -1026,6 +1018,52 @@ void text_out_to_screen(byte a, const char *str)
 }
 
 
+/*
+ * Print some (colored) text to the screen at the current cursor position,
+ * automatically "wrapping" existing text (at spaces) when necessary to
+ * avoid placing any text into the last column, and clearing every line
+ * before placing any text in that line.  Also, allow "newline" to force
+ * a "wrap" to the next line.  Advance the cursor as needed so sequential
+ * calls to this function will work correctly.
+ *
+ * Once this function has been called, the cursor should not be moved
+ * until all the related "text_out()" calls to the window are complete.
+ *
+ * This function will correctly handle any width up to the maximum legal
+ * value of 256, though it works best for a standard 80 character width.
+ */
+void text_out_to_screen(byte a, const char *str)
+{
+	wchar_t buf[1024];
+
+	/* Copy to a rewriteable string */
+	Term_mbstowcs(buf, str, 1024);
+
+	text_out_wide_to_screen(a, buf, wcslen(buf));
+}
+
+
+/*
+ * Write a whole textblock to the screen at the cursor, with the same
+ * wrapping as if it had been given to text_out_to_screen() bit by bit.
+ */
+void textblock_to_screen(textblock *tb)
+{
+	const wchar_t *text = textblock_text(tb);
+	const byte *attrs = textblock_attrs(tb);
+	size_t len = wcslen(text);
+	size_t start = 0, i;
+
+	/* Write out each run of the same colour in one go */
+	for (i = 1; i <= len; i++) {
+		if (i < len && attrs[i] == attrs[start]) continue;
+
+		text_out_wide_to_screen(attrs[start], text + start, i - start);
+		start = i;
+	}
+}
+
+
 /*
  * Write text to the given file and apply line-wrapping.
  *
@@ -60,6 +60,7 @@ s16b character_icky;		/* Depth of the game in special mode */
 s16b character_xtra;		/* Depth of the game in startup mode */
 
 u32b seed_randart;		/* Hack -- consistent random artifacts */
+u32b randart_version = RANDART_VERSION;	/* How to use seed_randart */
 
 u32b seed_flavor;		/* Hack -- consistent object colors */
 u32b seed_town;			/* Hack -- consistent town layout */
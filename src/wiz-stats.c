@@ -18,6 +18,7 @@
 #include "angband.h"
 #include "cave.h"
 #include "cmds.h"
+#include "dist-field.h"
 #include "wizard.h"
 #include "monster/mon-make.h"
 #include "monster/monster.h"
@@ -49,6 +50,10 @@
 
 #ifdef USE_STATS
 
+#include <errno.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 /*** Statsgen ***/
 
 /* Logfile to store results in */
@@ -317,153 +322,171 @@ static double mon_total[MAX_LVL], mon_ood[MAX_LVL], mon_deadly[MAX_LVL];
 /* unique info */
 static double uniq_total[MAX_LVL], uniq_ood[MAX_LVL], uniq_deadly[MAX_LVL];
 
-static void init_iter_vals(int k)
-{
-	art_it[k]=0;
-	fa_it[k]=0, si_it[k]=0, po_it[k]=0, nx_it[k]=0;
-	cf_it[k]=0, bl_it[k]=0, te_it[k]=0;
-	
-	mb1_it[k]=0, mb2_it[k]=0, mb3_it[k]=0;
-	mb4_it[k]=0, mb5_it[k]=0, mb6_it[k]=0;
-	mb7_it[k]=0, mb8_it[k]=0, mb9_it[k]=0;
-}
-/* set everything to 0.0 to begin */
-static void init_stat_vals(int lvl)
-{
-   
-	gold_total[lvl] = 0.0; gold_floor[lvl] = 0.0; gold_mon[lvl] = 0.0;	gold_wall[lvl] = 0.0;
-	
-	faeq_total[lvl] = 0.0; faeq_mon[lvl] = 0.0; faeq_vault[lvl] = 0.0;
-	reeq_total[lvl] = 0.0; reeq_mon[lvl] = 0.0; reeq_vault[lvl] = 0.0;
-	rbeq_total[lvl] = 0.0; rbeq_mon[lvl] = 0.0; rbeq_vault[lvl] = 0.0;
-	poeq_total[lvl] = 0.0; poeq_mon[lvl] = 0.0; poeq_vault[lvl] = 0.0;
-	nxeq_total[lvl] = 0.0; nxeq_mon[lvl] = 0.0; nxeq_vault[lvl] = 0.0;
-	speq_total[lvl] = 0.0; speq_mon[lvl] = 0.0; speq_vault[lvl] = 0.0;
-	teeq_total[lvl] = 0.0; teeq_mon[lvl] = 0.0; teeq_vault[lvl] = 0.0;
-	bleq_total[lvl] = 0.0; bleq_mon[lvl] = 0.0; bleq_vault[lvl] = 0.0;
-	cfeq_total[lvl] = 0.0; cfeq_mon[lvl] = 0.0; cfeq_vault[lvl] = 0.0;
-	
-	weap_total[lvl] = 0.0; weap_mon[lvl] = 0.0; weap_vault[lvl] = 0.0;
-	bdweap_total[lvl] = 0.0; bdweap_mon[lvl] = 0.0; bdweap_vault[lvl] = 0.0;
-	avweap_total[lvl] = 0.0; avweap_mon[lvl] = 0.0; avweap_vault[lvl] = 0.0;
-	gdweap_total[lvl] = 0.0; gdweap_mon[lvl] = 0.0; gdweap_vault[lvl] = 0.0;
-	slweap_total[lvl] = 0.0; slweap_mon[lvl] = 0.0; slweap_vault[lvl] = 0.0;
-	evweap_total[lvl] = 0.0; evweap_mon[lvl] = 0.0; evweap_vault[lvl] = 0.0;
-	klweap_total[lvl] = 0.0; klweap_mon[lvl] = 0.0; klweap_vault[lvl] = 0.0;
-	brweap_total[lvl] = 0.0; brweap_mon[lvl] = 0.0; brweap_vault[lvl] = 0.0;
-	weweap_total[lvl] = 0.0; weweap_mon[lvl] = 0.0; weweap_vault[lvl] = 0.0;
-	deweap_total[lvl] = 0.0; deweap_mon[lvl] = 0.0; deweap_vault[lvl] = 0.0;
-	goweap_total[lvl] = 0.0; goweap_mon[lvl] = 0.0; goweap_vault[lvl] = 0.0;
-	haweap_total[lvl] = 0.0; haweap_mon[lvl] = 0.0; haweap_vault[lvl] = 0.0;
-	xbweap_total[lvl] = 0.0; xbweap_mon[lvl] = 0.0; xbweap_vault[lvl] = 0.0;
-	teweap_total[lvl] = 0.0; teweap_mon[lvl] = 0.0; teweap_vault[lvl] = 0.0;
-	huweap_total[lvl] = 0.0; huweap_mon[lvl] = 0.0; huweap_vault[lvl] = 0.0;
-	ubweap_total[lvl] = 0.0; ubweap_mon[lvl] = 0.0; ubweap_vault[lvl] = 0.0;
-	moweap_total[lvl] = 0.0; moweap_mon[lvl] = 0.0; moweap_vault[lvl] = 0.0;
-	
+/*
+ * Every per-level accumulator, so that they can all be cleared or merged
+ * in one go.
+ */
+static double *stat_vals[] = {
+	gold_total, gold_floor, gold_mon, gold_wall,
+
+	faeq_total, faeq_mon, faeq_vault,
+	sieq_total, sieq_mon, sieq_vault,
+	reeq_total, reeq_mon, reeq_vault,
+	rbeq_total, rbeq_mon, rbeq_vault,
+	poeq_total, poeq_mon, poeq_vault,
+	nxeq_total, nxeq_mon, nxeq_vault,
+	speq_total, speq_mon, speq_vault,
+	teeq_total, teeq_mon, teeq_vault,
+	bleq_total, bleq_mon, bleq_vault,
+	cfeq_total, cfeq_mon, cfeq_vault,
+
+	weap_total, weap_mon, weap_vault,
+	bdweap_total, bdweap_mon, bdweap_vault,
+	avweap_total, avweap_mon, avweap_vault,
+	gdweap_total, gdweap_mon, gdweap_vault,
+	slweap_total, slweap_mon, slweap_vault,
+	evweap_total, evweap_mon, evweap_vault,
+	klweap_total, klweap_mon, klweap_vault,
+	brweap_total, brweap_mon, brweap_vault,
+	weweap_total, weweap_mon, weweap_vault,
+	deweap_total, deweap_mon, deweap_vault,
+	goweap_total, goweap_mon, goweap_vault,
+	haweap_total, haweap_mon, haweap_vault,
+	xbweap_total, xbweap_mon, xbweap_vault,
+	teweap_total, teweap_mon, teweap_vault,
+	huweap_total, huweap_mon, huweap_vault,
+	ubweap_total, ubweap_mon, ubweap_vault,
+	moweap_total, moweap_mon, moweap_vault,
+
 	/*bows*/
-	bow_total[lvl] = 0.0; bow_mon[lvl] = 0.0; bow_vault[lvl] = 0.0;
-	bdbow_total[lvl] = 0.0; bdbow_mon[lvl] = 0.0; bdbow_vault[lvl] = 0.0;
-	avbow_total[lvl] = 0.0; avbow_mon[lvl] = 0.0; avbow_vault[lvl] = 0.0;
-	gdbow_total[lvl] = 0.0; gdbow_mon[lvl] = 0.0; gdbow_vault[lvl] = 0.0;
-	vgbow_total[lvl] = 0.0; vgbow_mon[lvl] = 0.0; vgbow_vault[lvl] = 0.0;
-	xmbow_total[lvl] = 0.0; xmbow_mon[lvl] = 0.0; xmbow_vault[lvl] = 0.0;
-	xsbow_total[lvl] = 0.0; xsbow_mon[lvl] = 0.0; xsbow_vault[lvl] = 0.0;
-	bubow_total[lvl] = 0.0; bubow_mon[lvl] = 0.0; bubow_vault[lvl] = 0.0;
-	tebow_total[lvl] = 0.0; tebow_mon[lvl] = 0.0; tebow_vault[lvl] = 0.0;
-	cubow_total[lvl] = 0.0; cubow_mon[lvl] = 0.0; cubow_vault[lvl] = 0.0;
-	
+	bow_total, bow_mon, bow_vault,
+	bdbow_total, bdbow_mon, bdbow_vault,
+	avbow_total, avbow_mon, avbow_vault,
+	gdbow_total, gdbow_mon, gdbow_vault,
+	vgbow_total, vgbow_mon, vgbow_vault,
+	xmbow_total, xmbow_mon, xmbow_vault,
+	xsbow_total, xsbow_mon, xsbow_vault,
+	bubow_total, bubow_mon, bubow_vault,
+	tebow_total, tebow_mon, tebow_vault,
+	cubow_total, cubow_mon, cubow_vault,
+
 	/* ammo */
-	ammo_total[lvl] = 0.0; ammo_mon[lvl] = 0.0; ammo_vault[lvl] = 0.0;
-	bdammo_total[lvl] = 0.0; bdammo_mon[lvl] = 0.0; bdammo_vault[lvl] = 0.0;
-	avammo_total[lvl] = 0.0; avammo_mon[lvl] = 0.0; avammo_vault[lvl] = 0.0;
-	gdammo_total[lvl] = 0.0; gdammo_mon[lvl] = 0.0; gdammo_vault[lvl] = 0.0;
-	egammo_total[lvl] = 0.0; egammo_mon[lvl] = 0.0; egammo_vault[lvl] = 0.0;
-	vgammo_total[lvl] = 0.0; vgammo_mon[lvl] = 0.0; vgammo_vault[lvl] = 0.0;
-	awammo_total[lvl] = 0.0; awammo_mon[lvl] = 0.0; awammo_vault[lvl] = 0.0;
-	evammo_total[lvl] = 0.0; evammo_mon[lvl] = 0.0; evammo_vault[lvl] = 0.0;
-	hmammo_total[lvl] = 0.0; hmammo_mon[lvl] = 0.0; hmammo_vault[lvl] = 0.0;
-	
+	ammo_total, ammo_mon, ammo_vault,
+	bdammo_total, bdammo_mon, bdammo_vault,
+	avammo_total, avammo_mon, avammo_vault,
+	gdammo_total, gdammo_mon, gdammo_vault,
+	egammo_total, egammo_mon, egammo_vault,
+	vgammo_total, vgammo_mon, vgammo_vault,
+	awammo_total, awammo_mon, awammo_vault,
+	evammo_total, evammo_mon, evammo_vault,
+	hmammo_total, hmammo_mon, hmammo_vault,
+
 	/* armor */
-	arm_total[lvl] = 0.0; arm_mon[lvl] = 0.0; arm_vault[lvl] = 0.0;
-	bdarm_total[lvl] = 0.0; bdarm_mon[lvl] = 0.0; bdarm_vault[lvl] = 0.0;
-	avarm_total[lvl] = 0.0; avarm_mon[lvl] = 0.0; avarm_vault[lvl] = 0.0;
-	gdarm_total[lvl] = 0.0; gdarm_mon[lvl] = 0.0; gdarm_vault[lvl] = 0.0;
-	strarm_total[lvl] = 0.0; strarm_mon[lvl] = 0.0; strarm_vault[lvl] = 0.0;
-	intarm_total[lvl] = 0.0; intarm_mon[lvl] = 0.0; intarm_vault[lvl] = 0.0;
-	wisarm_total[lvl] = 0.0; wisarm_mon[lvl] = 0.0; wisarm_vault[lvl] = 0.0;
-	dexarm_total[lvl] = 0.0; dexarm_mon[lvl] = 0.0; dexarm_vault[lvl] = 0.0;
-	conarm_total[lvl] = 0.0; conarm_mon[lvl] = 0.0; conarm_vault[lvl] = 0.0;
-	cuarm_total[lvl] = 0.0; cuarm_mon[lvl] = 0.0; cuarm_vault[lvl] = 0.0;
-
-	art_total[lvl] = 0.0; art_spec[lvl] = 0.0; art_norm[lvl] = 0.0;
-	art_shal[lvl] = 0.0; art_ave [lvl] = 0.0;	art_ood [lvl] = 0.0;
-	art_mon[lvl] = 0.0; art_uniq[lvl] = 0.0; art_floor[lvl] = 0.0;
-	art_vault[lvl] = 0.0; art_mon_vault[lvl] = 0.0;
-	
+	arm_total, arm_mon, arm_vault,
+	bdarm_total, bdarm_mon, bdarm_vault,
+	avarm_total, avarm_mon, avarm_vault,
+	gdarm_total, gdarm_mon, gdarm_vault,
+	strarm_total, strarm_mon, strarm_vault,
+	intarm_total, intarm_mon, intarm_vault,
+	wisarm_total, wisarm_mon, wisarm_vault,
+	dexarm_total, dexarm_mon, dexarm_vault,
+	conarm_total, conarm_mon, conarm_vault,
+	cuarm_total, cuarm_mon, cuarm_vault,
+
+	art_total, art_spec, art_norm,
+	art_shal, art_ave, art_ood,
+	art_mon, art_uniq, art_floor,
+	art_vault, art_mon_vault,
+
 	/* potion */
-	pot_total[lvl] =0.0; pot_mon[lvl] =0.0;	pot_vault[lvl] =0.0;	
-	gain_total[lvl] =0.0; gain_mon[lvl] =0.0; gain_vault[lvl] =0.0;	
-	rmana_total[lvl] =0.0; rmana_mon[lvl] =0.0;	rmana_vault[lvl] =0.0;	
-	bigheal_total[lvl] =0.0; bigheal_mon[lvl] =0.0; bigheal_vault[lvl] =0.0;
-	
+	pot_total, pot_mon, pot_vault,
+	gain_total, gain_mon, gain_vault,
+	rmana_total, rmana_mon, rmana_vault,
+	bigheal_total, bigheal_mon, bigheal_vault,
+
 	/*scrolls*/
-	scroll_total[lvl] = 0.0;	scroll_mon[lvl] = 0.0; scroll_vault[lvl] = 0.0;	
-	escroll_total[lvl] = 0.0; escroll_mon[lvl] = 0.0; escroll_vault[lvl] = 0.0;
-	acq_total[lvl] = 0.0; acq_mon[lvl] = 0.0; acq_vault[lvl] = 0.0;
-	
+	scroll_total, scroll_mon, scroll_vault,
+	escroll_total, escroll_mon, escroll_vault,
+	acq_total, acq_mon, acq_vault,
+
 	/* rods */
-	rod_total[lvl] = 0.0; rod_mon[lvl] = 0.0; rod_vault[lvl] = 0.0;
-	urod_total[lvl] = 0.0; urod_mon[lvl] = 0.0; urod_vault[lvl] = 0.0;	
-	torod_total[lvl] = 0.0; torod_mon[lvl] = 0.0; torod_vault[lvl] = 0.0;	
-	drod_total[lvl] = 0.0; drod_mon[lvl] = 0.0; drod_vault[lvl] = 0.0;	
-	erod_total[lvl] = 0.0; erod_mon[lvl] = 0.0; erod_vault[lvl] = 0.0;
-	
+	rod_total, rod_mon, rod_vault,
+	urod_total, urod_mon, urod_vault,
+	torod_total, torod_mon, torod_vault,
+	drod_total, drod_mon, drod_vault,
+	erod_total, erod_mon, erod_vault,
+
 	/* staves */
-	staff_total[lvl] = 0.0; staff_mon[lvl] = 0.0; staff_vault[lvl] = 0.0;	
-	sstaff_total[lvl] = 0.0; sstaff_mon[lvl] = 0.0; sstaff_vault[lvl] = 0.0;	
-	dstaff_total[lvl] = 0.0; dstaff_mon[lvl] = 0.0; dstaff_vault[lvl] = 0.0;	
-	kstaff_total[lvl] = 0.0; kstaff_mon[lvl] = 0.0; kstaff_vault[lvl] = 0.0;	
-	pstaff_total[lvl] = 0.0; pstaff_mon[lvl] = 0.0; pstaff_vault[lvl] = 0.0;
-	
+	staff_total, staff_mon, staff_vault,
+	sstaff_total, sstaff_mon, sstaff_vault,
+	dstaff_total, dstaff_mon, dstaff_vault,
+	kstaff_total, kstaff_mon, kstaff_vault,
+	pstaff_total, pstaff_mon, pstaff_vault,
+
 	/* wands */
-	wand_total[lvl] = 0.0; wand_mon[lvl] = 0.0; wand_vault[lvl] = 0.0;	
-	towand_total[lvl] = 0.0; towand_mon[lvl] = 0.0; towand_vault[lvl] = 0.0;
-	
+	wand_total, wand_mon, wand_vault,
+	towand_total, towand_mon, towand_vault,
+
 	/* rings */
-	ring_total[lvl] = 0.0; ring_mon[lvl] = 0.0; ring_vault[lvl] = 0.0;	
-	curing_total[lvl] = 0.0; curing_mon[lvl] = 0.0; curing_vault[lvl] = 0.0;	
-	spring_total[lvl] = 0.0; spring_mon[lvl] = 0.0; spring_vault[lvl] = 0.0;	
-	string_total[lvl] = 0.0; string_mon[lvl] = 0.0; string_vault[lvl] = 0.0;	
-	faring_total[lvl] = 0.0; faring_mon[lvl] = 0.0; faring_vault[lvl] = 0.0;	
-	siring_total[lvl] = 0.0; siring_mon[lvl] = 0.0; siring_vault[lvl] = 0.0;	
-	poring_total[lvl] = 0.0; poring_mon[lvl] = 0.0; poring_vault[lvl] = 0.0;	
-	brring_total[lvl] = 0.0; brring_mon[lvl] = 0.0; brring_vault[lvl] = 0.0;	
-	elring_total[lvl] = 0.0; elring_mon[lvl] = 0.0; elring_vault[lvl] = 0.0;	
-	onering_total[lvl] = 0.0; onering_mon[lvl] = 0.0; onering_vault[lvl] = 0.0;
-	
+	ring_total, ring_mon, ring_vault,
+	curing_total, curing_mon, curing_vault,
+	spring_total, spring_mon, spring_vault,
+	string_total, string_mon, string_vault,
+	faring_total, faring_mon, faring_vault,
+	siring_total, siring_mon, siring_vault,
+	poring_total, poring_mon, poring_vault,
+	brring_total, brring_mon, brring_vault,
+	elring_total, elring_mon, elring_vault,
+	onering_total, onering_mon, onering_vault,
+
 	/* amulets */
-	amu_total[lvl] = 0.0; amu_mon[lvl] = 0.0; amu_vault[lvl] = 0.0;
-	wisamu_total[lvl] = 0.0; wisamu_mon[lvl] = 0.0; wisamu_vault[lvl] = 0.0;
-	endamu_total[lvl] = 0.0; endamu_mon[lvl] = 0.0; endamu_vault[lvl] = 0.0;
-	teamu_total[lvl] = 0.0; teamu_mon[lvl] = 0.0; teamu_vault[lvl] = 0.0;
-	cuamu_total[lvl] = 0.0; cuamu_mon[lvl] = 0.0; cuamu_vault[lvl] = 0.0;
-	
-	mon_total[lvl] = 0.0; mon_ood[lvl] = 0.0; mon_deadly[lvl] = 0.0;
-	
-	uniq_total[lvl] = 0.0; uniq_ood[lvl] = 0.0; uniq_deadly[lvl] = 0.0;
-	
+	amu_total, amu_mon, amu_vault,
+	wisamu_total, wisamu_mon, wisamu_vault,
+	endamu_total, endamu_mon, endamu_vault,
+	teamu_total, teamu_mon, teamu_vault,
+	cuamu_total, cuamu_mon, cuamu_vault,
+
+	mon_total, mon_ood, mon_deadly,
+
+	uniq_total, uniq_ood, uniq_deadly,
+
 	/* books */
-	b1_total[lvl] =0.0; b1_mon[lvl] =0.0; b1_vault[lvl] =0.0;
-	b2_total[lvl] =0.0; b2_mon[lvl] =0.0; b2_vault[lvl] =0.0;
-	b3_total[lvl] =0.0; b3_mon[lvl] =0.0; b3_vault[lvl] =0.0;
-	b4_total[lvl] =0.0; b4_mon[lvl] =0.0; b4_vault[lvl] =0.0;
-	b5_total[lvl] =0.0; b5_mon[lvl] =0.0; b5_vault[lvl] =0.0;
-	b6_total[lvl] =0.0; b6_mon[lvl] =0.0; b6_vault[lvl] =0.0;
-	b7_total[lvl] =0.0; b7_mon[lvl] =0.0; b7_vault[lvl] =0.0;
-	b8_total[lvl] =0.0; b8_mon[lvl] =0.0; b8_vault[lvl] =0.0;
-	b9_total[lvl] =0.0; b9_mon[lvl] =0.0; b9_vault[lvl] =0.0;
-		
+	b1_total, b1_mon, b1_vault,
+	b2_total, b2_mon, b2_vault,
+	b3_total, b3_mon, b3_vault,
+	b4_total, b4_mon, b4_vault,
+	b5_total, b5_mon, b5_vault,
+	b6_total, b6_mon, b6_vault,
+	b7_total, b7_mon, b7_vault,
+	b8_total, b8_mon, b8_vault,
+	b9_total, b9_mon, b9_vault,
+};
+
+/* Every per-iteration first-find array */
+static int *iter_vals[] = {
+	art_it,
+	fa_it, si_it, po_it, nx_it,
+	cf_it, bl_it, te_it,
+	mb1_it, mb2_it, mb3_it,
+	mb4_it, mb5_it, mb6_it,
+	mb7_it, mb8_it, mb9_it,
+};
+
+static void init_iter_vals(int k)
+{
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(iter_vals); i++)
+		iter_vals[i][k] = 0;
+}
+
+/* set everything to 0.0 to begin */
+static void init_stat_vals(int lvl)
+{
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(stat_vals); i++)
+		stat_vals[i][lvl] = 0.0;
 }
 
 /*
@@ -2004,21 +2027,19 @@ static void post_process_stats(void)
 */
 static void scan_for_objects(void)
 { 
-	int y, x;
+	s16b o_idx, next_o_idx;
 
-	for (y = 1; y < DUNGEON_HGT - 1; y++) {
-		for (x = 1; x < DUNGEON_WID - 1; x++) {
-			const object_type *o_ptr;
+	/* Go through the objects on the floor */
+	for (o_idx = floor_object_first(); o_idx; o_idx = next_o_idx) {
+		const object_type *o_ptr = object_byid(o_idx);
 
-			
-			while ((o_ptr = get_first_object(y, x))) {
-				/* get data on the object */
-				get_obj_data(o_ptr, y, x, FALSE, FALSE);
-				
-				/* delete the object */
-				delete_object_stat(cave->o_idx[y][x]);
-			}
-		}
+		next_o_idx = floor_object_next(o_idx);
+
+		/* get data on the object */
+		get_obj_data(o_ptr, o_ptr->iy, o_ptr->ix, FALSE, FALSE);
+
+		/* delete the object */
+		delete_object_stat(o_idx);
 	}
 }
 
@@ -2099,6 +2120,22 @@ static void revive_uniques(void)
 	}
 		
 }	
+/*
+ * Do iterations [first, last) of one level of the diving sim.
+ */
+static void dive_level(int depth, int first, int last)
+{
+	p_ptr->depth = depth;
+	if (p_ptr->depth == 0) p_ptr->depth = 1;
+
+	/* do many iterations of each level */
+	for (iter = first; iter < last; iter++){
+
+		/* get level output */
+		stats_collect_level();
+	}
+}
+
 /* 
  * This function loops through the level and does N iterations of
  * the stat calling function.
@@ -2110,15 +2147,7 @@ static void diving_stats(void)
 	/* iterate through levels */
 	for (depth = 0; depth < MAX_LVL; depth += 5){
 	
-		p_ptr->depth = depth;
-		if (p_ptr->depth == 0) p_ptr->depth = 1;
-		
-		/* do many iterations of each level */
-		for (iter = 0; iter < tries; iter++){
-		
-			/* get level output */
-		     stats_collect_level();
-		}
+		dive_level(depth, 0, tries);
 		
 		/* print the output to the file */
 		print_stats(depth);
@@ -2129,6 +2158,41 @@ static void diving_stats(void)
 	}
 }
 
+/*
+ * Do one iteration of the clearing sim, all the way down the dungeon.
+ */
+static void clear_dungeon(void)
+{
+	int depth;
+
+	/* move all artifacts to uncreated */
+	uncreate_artifacts();
+
+	/* move all uniques to alive */
+	revive_uniques();
+
+	/* do randart regen */
+	if (regen){
+
+		/* get seed */
+		int seed_randart=randint0(0x10000000);
+
+		/* regen randarts */
+		do_randart(seed_randart,TRUE);
+
+	}
+
+	/* do game iterations */
+	for (depth = 1 ; depth < MAX_LVL; depth++){
+
+		/* move player to that depth */
+		p_ptr->depth = depth;
+
+		/* get stats */
+		stats_collect_level();
+	}
+}
+
 static void clearing_stats(void)
 {
 	int depth;
@@ -2136,43 +2200,9 @@ static void clearing_stats(void)
 	/* do many iterations of the game */
 	for (iter=0; iter < tries; iter++){
 		
-		/* move all artifacts to uncreated */
-		uncreate_artifacts();
-		
-		/* move all uniques to alive */
-		revive_uniques();
-		
-		/* do randart regen */
-		if ((regen) && (iter<tries)){
-		
-			/* get seed */
-			int seed_randart=randint0(0x10000000);
-			
-			/* regen randarts */
-			do_randart(seed_randart,TRUE);
-		
-		}
-		
-		/* do game iterations */
-		for (depth = 1 ; depth < MAX_LVL; depth++){
-		
-			/* debug */
-			//msg_format("Attempting level %d",depth);
-		
-			/* move player to that depth */
-			p_ptr->depth = depth;
-		
-			/* get stats */
-			stats_collect_level();
-			
-			//debug
-			//msg_format("Finished level %d,depth");
-		}
+		clear_dungeon();
 		
 		msg("Iteration %d complete",iter);
-		
-		
-				
 	}
 	
 	/* print to file */
@@ -2245,26 +2275,16 @@ static int stats_prompt(void)
 
 }
 
-/* 
- *This is the call from wiz_stats.  The top level function
- * in this code
+/*
+ * Open the log file and get everything ready for a run.  Returns TRUE if
+ * auto_more was turned on here, and so needs turning off again.
  */
-void stats_collect(void)
+static bool stats_start(void)
 {
-	static int simtype;
-	static bool auto_flag;
+	bool auto_flag = FALSE;
 	char buf[1024];
 	int i;
-	
-	/* prompt the user for sim params */
-	simtype=stats_prompt();
-	
-	/* make sure the results are good! */
-	if (!((simtype == 1) || (simtype == 2))) return; 
-	
-	/* are we in diving or clearing mode */
-	if (simtype == 2) clearing = TRUE;  else clearing = FALSE;
-	
+
 	/*Open log file*/
 	path_build(buf, sizeof(buf), ANGBAND_DIR_USER,
 				"stats.log");
@@ -2283,8 +2303,6 @@ void stats_collect(void)
 	 * of items, even on deeper levels, so it's not worth worrying
 	 * too much about.
 	 */
-	 auto_flag = FALSE;
-	 
 	 if (!OPT(auto_more)){
 	 
 		/* remember that we turned off auto_more */
@@ -2303,13 +2321,12 @@ void stats_collect(void)
 	
 	/* make sure all iter vals are 0 */
 	for (i = 0; i < TRIES_SIZE; i++) init_iter_vals(i);
-	
-	/* select diving option */
-	if (!clearing) diving_stats();
-	
-	/* select clearing option */
-	if (clearing) clearing_stats();
-		
+
+	return auto_flag;
+}
+
+static void stats_finish(bool auto_flag)
+{
 	/* Turn auto-more back off */
 	if (auto_flag) option_set(option_name(OPT_auto_more),FALSE);
 	
@@ -2321,106 +2338,264 @@ void stats_collect(void)
 	}	
 }
 
-#define DIST_MAX 10000
-
-int cave_dist[DUNGEON_HGT][DUNGEON_WID];
-
-
-void clear_cave_dist(void)
+/* 
+ *This is the call from wiz_stats.  The top level function
+ * in this code
+ */
+void stats_collect(void)
 {
-	int x,y;
-	for (y = 1; y < DUNGEON_HGT - 1; y++){
+	static int simtype;
+	bool auto_flag;
 	
-			for (x = 1; x < DUNGEON_WID - 1; x++){
-			
-				cave_dist[y][x] = -1;
-			}
-		}
-}		
-
-void calc_cave_distances(void)
-{
-	int dist, i;
-	int oy, ox, ty, tx, d;
-
-	/* Squares with distance from player of n-1 */  
-	int d_x_old[DIST_MAX];
-	int d_y_old[DIST_MAX];
-	int d_old_max;
-
-	/* Squares with distance from player of n */
-	int d_x_new[DIST_MAX];
-	int d_y_new[DIST_MAX];
-	int d_new_max;
+	/* prompt the user for sim params */
+	simtype=stats_prompt();
 	
-	/* Set all cave spots to inaccessible */
-	clear_cave_dist();
+	/* make sure the results are good! */
+	if (!((simtype == 1) || (simtype == 2))) return; 
 	
-	/* Get player location */
-	oy = d_y_old[0] = p_ptr->py;
-	ox = d_x_old[0] = p_ptr->px;
-	d_old_max = 1;
+	/* are we in diving or clearing mode */
+	if (simtype == 2) clearing = TRUE;  else clearing = FALSE;
 	
-	/* distance from player starts at 0*/
-	dist=0;
+	auto_flag = stats_start();
 	
-	/* Assign the distance value to the first square (player)*/
-	cave_dist[oy][ox] = dist;
+	/* select diving option */
+	if (!clearing) diving_stats();
 	
-	do{
-		d_new_max = 0;
-		dist++;
-		
-		/* Loop over all visited squares of the previous iteration*/
-		for(i=0 ;i < d_old_max; i++){
-		
-			/* Get the square we want to look at */
-			oy = d_y_old[i];
-			ox = d_x_old[i];
-			
-			//debug
-			//msg("x: %d y: %d dist: %d %d ",ox,oy,dist-1,i);
+	/* select clearing option */
+	if (clearing) clearing_stats();
 		
-			/* Get all adjacent squares */
-			for (d = 0; d < 8; d++){
-			
-				/* Adjacent square location */
-				ty = oy + ddy_ddd[d];
-				tx = ox + ddx_ddd[d];
-				
-				if (!(in_bounds_fully(ty,tx))) continue;
-				
-				/* Have we been here before? */
-				if (cave_dist[ty][tx] >= 0) continue;
-				
-				/* Is it a wall? */
-				if (cave->feat[ty][tx] > FEAT_RUBBLE) continue;
-				
-				/* Add the new location */
-				d_y_new[d_new_max] = ty;
-				d_x_new[d_new_max] = tx;
-				
-				/* Assign the distance to that spot */
-				cave_dist[ty][tx] = dist;
-				
-				d_new_max++;
-				
-				//debug
-				//msg("x: %d y: %d dist: %d ",tx,ty,dist);
-			}
+	stats_finish(auto_flag);
+}
+
+
+/*** Batch collection ***/
+
+/*
+ * The batch version does the same sims with no prompts and no redraws, and
+ * can share the iterations out between several worker processes.  Each
+ * worker is forked from the fully set-up game, seeds the RNG with its own
+ * seed, runs its share of the iterations into its own copy of the
+ * accumulators, and then writes them all down a pipe and exits.  Since
+ * add_stats() only ever adds, and each worker's first-find arrays only have
+ * entries for its own iterations, the parent just sums what comes back.
+ */
+
+/*
+ * Do iterations [first, last) of whichever sim is selected.
+ */
+static void stats_run_iterations(int first, int last)
+{
+	int depth;
+
+	if (clearing) {
+		for (iter = first; iter < last; iter++) clear_dungeon();
+	} else {
+		for (depth = 0; depth < MAX_LVL; depth += 5)
+			dive_level(depth, first, last);
+	}
+}
+
+static bool write_all(int fd, const void *buf, size_t len)
+{
+	const char *p = buf;
+
+	while (len) {
+		ssize_t n = write(fd, p, len);
+
+		if (n < 0 && errno == EINTR) continue;
+		if (n <= 0) return FALSE;
+
+		p += n;
+		len -= n;
+	}
+
+	return TRUE;
+}
+
+static bool read_all(int fd, void *buf, size_t len)
+{
+	char *p = buf;
+
+	while (len) {
+		ssize_t n = read(fd, p, len);
+
+		if (n < 0 && errno == EINTR) continue;
+		if (n <= 0) return FALSE;
+
+		p += n;
+		len -= n;
+	}
+
+	return TRUE;
+}
+
+/*
+ * Send all the accumulators down `fd`.
+ */
+static bool stats_send(int fd)
+{
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(stat_vals); i++)
+		if (!write_all(fd, stat_vals[i], MAX_LVL * sizeof(double)))
+			return FALSE;
+
+	for (i = 0; i < N_ELEMENTS(iter_vals); i++)
+		if (!write_all(fd, iter_vals[i], TRIES_SIZE * sizeof(int)))
+			return FALSE;
+
+	return TRUE;
+}
+
+/*
+ * Read a worker's accumulators from `fd` and add them into ours.
+ */
+static bool stats_merge(int fd)
+{
+	double vals[MAX_LVL];
+	int its[TRIES_SIZE];
+	size_t i;
+	int j;
+
+	for (i = 0; i < N_ELEMENTS(stat_vals); i++) {
+		if (!read_all(fd, vals, sizeof(vals))) return FALSE;
+		for (j = 0; j < MAX_LVL; j++) stat_vals[i][j] += vals[j];
+	}
+
+	for (i = 0; i < N_ELEMENTS(iter_vals); i++) {
+		if (!read_all(fd, its, sizeof(its))) return FALSE;
+		for (j = 0; j < TRIES_SIZE; j++) iter_vals[i][j] += its[j];
+	}
+
+	return TRUE;
+}
+
+/*
+ * Share `tries` iterations out between `jobs` workers, the i'th of which is
+ * seeded with `seed` + i.  Returns FALSE if any of them didn't report back.
+ */
+static bool stats_run_workers(int jobs, u32b seed)
+{
+	pid_t *pids = mem_zalloc(jobs * sizeof(*pids));
+	int *fds = mem_zalloc(jobs * sizeof(*fds));
+	bool ok = TRUE;
+	int i;
+
+	/* Don't let the workers inherit anything half-written */
+	fflush(stdout);
+
+	for (i = 0; i < jobs; i++) {
+		int fd[2];
+
+		if (pipe(fd) < 0) {
+			ok = FALSE;
+			break;
 		}
-		
-		/* copy the new distance list to the old one */
-		for (i=0 ;i<d_new_max; i++){
-		
-			d_y_old[i] = d_y_new[i];
-			d_x_old[i] = d_x_new[i];
+
+		pids[i] = fork();
+		if (pids[i] < 0) {
+			close(fd[0]);
+			close(fd[1]);
+			ok = FALSE;
+			break;
 		}
-		
-		d_old_max = d_new_max;
-	
-		
-	} while ((d_old_max > 0) || dist == DIST_MAX);
+
+		if (pids[i] == 0) {
+			close(fd[0]);
+
+			Rand_state_init(seed + i);
+			stats_run_iterations(i * tries / jobs, (i + 1) * tries / jobs);
+
+			/* Skip the exit handlers, which belong to the parent */
+			_exit(stats_send(fd[1]) ? 0 : 1);
+		}
+
+		close(fd[1]);
+		fds[i] = fd[0];
+	}
+
+	/* Collect everything from the workers that did start */
+	for (i = 0; i < jobs && pids[i] > 0; i++) {
+		int status;
+
+		if (!stats_merge(fds[i])) ok = FALSE;
+		close(fds[i]);
+
+		if (waitpid(pids[i], &status, 0) < 0 || !WIFEXITED(status) ||
+				WEXITSTATUS(status))
+			ok = FALSE;
+	}
+
+	mem_free(pids);
+	mem_free(fds);
+	return ok;
+}
+
+/*
+ * Collect stats without asking anything, for use from the command line.
+ * `simtype` is 1 for diving and 2 for clearing, as in stats_prompt(); the
+ * other parameters are the number of tries, whether to regenerate randarts
+ * each clearing iteration, the number of worker processes and the seed.
+ * The results go to stats.log as usual.  Returns FALSE if the parameters
+ * are bad or the workers failed.
+ */
+bool stats_collect_batch(int simtype, int num_tries, bool regen_arts,
+		int jobs, u32b seed)
+{
+	bool auto_flag, ok = TRUE;
+	int depth;
+
+	if (!((simtype == 1) || (simtype == 2))) return FALSE;
+	if (num_tries < 1) return FALSE;
+
+	clearing = (simtype == 2);
+	regen = clearing && regen_arts;
+	tries = num_tries;
+	addval = 1.0 / tries;
+
+	/* No point in workers with nothing to do */
+	if (jobs > tries) jobs = tries;
+
+	auto_flag = stats_start();
+
+	if (jobs > 1) {
+		ok = stats_run_workers(jobs, seed);
+	} else {
+		Rand_state_init(seed);
+		stats_run_iterations(0, tries);
+	}
+
+	/* print to file */
+	if (ok) {
+		if (clearing) {
+			for (depth = 0; depth < MAX_LVL; depth++) print_stats(depth);
+			post_process_stats();
+		} else {
+			for (depth = 0; depth < MAX_LVL; depth += 5) print_stats(depth);
+		}
+	}
+
+	stats_finish(auto_flag);
+	return ok;
+}
+
+/* Distances from the player, for disconnect_stats() */
+static struct dist_field stats_dist;
+
+/*
+ * Anything up to rubble can be got through, given time.
+ */
+static bool stats_dist_pass(struct cave *c, int y, int x)
+{
+	return cave_in_bounds_fully(c, y, x) && c->feat[y][x] <= FEAT_RUBBLE;
+}
+
+static void calc_cave_distances(void)
+{
+	dist_field_init(&stats_dist, DUNGEON_HGT, DUNGEON_WID, TRUE);
+	dist_field_fill(&stats_dist, cave, stats_dist_pass);
+	dist_field_add_source(&stats_dist, p_ptr->py, p_ptr->px);
+	dist_field_run(&stats_dist, 0);
 }
 
 void pit_stats(void)
@@ -2567,7 +2742,7 @@ void disconnect_stats(void)
 				if (cave->feat[y][x] > FEAT_RUBBLE) continue;
 				
 				/* Can we get there? */
-				if (cave_dist[y][x] >= 0){
+				if (dist_field_get(&stats_dist, y, x) >= 0){
 				
 					/* Is it a  down stairs? */
 					if ((cave->feat[y][x] == FEAT_MORE)){
@@ -2575,7 +2750,7 @@ void disconnect_stats(void)
 						has_dsc_from_stairs = FALSE;
 					
 						//debug
-						//msg("dist to stairs: %d",cave_dist[y][x]);
+						//msg("dist to stairs: %d",dist_field_get(&stats_dist, y, x));
 					
 					}
 					
@@ -1640,6 +1640,25 @@ void do_cmd_wiz_examine(void)
 	textblock_free(tb);
 }
 
+/*
+ * Write out how much memory each place in the source has allocated, in a
+ * MEM_PROFILE build.
+ */
+static void do_cmd_wiz_mem_profile(void)
+{
+#ifdef MEM_PROFILE
+	char buf[1024];
+
+	path_build(buf, sizeof(buf), ANGBAND_DIR_USER, "memprof.csv");
+	if (mem_profile_dump(buf))
+		msg("Allocation profile written to %s.", buf);
+	else
+		msg("Couldn't write %s.", buf);
+#else
+	msg("This build doesn't profile allocations.");
+#endif
+}
+
 /*
  * Ask for and parse a "debug command"
  *
@@ -1836,6 +1855,13 @@ void do_cmd_debug(void)
 
 		case 'L': do_cmd_keylog(); break;
 
+		/* Dump the allocation profile */
+		case 'M':
+		{
+			do_cmd_wiz_mem_profile();
+			break;
+		}
+
 		/* Magic Mapping */
 		case 'm':
 		{
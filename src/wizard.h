@@ -6,6 +6,8 @@ extern void do_cmd_debug(void);
 
 /* wiz-stats.c */
 void stats_collect(void);
+bool stats_collect_batch(int simtype, int num_tries, bool regen_arts,
+		int jobs, u32b seed);
 void disconnect_stats(void);
 void pit_stats(void);
 
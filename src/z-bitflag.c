@@ -19,6 +19,31 @@
 #include "z-bitflag.h"
 
 
+/*
+ * Flag sets are stored a byte at a time (their layout is part of the
+ * savefile format) but the functions below work through them a machine word
+ * at a time.  When the size isn't a whole number of words, the last word is
+ * taken to end at the end of the set, overlapping the one before; this is
+ * harmless for everything except flag_negate(), as doing the same operation
+ * twice to a byte leaves it unchanged.  Sets smaller than a word are done a
+ * byte at a time.
+ *
+ * Words are loaded and stored with memcpy() so that the arrays needn't be
+ * aligned; compilers turn these into plain loads and stores, even when not
+ * optimising.
+ */
+typedef size_t flag_word;
+
+#define FLAG_WORD_SIZE    sizeof(flag_word)
+
+/* The start of the word at or after `i`, not running past the end */
+#define FLAG_WORD_AT(i, size) \
+	((i) + FLAG_WORD_SIZE > (size) ? (size) - FLAG_WORD_SIZE : (i))
+
+#define flag_load(w, flags)   memcpy(&(w), (flags), sizeof(flag_word))
+#define flag_store(flags, w)  memcpy((flags), &(w), sizeof(flag_word))
+
+
 /**
  * Tests if a flag is "on" in a bitflag set.
  *
@@ -64,18 +89,35 @@ bool flag_has_dbg(const bitflag *flags, const size_t size, const int flag, const
  */
 int flag_next(const bitflag *flags, const size_t size, const int flag)
 {
-	const int max_flags = FLAG_MAX(size);
-	int f, flag_offset, flag_binary;
+	size_t i;
+	int bits, b;
+
+	if (flag == FLAG_END) return flag_next(flags, size, FLAG_START);
+	if (flag >= FLAG_MAX(size)) return FLAG_END;
 
-	for (f = flag; f < max_flags; f++)
+	/* Ignore flags in the first byte before the one asked for */
+	i = FLAG_OFFSET(flag);
+	bits = flags[i] & ~(FLAG_BINARY(flag) - 1);
+
+	while (!bits)
 	{
-		flag_offset = FLAG_OFFSET(f);
-		flag_binary = FLAG_BINARY(f);
+		flag_word w;
 
-		if (flags[flag_offset] & flag_binary) return f;
+		/* Skip empty words, then empty bytes */
+		for (i++; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		{
+			flag_load(w, flags + i);
+			if (w) break;
+		}
+
+		if (i >= size) return FLAG_END;
+
+		bits = flags[i];
 	}
 
-	return FLAG_END;
+	for (b = 0; !(bits & (1 << b)); b++) ;
+
+	return (int)(i * FLAG_WIDTH) + b + FLAG_START;
 }
 
 
@@ -88,9 +130,21 @@ int flag_next(const bitflag *flags, const size_t size, const int flag)
 bool flag_is_empty(const bitflag *flags, const size_t size)
 {
 	size_t i;
+	flag_word w;
+
+	if (size < FLAG_WORD_SIZE)
+	{
+		for (i = 0; i < size; i++)
+			if (flags[i] > 0) return FALSE;
+
+		return TRUE;
+	}
 
-	for (i = 0; i < size; i++)
-		if (flags[i] > 0) return FALSE;
+	for (i = 0; i < size; i += FLAG_WORD_SIZE)
+	{
+		flag_load(w, flags + FLAG_WORD_AT(i, size));
+		if (w) return FALSE;
+	}
 
 	return TRUE;
 }
@@ -105,9 +159,21 @@ bool flag_is_empty(const bitflag *flags, const size_t size)
 bool flag_is_full(const bitflag *flags, const size_t size)
 {
 	size_t i;
+	flag_word w;
+
+	if (size < FLAG_WORD_SIZE)
+	{
+		for (i = 0; i < size; i++)
+			if (flags[i] != (bitflag) -1) return FALSE;
+
+		return TRUE;
+	}
 
-	for (i = 0; i < size; i++)
-		if (flags[i] != (bitflag) -1) return FALSE;
+	for (i = 0; i < size; i += FLAG_WORD_SIZE)
+	{
+		flag_load(w, flags + FLAG_WORD_AT(i, size));
+		if (w != (flag_word) -1) return FALSE;
+	}
 
 	return TRUE;
 }
@@ -122,9 +188,24 @@ bool flag_is_full(const bitflag *flags, const size_t size)
 bool flag_is_inter(const bitflag *flags1, const bitflag *flags2, const size_t size)
 {
 	size_t i;
+	flag_word w1, w2;
+
+	if (size < FLAG_WORD_SIZE)
+	{
+		for (i = 0; i < size; i++)
+			if (flags1[i] & flags2[i]) return TRUE;
+
+		return FALSE;
+	}
 
-	for (i = 0; i < size; i++)
-		if (flags1[i] & flags2[i]) return TRUE;
+	for (i = 0; i < size; i += FLAG_WORD_SIZE)
+	{
+		size_t j = FLAG_WORD_AT(i, size);
+
+		flag_load(w1, flags1 + j);
+		flag_load(w2, flags2 + j);
+		if (w1 & w2) return TRUE;
+	}
 
 	return FALSE;
 }
@@ -139,9 +220,24 @@ bool flag_is_inter(const bitflag *flags1, const bitflag *flags2, const size_t si
 bool flag_is_subset(const bitflag *flags1, const bitflag *flags2, const size_t size)
 {
 	size_t i;
+	flag_word w1, w2;
 
-	for (i = 0; i < size; i++)
-		if (~flags1[i] & flags2[i]) return FALSE;
+	if (size < FLAG_WORD_SIZE)
+	{
+		for (i = 0; i < size; i++)
+			if (~flags1[i] & flags2[i]) return FALSE;
+
+		return TRUE;
+	}
+
+	for (i = 0; i < size; i += FLAG_WORD_SIZE)
+	{
+		size_t j = FLAG_WORD_AT(i, size);
+
+		flag_load(w1, flags1 + j);
+		flag_load(w2, flags2 + j);
+		if (~w1 & w2) return FALSE;
+	}
 
 	return TRUE;
 }
@@ -259,8 +355,17 @@ void flag_setall(bitflag *flags, const size_t size)
 void flag_negate(bitflag *flags, const size_t size)
 {
 	size_t i;
-	
-	for (i = 0; i < size; i++)
+	flag_word w;
+
+	/* No overlapping here, as negating twice would undo it */
+	for (i = 0; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+	{
+		flag_load(w, flags + i);
+		w = ~w;
+		flag_store(flags + i, w);
+	}
+
+	for (; i < size; i++)
 		flags[i] = ~flags[i];
 }
 
@@ -287,17 +392,37 @@ void flag_copy(bitflag *flags1, const bitflag *flags2, const size_t size)
 bool flag_union(bitflag *flags1, const bitflag *flags2, const size_t size)
 {
 	size_t i;
-	bool delta = FALSE;
+	flag_word w1, w2, changed = 0;
 
-	for (i = 0; i < size; i++)
+	if (size < FLAG_WORD_SIZE)
 	{
-		/* !flag_is_subset() */
-		if (~flags1[i] & flags2[i]) delta = TRUE;
+		bool delta = FALSE;
+
+		for (i = 0; i < size; i++)
+		{
+			/* !flag_is_subset() */
+			if (~flags1[i] & flags2[i]) delta = TRUE;
 
-		flags1[i] |= flags2[i];
+			flags1[i] |= flags2[i];
+		}
+
+		return delta;
 	}
 
-	return delta;
+	for (i = 0; i < size; i += FLAG_WORD_SIZE)
+	{
+		size_t j = FLAG_WORD_AT(i, size);
+
+		flag_load(w1, flags1 + j);
+		flag_load(w2, flags2 + j);
+
+		changed |= ~w1 & w2;
+		w1 = w1 | w2;
+
+		flag_store(flags1 + j, w1);
+	}
+
+	return changed ? TRUE : FALSE;
 }
 
 
@@ -311,17 +436,37 @@ bool flag_union(bitflag *flags1, const bitflag *flags2, const size_t size)
 bool flag_comp_union(bitflag *flags1, const bitflag *flags2, const size_t size)
 {
 	size_t i;
-	bool delta = FALSE;
+	flag_word w1, w2, changed = 0;
 
-	for (i = 0; i < size; i++)
+	if (size < FLAG_WORD_SIZE)
 	{
-		/* no equivalent fn */
-		if (!(~flags1[i] & ~flags2[i])) delta = TRUE;
+		bool delta = FALSE;
+
+		for (i = 0; i < size; i++)
+		{
+			/* no equivalent fn */
+			if ((bitflag) (~flags1[i] & ~flags2[i])) delta = TRUE;
 
-		flags1[i] |= ~flags2[i];
+			flags1[i] |= ~flags2[i];
+		}
+
+		return delta;
 	}
 
-	return delta;
+	for (i = 0; i < size; i += FLAG_WORD_SIZE)
+	{
+		size_t j = FLAG_WORD_AT(i, size);
+
+		flag_load(w1, flags1 + j);
+		flag_load(w2, flags2 + j);
+
+		changed |= ~w1 & ~w2;
+		w1 = w1 | ~w2;
+
+		flag_store(flags1 + j, w1);
+	}
+
+	return changed ? TRUE : FALSE;
 }
 
 
@@ -335,18 +480,37 @@ bool flag_comp_union(bitflag *flags1, const bitflag *flags2, const size_t size)
 bool flag_inter(bitflag *flags1, const bitflag *flags2, const size_t size)
 {
 	size_t i;
-	bool delta = FALSE;
+	flag_word w1, w2, changed = 0;
 
-	for (i = 0; i < size; i++)
+	if (size < FLAG_WORD_SIZE)
 	{
-		/* !flag_is_equal() */
-		if (!(flags1[i] == flags2[i])) delta = TRUE;
+		bool delta = FALSE;
+
+		for (i = 0; i < size; i++)
+		{
+			/* !flag_is_equal() */
+			if (!(flags1[i] == flags2[i])) delta = TRUE;
 
-		flags1[i] &= flags2[i];
+			flags1[i] &= flags2[i];
+		}
+
+		return delta;
 	}
 
-	return delta;
+	for (i = 0; i < size; i += FLAG_WORD_SIZE)
+	{
+		size_t j = FLAG_WORD_AT(i, size);
+
+		flag_load(w1, flags1 + j);
+		flag_load(w2, flags2 + j);
+
+		changed |= w1 ^ w2;
+		w1 = w1 & w2;
 
+		flag_store(flags1 + j, w1);
+	}
+
+	return changed ? TRUE : FALSE;
 }
 
 
@@ -360,17 +524,37 @@ bool flag_inter(bitflag *flags1, const bitflag *flags2, const size_t size)
 bool flag_diff(bitflag *flags1, const bitflag *flags2, const size_t size)
 {
 	size_t i;
-	bool delta = FALSE;
+	flag_word w1, w2, changed = 0;
 
-	for (i = 0; i < size; i++)
+	if (size < FLAG_WORD_SIZE)
 	{
-		/* flag_is_inter() */
-		if (flags1[i] & flags2[i]) delta = TRUE;
+		bool delta = FALSE;
 
-		flags1[i] &= ~flags2[i];
+		for (i = 0; i < size; i++)
+		{
+			/* flag_is_inter() */
+			if (flags1[i] & flags2[i]) delta = TRUE;
+
+			flags1[i] &= ~flags2[i];
+		}
+
+		return delta;
 	}
 
-	return delta;
+	for (i = 0; i < size; i += FLAG_WORD_SIZE)
+	{
+		size_t j = FLAG_WORD_AT(i, size);
+
+		flag_load(w1, flags1 + j);
+		flag_load(w2, flags2 + j);
+
+		changed |= w1 & w2;
+		w1 = w1 & ~w2;
+
+		flag_store(flags1 + j, w1);
+	}
+
+	return changed ? TRUE : FALSE;
 }
 
 
@@ -577,10 +761,14 @@ bool flags_mask(bitflag *flags, const size_t size, ...)
 	va_list args;
 	bool delta = FALSE;
 
-	bitflag *mask;
+	bitflag buf[FLAG_MASK_MAX];
+	bitflag *mask = buf;
 
-	/* Build the mask */
-	mask = C_ZNEW(size, bitflag);
+	/* Build the mask, on the stack unless it's unusually big */
+	if (size > FLAG_MASK_MAX)
+		mask = C_ZNEW(size, bitflag);
+	else
+		flag_wipe(mask, size);
 
 	va_start(args, size);
 
@@ -592,9 +780,8 @@ bool flags_mask(bitflag *flags, const size_t size, ...)
 
 	delta = flag_inter(flags, mask, size);
 
-	/* Free the mask */
-
-	FREE(mask);
+	if (mask != buf)
+		FREE(mask);
 
 	return delta;
 }
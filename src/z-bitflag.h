@@ -49,6 +49,94 @@ typedef byte bitflag;
 #define FLAG_BINARY(id)   (1 << ((id) - FLAG_START) % FLAG_WIDTH)
 
 
+/*
+ * Constant flag masks, for use in place of the va-arg functions where speed
+ * matters.  FLAG_MASK() expands to an initializer for an array of
+ * FLAG_MASK_MAX bitflags with up to eight flags set, e.g.
+ *
+ *   static const bitflag walls[FLAG_MASK_MAX] =
+ *       FLAG_MASK(RF_PASS_WALL, RF_KILL_WALL);
+ *
+ *   if (flag_is_inter(r_ptr->flags, walls, RF_SIZE)) ...
+ *
+ * flag_is_inter() then does the job of flags_test(), flag_is_subset() that of
+ * flags_test_all(), and so on.  The mask is worked out by the compiler, so
+ * there is no set-up cost.  Only the first `size` bytes of the mask are
+ * looked at, so the one array size does for every kind of flag.
+ *
+ * Giving FLAG_MASK() more than eight flags, or a flag which doesn't fit in
+ * FLAG_MASK_MAX bytes, stops the build rather than leaving a flag out.  A
+ * kind of flag which is used with masks should say so with FLAG_MASK_FITS(),
+ * which likewise stops the build if its arrays are bigger than a mask.
+ */
+#define FLAG_MASK_MAX     32
+
+/* Zero, or a compile-time error if `cond` is false */
+#define FLAG_CHECK(cond) (0 * (int)sizeof(char[(cond) ? 1 : -1]))
+
+/* Check that arrays of `size` bitflags can be used with a mask */
+#define FLAG_MASK_FITS(name, size) \
+	typedef char name##_fits_flag_mask[(size) <= FLAG_MASK_MAX ? 1 : -1]
+
+/* Check that flag `f` falls inside the mask */
+#define FLAG_MASK_IN(f) FLAG_CHECK((f) < FLAG_MAX(FLAG_MASK_MAX))
+
+/* The part of the mask for flag `f` that falls in byte `i` */
+#define FLAG_MASK_BIT(f, i) \
+	((f) > FLAG_END && FLAG_OFFSET(f) == (i) ? FLAG_BINARY(f) : 0)
+
+#define FLAG_MASK_BYTE(i, a, b, c, d, e, f, g, h) \
+	(FLAG_MASK_BIT(a, i) | FLAG_MASK_BIT(b, i) | FLAG_MASK_BIT(c, i) | \
+	 FLAG_MASK_BIT(d, i) | FLAG_MASK_BIT(e, i) | FLAG_MASK_BIT(f, i) | \
+	 FLAG_MASK_BIT(g, i) | FLAG_MASK_BIT(h, i))
+
+/*
+ * The ninth argument is the first of the padding FLAG_MASK() adds, unless
+ * the caller gave more than eight flags.
+ */
+#define FLAG_MASK_(a, b, c, d, e, f, g, h, extra, ...) { \
+	FLAG_MASK_BYTE( 0, a, b, c, d, e, f, g, h) | \
+		FLAG_CHECK((extra) == FLAG_END) | \
+		FLAG_MASK_IN(a) | FLAG_MASK_IN(b) | FLAG_MASK_IN(c) | \
+		FLAG_MASK_IN(d) | FLAG_MASK_IN(e) | FLAG_MASK_IN(f) | \
+		FLAG_MASK_IN(g) | FLAG_MASK_IN(h), \
+	FLAG_MASK_BYTE( 1, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE( 2, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE( 3, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE( 4, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE( 5, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE( 6, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE( 7, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE( 8, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE( 9, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(10, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(11, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(12, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(13, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(14, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(15, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(16, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(17, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(18, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(19, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(20, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(21, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(22, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(23, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(24, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(25, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(26, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(27, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(28, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(29, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(30, a, b, c, d, e, f, g, h), \
+	FLAG_MASK_BYTE(31, a, b, c, d, e, f, g, h) }
+
+#define FLAG_MASK(...) \
+	FLAG_MASK_(__VA_ARGS__, FLAG_END, FLAG_END, FLAG_END, FLAG_END, \
+	           FLAG_END, FLAG_END, FLAG_END, FLAG_END, FLAG_END)
+
+
 bool flag_has       (const bitflag *flags, const size_t size, const int flag);
 bool flag_has_dbg   (const bitflag *flags, const size_t size, const int flag, const char *fi, const char *fl);
 int  flag_next      (const bitflag *flags, const size_t size, const int flag);
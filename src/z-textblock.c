@@ -27,7 +27,7 @@
 #include "z-form.h"
 
 #define TEXTBLOCK_LEN_INITIAL		128
-#define TEXTBLOCK_LEN_INCR(x)		((x) + 128)
+#define TEXTBLOCK_LEN_INCR(x)		((x) * 2)
 
 struct textblock {
 	wchar_t *text;
@@ -35,39 +35,119 @@ struct textblock {
 
 	size_t strlen;
 	size_t size;
+
+	/* Where the memory comes from, or NULL for the heap */
+	struct mem_arena *arena;
+
+	/* The last wrap worked out, for lines of `wrap_width`; 0 if none */
+	size_t wrap_width;
+	size_t wrap_lines;
+	size_t *wrap_starts;
+	size_t *wrap_lengths;
 };
 
 
-/**
- * Create a new textblock object and return it.
+static void *textblock_alloc(textblock *tb, size_t len)
+{
+	return tb->arena ? mem_arena_alloc(tb->arena, len) : mem_zalloc(len);
+}
+
+static void textblock_release(textblock *tb, void *p)
+{
+	if (!tb->arena) mem_free(p);
+}
+
+/*
+ * Forget the cached wrap, e.g. because the text has changed.
  */
-textblock *textblock_new(void)
+static void textblock_unwrap(textblock *tb)
+{
+	textblock_release(tb, tb->wrap_starts);
+	textblock_release(tb, tb->wrap_lengths);
+	tb->wrap_starts = NULL;
+	tb->wrap_lengths = NULL;
+	tb->wrap_width = 0;
+	tb->wrap_lines = 0;
+}
+
+static textblock *textblock_make(struct mem_arena *a)
 {
-	textblock *tb = mem_zalloc(sizeof *tb);
+	textblock *tb = a ? mem_arena_alloc(a, sizeof *tb) : mem_zalloc(sizeof *tb);
 
+	tb->arena = a;
 	tb->size = TEXTBLOCK_LEN_INITIAL;
-	tb->text = mem_zalloc(tb->size * sizeof *tb->text);
-	tb->attrs = mem_zalloc(tb->size);
+	tb->text = textblock_alloc(tb, tb->size * sizeof *tb->text);
+	tb->attrs = textblock_alloc(tb, tb->size);
 
 	return tb;
 }
 
+/**
+ * Create a new textblock object and return it.
+ */
+textblock *textblock_new(void)
+{
+	return textblock_make(NULL);
+}
+
+/**
+ * Create a new textblock object which takes all its memory from the arena
+ * `a`, and so goes away when that is reset or released.  It's fine, but
+ * not necessary, to textblock_free() it.  If `a` is NULL, this is just
+ * textblock_new().
+ */
+textblock *textblock_new_in(struct mem_arena *a)
+{
+	return textblock_make(a);
+}
+
 /**
  * Free a textblock object.
  */
 void textblock_free(textblock *tb)
 {
+	if (tb->arena) return;
+
+	textblock_unwrap(tb);
 	mem_free(tb->text);
 	mem_free(tb->attrs);
 	mem_free(tb);
 }
 
+/*
+ * Make sure there's room for `len` more characters and a terminator.
+ */
+static void textblock_reserve(textblock *tb, size_t len)
+{
+	size_t size = tb->size;
+
+	while (size < tb->strlen + len + 1)
+		size = TEXTBLOCK_LEN_INCR(size);
+
+	if (size == tb->size) return;
+
+	if (tb->arena) {
+		wchar_t *text = mem_arena_alloc(tb->arena, size * sizeof *text);
+		byte *attrs = mem_arena_alloc(tb->arena, size);
+
+		memcpy(text, tb->text, tb->strlen * sizeof *text);
+		memcpy(attrs, tb->attrs, tb->strlen);
+		tb->text = text;
+		tb->attrs = attrs;
+	} else {
+		tb->text = mem_realloc(tb->text, size * sizeof *tb->text);
+		tb->attrs = mem_realloc(tb->attrs, size);
+	}
+
+	tb->size = size;
+}
+
 static void textblock_vappend_c(textblock *tb, byte attr, const char *fmt,
 		va_list vp)
 {
-	size_t temp_len = TEXTBLOCK_LEN_INITIAL;
-	char *temp_space = mem_zalloc(temp_len);
-	size_t remaining = tb->size - tb->strlen;
+	char buf[1024];
+	size_t temp_len = sizeof buf;
+	char *temp_space = buf;
 	size_t new_length;
 
 	/* We have to format the incoming string in native (external) format
@@ -89,23 +169,28 @@ static void textblock_vappend_c(textblock *tb, byte attr, const char *fmt,
 		}
 
 		temp_len = TEXTBLOCK_LEN_INCR(temp_len);
-		temp_space = mem_realloc(temp_space, temp_len * sizeof *temp_space);
+		if (temp_space == buf)
+			temp_space = mem_alloc(temp_len * sizeof *temp_space);
+		else
+			temp_space = mem_realloc(temp_space, temp_len * sizeof *temp_space);
 	}
 
 	/* Get extent of addition in wide chars */
 	new_length = Term_mbstowcs(NULL, temp_space, 0);
 
-	/* If we need more room, reallocate it */
-	if (remaining < new_length) {
-		tb->size = TEXTBLOCK_LEN_INCR(tb->strlen + new_length);
-		tb->text = mem_realloc(tb->text, tb->size * sizeof *tb->text);
-		tb->attrs = mem_realloc(tb->attrs, tb->size);
-	}
+	/* Make sure there's room for it */
+	textblock_reserve(tb, new_length);
+
 	/* Convert to wide chars, into the text block buffer */
 	Term_mbstowcs(tb->text + tb->strlen, temp_space, tb->size - tb->strlen);
 	memset(tb->attrs + tb->strlen, attr, new_length);
 	tb->strlen += new_length;
-	mem_free(temp_space);
+	tb->text[tb->strlen] = L'\0';
+
+	/* Any wrap we had is out of date */
+	if (tb->wrap_width) textblock_unwrap(tb);
+
+	if (temp_space != buf) mem_free(temp_space);
 }
 
 /**
@@ -234,20 +319,65 @@ size_t textblock_calculate_lines(textblock *tb,
 	return cur_line;
 }
 
+/**
+ * Like textblock_calculate_lines(), but the lines belong to the textblock
+ * and are kept until it's changed, so that showing the same text at the
+ * same width over and over only works out the wrap once.  The arrays
+ * mustn't be freed, and are only good until the next append, or the next
+ * call with a different width.
+ *
+ * \returns Number of lines in output.
+ */
+size_t textblock_lines(textblock *tb, const size_t **line_starts,
+		const size_t **line_lengths, size_t width)
+{
+	if (tb->wrap_width != width) {
+		size_t *starts = NULL, *lengths = NULL;
+		size_t n_lines;
+
+		textblock_unwrap(tb);
+		n_lines = textblock_calculate_lines(tb, &starts, &lengths, width);
+
+		/* Keep arena blocks' lines in the arena too */
+		if (tb->arena) {
+			if (n_lines) {
+				tb->wrap_starts = mem_arena_alloc(tb->arena,
+						n_lines * sizeof *starts);
+				tb->wrap_lengths = mem_arena_alloc(tb->arena,
+						n_lines * sizeof *lengths);
+				memcpy(tb->wrap_starts, starts, n_lines * sizeof *starts);
+				memcpy(tb->wrap_lengths, lengths, n_lines * sizeof *lengths);
+			}
+			mem_free(starts);
+			mem_free(lengths);
+		} else {
+			tb->wrap_starts = starts;
+			tb->wrap_lengths = lengths;
+		}
+
+		tb->wrap_width = width;
+		tb->wrap_lines = n_lines;
+	}
+
+	*line_starts = tb->wrap_starts;
+	*line_lengths = tb->wrap_lengths;
+	return tb->wrap_lines;
+}
+
 /**
  * Output a textblock to file.
  */
 void textblock_to_file(textblock *tb, ang_file *f, int indent, int wrap_at)
 {
-	size_t *line_starts = NULL;
-	size_t *line_lengths = NULL;
+	const size_t *line_starts = NULL;
+	const size_t *line_lengths = NULL;
 
 	size_t n_lines, i;
 
 	int width = wrap_at - indent;
 	assert(width > 0);
 
-	n_lines = textblock_calculate_lines(tb, &line_starts, &line_lengths, width);
+	n_lines = textblock_lines(tb, &line_starts, &line_lengths, width);
 
 	for (i = 0; i < n_lines; i++) {
 		file_putf(f, "%*c%.*ls\n",
@@ -7,8 +7,10 @@
 /** Opaque text_block type */
 typedef struct textblock textblock;
 
+struct mem_arena;
 
 textblock *textblock_new(void);
+textblock *textblock_new_in(struct mem_arena *a);
 void textblock_free(textblock *tb);
 
 void textblock_append(textblock *tb, const char *fmt, ...);
@@ -18,6 +20,7 @@ const wchar_t *textblock_text(textblock *tb);
 const byte *textblock_attrs(textblock *tb);
 
 size_t textblock_calculate_lines(textblock *tb, size_t **line_starts, size_t **line_lengths, size_t width);
+size_t textblock_lines(textblock *tb, const size_t **line_starts, const size_t **line_lengths, size_t width);
 
 void textblock_to_file(textblock *tb, ang_file *f, int indent, int wrap_at);
 
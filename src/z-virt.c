@@ -18,12 +18,183 @@
 #include "z-virt.h"
 #include "z-util.h"
 
+/* Here we want the functions themselves, not the profiling macros */
+#undef mem_alloc
+#undef mem_zalloc
+#undef mem_realloc
+#undef string_make
+#undef string_append
+
 unsigned int mem_flags = 0;
 
 #define SZ(uptr)	*((size_t *)((char *)(uptr) - sizeof(size_t)))
 
+
+#ifdef MEM_PROFILE
+
+/*
+ * Each block also remembers which site allocated it, in front of its size.
+ */
+#define MEM_HEAD	(2 * sizeof(size_t))
+#define SITE(uptr)	*((size_t *)((char *)(uptr) - 2 * sizeof(size_t)))
+
+/* Number of sites we can tell apart; must be a power of two */
+#define MEM_SITES	4096
+
+/* Allocation sizes are counted in powers of two from 8 up to this many */
+#define MEM_BUCKETS	12
+
+/*
+ * Everything allocated from one place in the source.  Site 0 is for the
+ * allocations we can't place, because they came through a plain mem_alloc()
+ * or because the table is full.
+ */
+struct mem_site {
+	const char *file;
+	int line;
+
+	u32b allocs;
+	u32b frees;
+	size_t live;
+	size_t peak;
+	size_t total;
+	u32b sizes[MEM_BUCKETS];
+};
+
+static struct mem_site mem_sites[MEM_SITES];
+
 /*
- * Allocate `len` bytes of memory.
+ * Find the site for `file`:`line`, adding it if it's new.  The compiler
+ * needn't give every __FILE__ in one file the same address, so the names
+ * are hashed and compared by their contents; the pointers are only a quick
+ * way to see that two names match.
+ */
+static size_t mem_site(const char *file, int line)
+{
+	size_t h = 2166136261UL, i;
+	const char *s;
+
+	if (!file) return 0;
+
+	for (s = file; *s; s++)
+		h = (h ^ (byte)*s) * 16777619UL;
+	h += (size_t)line * 2654435761UL;
+
+	for (i = 0; i < MEM_SITES; i++) {
+		size_t n = (h + i) & (MEM_SITES - 1);
+		struct mem_site *site = &mem_sites[n];
+
+		if (!n) continue;
+
+		if (site->line == line && site->file &&
+				(site->file == file || !strcmp(site->file, file)))
+			return n;
+
+		if (!site->file) {
+			site->file = file;
+			site->line = line;
+			return n;
+		}
+	}
+
+	return 0;
+}
+
+static void mem_note_alloc(size_t n, size_t len)
+{
+	struct mem_site *site = &mem_sites[n];
+	size_t b = 0;
+
+	while (b < MEM_BUCKETS - 1 && len > ((size_t)8 << b))
+		b++;
+
+	site->allocs++;
+	site->sizes[b]++;
+	site->total += len;
+	site->live += len;
+	if (site->live > site->peak)
+		site->peak = site->live;
+}
+
+static void mem_note_free(size_t n, size_t len)
+{
+	mem_sites[n].frees++;
+	mem_sites[n].live -= len;
+}
+
+/* Heaviest churn first */
+static int mem_site_cmp(const void *a, const void *b)
+{
+	const struct mem_site *sa = *(const struct mem_site **)a;
+	const struct mem_site *sb = *(const struct mem_site **)b;
+
+	if (sa->total != sb->total)
+		return sa->total < sb->total ? 1 : -1;
+	return 0;
+}
+
+/*
+ * Write one line of CSV for every site which has allocated anything, to
+ * the file at `path`.  Returns FALSE if the file couldn't be written.
+ */
+bool mem_profile_dump(const char *path)
+{
+	struct mem_site **order;
+	FILE *fp;
+	size_t i, n = 0;
+	int b;
+
+	fp = fopen(path, "w");
+	if (!fp) return FALSE;
+
+	/* Sort a list of our own, so we don't count ourselves */
+	order = malloc(MEM_SITES * sizeof(*order));
+	if (!order) {
+		fclose(fp);
+		return FALSE;
+	}
+
+	for (i = 0; i < MEM_SITES; i++)
+		if (mem_sites[i].allocs)
+			order[n++] = &mem_sites[i];
+	qsort(order, n, sizeof(*order), mem_site_cmp);
+
+	fprintf(fp, "file,line,allocs,frees,live_bytes,peak_bytes,total_bytes");
+	for (b = 0; b < MEM_BUCKETS - 1; b++)
+		fprintf(fp, ",le_%lu", (unsigned long)8 << b);
+	fprintf(fp, ",gt_%lu\n", (unsigned long)8 << (MEM_BUCKETS - 2));
+
+	for (i = 0; i < n; i++) {
+		struct mem_site *site = order[i];
+
+		fprintf(fp, "%s,%d,%lu,%lu,%lu,%lu,%lu",
+				site->file ? site->file : "(unknown)", site->line,
+				(unsigned long)site->allocs, (unsigned long)site->frees,
+				(unsigned long)site->live, (unsigned long)site->peak,
+				(unsigned long)site->total);
+		for (b = 0; b < MEM_BUCKETS; b++)
+			fprintf(fp, ",%lu", (unsigned long)site->sizes[b]);
+		fprintf(fp, "\n");
+	}
+
+	free(order);
+	return fclose(fp) == 0;
+}
+
+#else /* MEM_PROFILE */
+
+#define MEM_HEAD	sizeof(size_t)
+
+bool mem_profile_dump(const char *path)
+{
+	return FALSE;
+}
+
+#endif /* MEM_PROFILE */
+
+
+/*
+ * Allocate `len` bytes of memory, on behalf of `file`:`line`.
  *
  * Returns:
  *  - NULL if `len` == 0; or
@@ -31,61 +202,98 @@ unsigned int mem_flags = 0;
  *
  * Doesn't return on out of memory.
  */
-void *mem_alloc(size_t len)
+void *mem_alloc_at(size_t len, const char *file, int line)
 {
 	char *mem;
 
 	/* Allow allocation of "zero bytes" */
 	if (len == 0) return (NULL);
 
-	mem = malloc(len + sizeof(size_t));
+	mem = malloc(len + MEM_HEAD);
 	if (!mem)
 		quit("Out of Memory!");
-	mem += sizeof(size_t);
+	mem += MEM_HEAD;
 	if (mem_flags & MEM_POISON_ALLOC)
 		memset(mem, 0xCC, len);
 	SZ(mem) = len;
 
+#ifdef MEM_PROFILE
+	SITE(mem) = mem_site(file, line);
+	mem_note_alloc(SITE(mem), len);
+#endif
+
 	return mem;
 }
 
-void *mem_zalloc(size_t len)
+void *mem_alloc(size_t len)
 {
-	void *mem = mem_alloc(len);
+	return mem_alloc_at(len, NULL, 0);
+}
+
+void *mem_zalloc_at(size_t len, const char *file, int line)
+{
+	void *mem = mem_alloc_at(len, file, line);
 	memset(mem, 0, len);
 	return mem;
 }
 
+void *mem_zalloc(size_t len)
+{
+	return mem_zalloc_at(len, NULL, 0);
+}
+
 void mem_free(void *p)
 {
 	if (!p) return;
 
+#ifdef MEM_PROFILE
+	mem_note_free(SITE(p), SZ(p));
+#endif
+
 	if (mem_flags & MEM_POISON_FREE)
 		memset(p, 0xCD, SZ(p));
-	free((char *)p - sizeof(size_t));
+	free((char *)p - MEM_HEAD);
 }
 
-void *mem_realloc(void *p, size_t len)
+/*
+ * Resize the block at `p`.  For profiling, the block now belongs to the
+ * site which resized it.
+ */
+void *mem_realloc_at(void *p, size_t len, const char *file, int line)
 {
 	char *m = p;
 
 	/* Fail gracefully */
 	if (len == 0) return (NULL);
 
-	m = realloc(m ? m - sizeof(size_t) : NULL, len + sizeof(size_t));
-	m += sizeof(size_t);
+#ifdef MEM_PROFILE
+	if (m) mem_note_free(SITE(m), SZ(m));
+#endif
+
+	m = realloc(m ? m - MEM_HEAD : NULL, len + MEM_HEAD);
 
 	/* Handle OOM */
 	if (!m) quit("Out of Memory!");
+	m += MEM_HEAD;
 	SZ(m) = len;
 
+#ifdef MEM_PROFILE
+	SITE(m) = mem_site(file, line);
+	mem_note_alloc(SITE(m), len);
+#endif
+
 	return m;
 }
 
+void *mem_realloc(void *p, size_t len)
+{
+	return mem_realloc_at(p, len, NULL, 0);
+}
+
 /*
  * Duplicates an existing string `str`, allocating as much memory as necessary.
  */
-char *string_make(const char *str)
+char *string_make_at(const char *str, const char *file, int line)
 {
 	char *res;
 	size_t siz;
@@ -95,7 +303,7 @@ char *string_make(const char *str)
 
 	/* Allocate space for the string (including terminator) */
 	siz = strlen(str) + 1;
-	res = mem_alloc(siz);
+	res = mem_alloc_at(siz, file, line);
 
 	/* Copy the string (with terminator) */
 	my_strcpy(res, str, siz);
@@ -103,12 +311,17 @@ char *string_make(const char *str)
 	return res;
 }
 
+char *string_make(const char *str)
+{
+	return string_make_at(str, NULL, 0);
+}
+
 void string_free(char *str)
 {
 	mem_free(str);
 }
 
-char *string_append(char *s1, const char *s2)
+char *string_append_at(char *s1, const char *s2, const char *file, int line)
 {
 	u32b len;
 	if (!s1 && !s2) {
@@ -116,10 +329,131 @@ char *string_append(char *s1, const char *s2)
 	} else if (s1 && !s2) {
 		return s1;
 	} else if (!s1 && s2) {
-		return string_make(s2);
+		return string_make_at(s2, file, line);
 	}
 	len = strlen(s1);
-	s1 = mem_realloc(s1, len + strlen(s2) + 1);
+	s1 = mem_realloc_at(s1, len + strlen(s2) + 1, file, line);
 	strcpy(s1 + len, s2);
 	return s1;
 }
+
+char *string_append(char *s1, const char *s2)
+{
+	return string_append_at(s1, s2, NULL, 0);
+}
+
+
+/*** Arenas ***/
+
+struct mem_arena_block {
+	struct mem_arena_block *next;
+	size_t size;
+	size_t used;
+};
+
+struct mem_arena {
+	size_t block_size;
+	struct mem_arena_block *first;
+	struct mem_arena_block *cur;	/* NULL if nothing is allocated */
+};
+
+/* Everything handed out is aligned as well as mem_alloc() would */
+#define ARENA_ALIGN(n)	(((n) + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1))
+#define ARENA_HEAD	ARENA_ALIGN(sizeof(struct mem_arena_block))
+#define ARENA_DATA(b)	((char *)(b) + ARENA_HEAD)
+
+/*
+ * Make an arena which gets memory `block_size` bytes at a time (or more,
+ * for allocations bigger than that).
+ */
+struct mem_arena *mem_arena_new(size_t block_size)
+{
+	struct mem_arena *a = mem_zalloc(sizeof(*a));
+	a->block_size = block_size;
+	return a;
+}
+
+/*
+ * Allocate `len` zeroed bytes from `a`, which last until `a` is reset, or
+ * released to a mark taken before this allocation.
+ */
+void *mem_arena_alloc(struct mem_arena *a, size_t len)
+{
+	struct mem_arena_block *b = a->cur;
+	char *mem;
+
+	/* Allow allocation of "zero bytes" */
+	if (len == 0) return (NULL);
+
+	len = ARENA_ALIGN(len);
+
+	/* Move on to the next block, or a new one if that won't do */
+	while (!b || b->used + len > b->size) {
+		struct mem_arena_block *next = b ? b->next : a->first;
+
+		if (!next || next->size < len) {
+			size_t size = MAX(a->block_size, len);
+
+			next = mem_alloc(ARENA_HEAD + size);
+			next->size = size;
+			next->next = b ? b->next : a->first;
+			if (b)
+				b->next = next;
+			else
+				a->first = next;
+		}
+
+		next->used = 0;
+		b = next;
+	}
+
+	a->cur = b;
+	mem = ARENA_DATA(b) + b->used;
+	b->used += len;
+
+	memset(mem, 0, len);
+	return mem;
+}
+
+/*
+ * Remember how much of `a` is in use, to release back to later.
+ */
+struct mem_arena_mark mem_arena_mark(struct mem_arena *a)
+{
+	struct mem_arena_mark mark;
+
+	mark.block = a->cur;
+	mark.used = a->cur ? a->cur->used : 0;
+	return mark;
+}
+
+/*
+ * Take back everything allocated from `a` since `mark` was taken.
+ */
+void mem_arena_release(struct mem_arena *a, struct mem_arena_mark mark)
+{
+	a->cur = mark.block;
+	if (a->cur)
+		a->cur->used = mark.used;
+}
+
+/*
+ * Take back everything allocated from `a`, keeping the blocks for reuse.
+ */
+void mem_arena_reset(struct mem_arena *a)
+{
+	a->cur = NULL;
+}
+
+void mem_arena_free(struct mem_arena *a)
+{
+	struct mem_arena_block *b, *next;
+
+	if (!a) return;
+
+	for (b = a->first; b; b = next) {
+		next = b->next;
+		mem_free(b);
+	}
+	mem_free(a);
+}
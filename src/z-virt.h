@@ -21,6 +21,14 @@
 #define WIPE(P, T) \
 	(memset((P), 0, sizeof(T)))
 
+/*
+ * Wipe the lookup key at location P, before filling it in.  Keys are
+ * compared with memcmp(), which sees the padding between fields as well
+ * as the fields, so the padding must be cleared too.
+ */
+#define WIPE_KEY(P) \
+	(memset((P), 0, sizeof(*(P))))
+
 
 /* Load an array of type T[N], at location P1, from another, at location P2 */
 #define C_COPY(P1, P2, N, T) \
@@ -62,6 +70,48 @@ char *string_make(const char *str);
 void string_free(char *str);
 char *string_append(char *s1, const char *s2);
 
+/*
+ * The same, recording where they were called from.  In a MEM_PROFILE build
+ * (configure --enable-mem-profile) everything allocates through these, and
+ * mem_profile_dump() writes out how much each place in the source has
+ * allocated, and how much of it is still in use.
+ */
+void *mem_alloc_at(size_t len, const char *file, int line);
+void *mem_zalloc_at(size_t len, const char *file, int line);
+void *mem_realloc_at(void *p, size_t len, const char *file, int line);
+char *string_make_at(const char *str, const char *file, int line);
+char *string_append_at(char *s1, const char *s2, const char *file, int line);
+
+bool mem_profile_dump(const char *path);
+
+#ifdef MEM_PROFILE
+# define mem_alloc(L)		mem_alloc_at((L), __FILE__, __LINE__)
+# define mem_zalloc(L)		mem_zalloc_at((L), __FILE__, __LINE__)
+# define mem_realloc(P, L)	mem_realloc_at((P), (L), __FILE__, __LINE__)
+# define string_make(S)		string_make_at((S), __FILE__, __LINE__)
+# define string_append(S1, S2)	string_append_at((S1), (S2), __FILE__, __LINE__)
+#endif
+
+/*
+ * Arenas hand out memory by bumping a pointer through large blocks, and
+ * take it all back at once, either entirely or back to a mark.  The blocks
+ * are kept for reuse, so something which allocates the same pattern over
+ * and over (like level generation) stops going to malloc() at all.
+ */
+struct mem_arena;
+
+struct mem_arena_mark {
+	struct mem_arena_block *block;
+	size_t used;
+};
+
+struct mem_arena *mem_arena_new(size_t block_size);
+void *mem_arena_alloc(struct mem_arena *a, size_t len);
+struct mem_arena_mark mem_arena_mark(struct mem_arena *a);
+void mem_arena_release(struct mem_arena *a, struct mem_arena_mark mark);
+void mem_arena_reset(struct mem_arena *a);
+void mem_arena_free(struct mem_arena *a);
+
 enum {
 	MEM_POISON_ALLOC = 0x00000001,
 	MEM_POISON_FREE  = 0x00000002